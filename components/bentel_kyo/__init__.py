@@ -2,23 +2,70 @@
 
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
+from esphome import automation
 from esphome.components import uart
 from esphome.const import CONF_ID
+from esphome.core import CORE, ID
 
 CODEOWNERS = ["@espkyogate"]
 DEPENDENCIES = ["uart"]
-AUTO_LOAD = ["alarm_control_panel", "binary_sensor", "button", "switch", "text_sensor"]
-MULTI_CONF = False
+AUTO_LOAD = ["alarm_control_panel", "binary_sensor", "button", "sensor", "switch", "text_sensor"]
+MULTI_CONF = True
+
+DOMAIN = "bentel_kyo"
+MAX_HUBS = 4  # LOOP_BUDGET_MAX_HUBS
+DATA_LOOP_BUDGET = "bentel_kyo_loop_budget"
 
 CONF_BENTEL_KYO_ID = "bentel_kyo_id"
+CONF_RESET = "reset"
+CONF_CLEAR = "clear"
+CONF_TRACE = "trace"
+CONF_BUFFER_SIZE = "buffer_size"
+CONF_WINDOW = "window"
+CONF_FREEZE_ON_FAILURE = "freeze_on_failure"
+CONF_DUMP_ON_FAILURE = "dump_on_failure"
+CONF_RESTORE_STATE = "restore_state"
+CONF_RX_TASK = "rx_task"
+CONF_TIMELINE = "timeline"
+CONF_SIZE = "size"
 
 bentel_kyo_ns = cg.esphome_ns.namespace("bentel_kyo")
 BentelKyo = bentel_kyo_ns.class_("BentelKyo", cg.PollingComponent, uart.UARTDevice)
+KyoLoopBudget = bentel_kyo_ns.class_("KyoLoopBudget")
+DumpProfilerAction = bentel_kyo_ns.class_("DumpProfilerAction", automation.Action)
+DumpTraceAction = bentel_kyo_ns.class_("DumpTraceAction", automation.Action)
+DumpZoneStatsAction = bentel_kyo_ns.class_("DumpZoneStatsAction", automation.Action)
+DumpTimelineAction = bentel_kyo_ns.class_("DumpTimelineAction", automation.Action)
+
+# Raw frame trace: a fixed ring of the latest TX/RX frames, compiled in only
+# when this block is present
+TRACE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_BUFFER_SIZE, default=4096): cv.int_range(min=1024, max=65535),
+        cv.Optional(CONF_WINDOW, default="20s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FREEZE_ON_FAILURE, default=True): cv.boolean,
+        cv.Optional(CONF_DUMP_ON_FAILURE, default=False): cv.boolean,
+    }
+)
+
+# Zone and partition transitions, 8 bytes per entry, compiled in only when
+# this block is present
+TIMELINE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_SIZE, default=64): cv.int_range(min=16, max=1024),
+    }
+)
 
 CONFIG_SCHEMA = (
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(BentelKyo),
+            cv.Optional(CONF_RESTORE_STATE, default=True): cv.boolean,
+            # Read the UART from a FreeRTOS task on the other core
+            cv.Optional(CONF_RX_TASK): cv.All(cv.boolean, cv.only_on_esp32),
+            cv.Optional(CONF_TRACE): TRACE_SCHEMA,
+            cv.Optional(CONF_TIMELINE): TIMELINE_SCHEMA,
         }
     )
     .extend(cv.polling_component_schema("500ms"))
@@ -26,7 +73,122 @@ CONFIG_SCHEMA = (
 )
 
 
+def _final_validate(config):
+    # Hubs share the main loop budget and the compile-time trace and timeline sizes
+    hubs = fv.full_config.get().get(DOMAIN, [])
+    if len(hubs) > MAX_HUBS:
+        raise cv.Invalid(f"At most {MAX_HUBS} bentel_kyo hubs are supported")
+    sizes = {hub[CONF_TRACE][CONF_BUFFER_SIZE] for hub in hubs if CONF_TRACE in hub}
+    if len(sizes) > 1:
+        raise cv.Invalid("All bentel_kyo hubs with a trace must use the same buffer_size")
+    sizes = {hub[CONF_TIMELINE][CONF_SIZE] for hub in hubs if CONF_TIMELINE in hub}
+    if len(sizes) > 1:
+        raise cv.Invalid("All bentel_kyo hubs with a timeline must use the same size")
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     await uart.register_uart_device(var, config)
+    cg.add(var.set_instance_id(str(config[CONF_ID])))
+    cg.add(var.set_restore_state(config[CONF_RESTORE_STATE]))
+
+    # One budget for all hubs, so their blocking reads take turns with every
+    # panel's live polling
+    budget = CORE.data.get(DATA_LOOP_BUDGET)
+    if budget is None:
+        budget = cg.new_Pvariable(ID(DATA_LOOP_BUDGET, is_declaration=True, type=KyoLoopBudget))
+        CORE.data[DATA_LOOP_BUDGET] = budget
+    cg.add(var.set_loop_budget(budget))
+
+    if config.get(CONF_RX_TASK, False):
+        cg.add_define("USE_BENTEL_KYO_RX_TASK")
+        cg.add(var.set_rx_task(True))
+
+    if CONF_TRACE in config:
+        trace = config[CONF_TRACE]
+        cg.add_define("USE_BENTEL_KYO_TRACE")
+        cg.add_define("BENTEL_KYO_TRACE_BUFFER_SIZE", trace[CONF_BUFFER_SIZE])
+        cg.add(var.set_trace_window(trace[CONF_WINDOW]))
+        cg.add(var.set_trace_freeze_on_failure(trace[CONF_FREEZE_ON_FAILURE]))
+        cg.add(var.set_trace_dump_on_failure(trace[CONF_DUMP_ON_FAILURE]))
+
+    if CONF_TIMELINE in config:
+        cg.add_define("USE_BENTEL_KYO_TIMELINE")
+        cg.add_define("BENTEL_KYO_TIMELINE_SIZE", config[CONF_TIMELINE][CONF_SIZE])
+
+
+@automation.register_action(
+    "bentel_kyo.dump_profiler",
+    DumpProfilerAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(BentelKyo),
+            cv.Optional(CONF_RESET, default=False): cv.templatable(cv.boolean),
+        }
+    ),
+)
+async def dump_profiler_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, parent)
+    reset = await cg.templatable(config[CONF_RESET], args, bool)
+    cg.add(var.set_reset(reset))
+    return var
+
+
+@automation.register_action(
+    "bentel_kyo.dump_trace",
+    DumpTraceAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(BentelKyo),
+            cv.Optional(CONF_CLEAR, default=False): cv.templatable(cv.boolean),
+        }
+    ),
+)
+async def dump_trace_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, parent)
+    clear = await cg.templatable(config[CONF_CLEAR], args, bool)
+    cg.add(var.set_clear(clear))
+    return var
+
+
+@automation.register_action(
+    "bentel_kyo.dump_zone_stats",
+    DumpZoneStatsAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(BentelKyo),
+            cv.Optional(CONF_RESET, default=False): cv.templatable(cv.boolean),
+        }
+    ),
+)
+async def dump_zone_stats_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, parent)
+    reset = await cg.templatable(config[CONF_RESET], args, bool)
+    cg.add(var.set_reset(reset))
+    return var
+
+
+@automation.register_action(
+    "bentel_kyo.dump_timeline",
+    DumpTimelineAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(BentelKyo),
+            cv.Optional(CONF_CLEAR, default=False): cv.templatable(cv.boolean),
+        }
+    ),
+)
+async def dump_timeline_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, parent)
+    clear = await cg.templatable(config[CONF_CLEAR], args, bool)
+    cg.add(var.set_clear(clear))
+    return var
@@ -85,9 +85,9 @@ void BentelKyoAlarmPanel::control(const alarm_control_panel::AlarmControlPanelCa
   }
 }
 
-void BentelKyoAlarmPanel::update_state_from_hub() {
+bool BentelKyoAlarmPanel::update_state_from_hub() {
   if (this->parent_ == nullptr)
-    return;
+    return false;
 
   uint8_t idx = this->partition_ - 1;  // Convert to 0-based
 
@@ -109,12 +109,13 @@ void BentelKyoAlarmPanel::update_state_from_hub() {
     new_state = alarm_control_panel::ACP_STATE_ARMED_NIGHT;
   } else {
     // No state bits set — keep current state
-    return;
+    return false;
   }
 
-  if (new_state != this->get_state()) {
-    this->publish_state(new_state);
-  }
+  if (new_state == this->get_state())
+    return false;
+  this->publish_state(new_state);
+  return true;
 }
 
 }  // namespace bentel_kyo
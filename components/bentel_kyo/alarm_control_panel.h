@@ -31,8 +31,8 @@ class BentelKyoAlarmPanel : public alarm_control_panel::AlarmControlPanel, publi
   void add_code(const std::string &code) { this->codes_.push_back(code); }
   void set_requires_code_to_arm(bool code_to_arm) { this->requires_code_to_arm_ = code_to_arm; }
 
-  // Called by the hub after polling
-  void update_state_from_hub();
+  // Called by the hub after polling; true when a new state was published
+  bool update_state_from_hub();
 
   // AlarmControlPanel interface
   uint32_t get_supported_features() const override;
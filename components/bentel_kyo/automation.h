@@ -5,9 +5,68 @@
  *
  * GNU Affero General Public License v3.0
  *
- * Placeholder for automation Action/Trigger/Condition classes for the Bentel KYO component.
+ * Automation Action/Trigger/Condition classes for the Bentel KYO component.
  */
 
 #pragma once
 
+#include "esphome/core/automation.h"
 #include "bentel_kyo.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+// bentel_kyo.dump_profiler: log the blocking profile, optionally starting a new one
+template<typename... Ts> class DumpProfilerAction : public Action<Ts...> {
+ public:
+  explicit DumpProfilerAction(BentelKyo *parent) : parent_(parent) {}
+  TEMPLATABLE_VALUE(bool, reset)
+
+  void play(Ts... x) override {
+    this->parent_->dump_profiler();
+    if (this->reset_.value(x...))
+      this->parent_->reset_profiler();
+  }
+
+ protected:
+  BentelKyo *parent_;
+};
+
+// bentel_kyo.dump_trace: log the raw frame trace window, optionally emptying the ring
+template<typename... Ts> class DumpTraceAction : public Action<Ts...> {
+ public:
+  explicit DumpTraceAction(BentelKyo *parent) : parent_(parent) {}
+  TEMPLATABLE_VALUE(bool, clear)
+
+  void play(Ts... x) override { this->parent_->dump_trace(this->clear_.value(x...)); }
+
+ protected:
+  BentelKyo *parent_;
+};
+
+// bentel_kyo.dump_zone_stats: log the per-zone activity counters, optionally resetting them
+template<typename... Ts> class DumpZoneStatsAction : public Action<Ts...> {
+ public:
+  explicit DumpZoneStatsAction(BentelKyo *parent) : parent_(parent) {}
+  TEMPLATABLE_VALUE(bool, reset)
+
+  void play(Ts... x) override { this->parent_->dump_zone_stats(this->reset_.value(x...)); }
+
+ protected:
+  BentelKyo *parent_;
+};
+
+// bentel_kyo.dump_timeline: log the transition timeline, optionally emptying it
+template<typename... Ts> class DumpTimelineAction : public Action<Ts...> {
+ public:
+  explicit DumpTimelineAction(BentelKyo *parent) : parent_(parent) {}
+  TEMPLATABLE_VALUE(bool, clear)
+
+  void play(Ts... x) override { this->parent_->dump_timeline(this->clear_.value(x...)); }
+
+ protected:
+  BentelKyo *parent_;
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -9,6 +9,8 @@
 #include "bentel_kyo.h"
 #include "alarm_control_panel.h"
 
+#include <cmath>
+
 namespace esphome {
 namespace bentel_kyo {
 
@@ -19,34 +21,105 @@ constexpr uint8_t BentelKyo::CMD_GET_PARTITION_KYO32[];
 constexpr uint8_t BentelKyo::CMD_GET_PARTITION_KYO8[];
 constexpr uint8_t BentelKyo::CMD_GET_VERSION[];
 constexpr uint8_t BentelKyo::CMD_RESET_ALARMS[];
+constexpr uint8_t BentelKyo::CMD_PROBE[];
+
+static const char *model_name(AlarmModel model) {
+  switch (model) {
+    case AlarmModel::KYO_4: return "KYO4";
+    case AlarmModel::KYO_8: return "KYO8";
+    case AlarmModel::KYO_8G: return "KYO8G";
+    case AlarmModel::KYO_8W: return "KYO8W";
+    case AlarmModel::KYO_32: return "KYO32";
+    case AlarmModel::KYO_32G: return "KYO32G";
+    default: return "Unknown";
+  }
+}
 
 void BentelKyo::setup() {
   ESP_LOGI(TAG, "Setting up Bentel KYO hub...");
   this->communication_ok_ = false;
   this->force_publish_ = true;
+  this->metrics_window_start_ms_ = this->clock_->millis();
+  this->budget_->add_hub(this);
+  if (this->restore_state_) {
+    // One saved state per hub: the key carries the YAML id when there is one
+    std::string key = SAVED_STATE_KEY;
+    if (this->instance_id_ != nullptr)
+      key = key + "." + this->instance_id_;
+    this->state_pref_ = global_preferences->make_preference<KyoSavedState>(fnv1_hash(key), true);
+    this->load_saved_state_();
+  }
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  {
+    std::string key = ZONE_STATS_KEY;
+    if (this->instance_id_ != nullptr)
+      key = key + "." + this->instance_id_;
+    this->stats_pref_ = global_preferences->make_preference<KyoZoneCounters>(fnv1_hash(key), true);
+    KyoZoneCounters saved{};
+    if (this->stats_pref_.load(&saved))
+      this->zone_stats_.restore(saved);
+    this->stats_saved_ms_ = this->clock_->millis();
+  }
+#endif
+#ifdef USE_BENTEL_KYO_RX_TASK
+  if (this->rx_task_enabled_) {
+    this->rx_pump_.set_inner(this->transport_);
+    this->rx_pump_.set_clock(this->clock_);
+    if (this->rx_pump_.start()) {
+      this->transport_ = &this->rx_pump_;
+    } else {
+      ESP_LOGW(TAG, "RX task not started, reading the UART from loop()");
+    }
+  }
+#endif
 }
 
 void BentelKyo::dump_config() {
-  ESP_LOGCONFIG(TAG, "Bentel KYO:");
+  if (this->instance_id_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "Bentel KYO '%s':", this->instance_id_);
+  } else {
+    ESP_LOGCONFIG(TAG, "Bentel KYO:");
+  }
   if (this->model_detected_) {
-    const char *model_name;
-    switch (this->alarm_model_) {
-      case AlarmModel::KYO_4: model_name = "KYO4"; break;
-      case AlarmModel::KYO_8: model_name = "KYO8"; break;
-      case AlarmModel::KYO_8G: model_name = "KYO8G"; break;
-      case AlarmModel::KYO_8W: model_name = "KYO8W"; break;
-      case AlarmModel::KYO_32: model_name = "KYO32"; break;
-      case AlarmModel::KYO_32G: model_name = "KYO32G"; break;
-      default: model_name = "Unknown"; break;
-    }
-    ESP_LOGCONFIG(TAG, "  Model: %s", model_name);
+    ESP_LOGCONFIG(TAG, "  Model: %s%s", model_name(this->alarm_model_),
+                  this->model_restored_ ? " (restored, not yet confirmed)" : "");
     ESP_LOGCONFIG(TAG, "  Firmware: %s", this->firmware_version_);
     ESP_LOGCONFIG(TAG, "  Max Zones: %d", this->max_zones_);
   } else {
     ESP_LOGCONFIG(TAG, "  Model: not yet detected");
   }
-  ESP_LOGCONFIG(TAG, "  Alarm panels: %d", this->alarm_panels_.size());
-  ESP_LOGCONFIG(TAG, "  Binary sensors: %d", this->binary_sensors_.size());
+  ESP_LOGCONFIG(TAG, "  Restore state: %s", this->restore_state_ ? "yes" : "no");
+#ifdef USE_BENTEL_KYO_RX_TASK
+  if (this->transport_ == &this->rx_pump_) {
+    ESP_LOGCONFIG(TAG, "  RX task: running, ring high water %u/%u, %u bytes dropped",
+                  (unsigned) this->rx_pump_.get_high_water(), (unsigned) RX_RING_SIZE - 1,
+                  (unsigned) this->rx_pump_.get_overflows());
+  }
+#endif
+  ESP_LOGCONFIG(TAG, "  Alarm panels: %d", (int) this->alarm_panels_.size());
+  int filtered = 0;
+  for (auto &entry : this->binary_sensors_) {
+    if (entry.debounce_ms > 0 || entry.min_interval_ms > 0)
+      filtered++;
+  }
+  ESP_LOGCONFIG(TAG, "  Binary sensors: %d (%d with a publish filter)", (int) this->binary_sensors_.size(), filtered);
+  ESP_LOGCONFIG(TAG, "  Metric sensors: %d", (int) this->metric_sensors_.size());
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  ESP_LOGCONFIG(TAG, "  Zone stats sensors: %d, saved every %us", (int) this->zone_stat_sensors_.size(),
+                (unsigned) (ZONE_STATS_SAVE_INTERVAL_MS / 1000));
+#endif
+  if (!this->mask_sensors_.empty())
+    ESP_LOGCONFIG(TAG, "  Mask sensors: %d", (int) this->mask_sensors_.size());
+#ifdef USE_BENTEL_KYO_TIMELINE
+  ESP_LOGCONFIG(TAG, "  Transition timeline: %u entries", (unsigned) TIMELINE_SIZE);
+#endif
+#ifdef USE_BENTEL_KYO_TRACE
+  ESP_LOGCONFIG(TAG, "  Frame trace: %u bytes, %us window%s", (unsigned) TRACE_BUFFER_SIZE,
+                (unsigned) (this->trace_window_ms_ / 1000), this->trace_freeze_on_failure_ ? ", freeze on failure" : "");
+#endif
+  this->budget_->dump_config(this);
+  this->rtt_.dump_config();
+  this->profiler_.dump(true);
 }
 
 // ========================================
@@ -54,21 +127,24 @@ void BentelKyo::dump_config() {
 // ========================================
 
 void BentelKyo::send_command_async_(const uint8_t *cmd, int cmd_len, uint8_t pending_op, uint32_t timeout_ms) {
-  // Flush RX buffer
-  while (this->available() > 0)
-    this->read();
+  // Flush RX buffer (bounded, so a line that never stops sending can't stall the loop)
+  for (int n = 0; n < 255 && this->transport_->available() > 0; n++)
+    this->read_byte_();
 
   // Send command bytes (fast: ~7ms for 6 bytes at 9600 baud)
-  this->write_array(cmd, cmd_len);
+  this->write_bytes_(cmd, cmd_len);
+  this->trace_frame_(false, pending_op, cmd, cmd_len);
 
   // Set up async state
   this->serial_state_ = SerialState::WAITING_RESPONSE;
   this->serial_rx_index_ = 0;
   this->serial_cmd_len_ = cmd_len;
-  this->serial_sent_ms_ = millis();
-  this->serial_last_byte_ms_ = millis();
+  this->serial_expected_len_ = this->expected_async_len_(pending_op);
+  this->serial_sent_ms_ = this->clock_->millis();
+  this->serial_last_byte_ms_ = this->clock_->millis();
   this->serial_timeout_ms_ = timeout_ms;
   this->serial_pending_op_ = pending_op;
+  this->schedule_loop_();
 }
 
 // ========================================
@@ -76,51 +152,114 @@ void BentelKyo::send_command_async_(const uint8_t *cmd, int cmd_len, uint8_t pen
 // ========================================
 
 void BentelKyo::loop() {
-  if (!this->polling_enabled_ || this->serial_state_ != SerialState::WAITING_RESPONSE)
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_LOOP);
+  this->service_serial_();
+  this->schedule_loop_();
+}
+
+void BentelKyo::schedule_loop_() {
+  // loop() only has work while an exchange is in flight or a probe is due.
+  // Otherwise it is taken off the main loop until update() sends the next
+  // command, and the main loop goes back to its normal interval.
+  bool in_flight = this->serial_state_ == SerialState::WAITING_RESPONSE;
+  if (in_flight) {
+    this->high_freq_.start();
+  } else {
+    this->high_freq_.stop();
+  }
+  if (in_flight || (this->polling_enabled_ && this->link_state_ == LinkState::RECOVERING)) {
+    this->enable_loop();
+  } else {
+    this->disable_loop();
+  }
+}
+
+bool BentelKyo::acquire_blocking_() { return this->budget_->try_acquire(this, this->clock_->millis()); }
+
+void BentelKyo::release_blocking_() { this->budget_->release(this, this->clock_->millis()); }
+
+void BentelKyo::service_serial_() {
+  if (!this->polling_enabled_)
+    return;
+
+  // Recovery probes run from loop() so their jittered schedule isn't rounded
+  // up to the update interval
+  if (this->link_state_ == LinkState::RECOVERING && this->serial_state_ == SerialState::IDLE &&
+      (int32_t) (this->clock_->millis() - this->next_probe_ms_) >= 0)
+    this->send_probe_();
+  if (this->serial_state_ != SerialState::WAITING_RESPONSE)
     return;
 
   // Read any available bytes
-  while (this->available() > 0 && this->serial_rx_index_ < 254) {
-    this->serial_rx_buf_[this->serial_rx_index_++] = this->read();
-    this->serial_last_byte_ms_ = millis();
+  while (this->transport_->available() > 0 && this->serial_rx_index_ < 254) {
+    this->serial_rx_buf_[this->serial_rx_index_++] = this->read_byte_();
+    this->serial_last_byte_ms_ = this->rx_byte_ms_();
   }
 
-  // Check for inter-byte silence (response complete)
-  bool response_complete = (this->serial_rx_index_ > this->serial_cmd_len_ &&
-                            (millis() - this->serial_last_byte_ms_) > INTER_BYTE_SILENCE_MS);
+  // A frame of known length is complete on its last byte; inter-byte silence
+  // ends frames of unknown length and truncated ones
+  int expected = this->serial_expected_len_;
+  bool response_complete = (expected > 0 && this->serial_rx_index_ >= expected) ||
+                           (this->serial_rx_index_ > this->serial_cmd_len_ &&
+                            (this->clock_->millis() - this->serial_last_byte_ms_) > INTER_BYTE_SILENCE_MS);
 
   // Check for timeout (no response or incomplete)
-  bool timed_out = (millis() - this->serial_sent_ms_) >= this->serial_timeout_ms_;
+  bool timed_out = (this->clock_->millis() - this->serial_sent_ms_) >= this->serial_timeout_ms_;
 
   if (!response_complete && !timed_out)
     return;  // Still waiting
+  if (!response_complete)
+    this->rtt_.timed_out(RTT_CLASS_POLL);
 
   // Response ready or timed out — dispatch
   this->serial_state_ = SerialState::IDLE;
+  this->dispatch_async_response_(true);
+  if (this->serial_state_ == SerialState::IDLE) {
+    // Nothing chained: this hub's poll cycle is over
+    this->commit_status_();
+    this->budget_->poll_done(this);
+  }
+}
+
+void BentelKyo::dispatch_async_response_(bool allow_chain) {
   int count = this->serial_rx_index_;
+  this->trace_frame_(true, this->serial_pending_op_, this->serial_rx_buf_, count);
 
   if (count <= 0) {
     // No data at all — panel not responding
     ESP_LOGD(TAG, "No answer from serial port (op=%d)", this->serial_pending_op_);
-    this->handle_serial_failure_();
+    if (this->serial_pending_op_ < METRIC_OP_COUNT)
+      this->metrics_.timeouts[this->serial_pending_op_]++;
+    this->handle_serial_failure_(true);
+    return;
+  }
+
+  // A frame with the wrong length or checksum is garbage, not panel state.
+  // Any well-formed frame proves the link and full polling resumes right away.
+  if (!this->record_async_frame_(count)) {
+    ESP_LOGD(TAG, "Malformed answer from serial port (op=%d, %d bytes)", this->serial_pending_op_, count);
+    this->handle_serial_failure_(false);
     return;
   }
+  this->mark_link_up_();
 
-  // Dispatch based on pending operation
+  // Dispatch based on pending operation. Chaining is suppressed when a blocking
+  // command is waiting for the bus (see arbitrate_async_poll_()).
   bool ok = false;
   switch (this->serial_pending_op_) {
-    case 0:  // detect model
+    case METRIC_OP_VERSION:  // detect model
       ok = this->detect_alarm_model_(this->serial_rx_buf_, count);
-      if (ok) {
+      if (ok && allow_chain) {
         // Immediately poll sensor+partition status so alarm panels get real state
         // before config reads start (otherwise panels default to DISARMED for ~75s)
-        this->send_command_async_(CMD_GET_SENSOR_STATUS, sizeof(CMD_GET_SENSOR_STATUS), 1, 80);
+        this->send_command_async_(CMD_GET_SENSOR_STATUS, sizeof(CMD_GET_SENSOR_STATUS), METRIC_OP_SENSOR,
+                                  this->poll_timeout_ms_(METRIC_OP_SENSOR));
         return;  // Don't update health yet — wait for sensor+partition response
       }
       break;
-    case 1:  // sensor status
+    case METRIC_OP_SENSOR:
       ok = this->parse_sensor_status_(this->serial_rx_buf_, count);
-      if (ok) {
+      if (ok && allow_chain) {
         // Chain: immediately send partition status query
         const uint8_t *cmd;
         int cmd_len;
@@ -132,46 +271,243 @@ void BentelKyo::loop() {
         } else {
           cmd = CMD_GET_PARTITION_KYO32; cmd_len = sizeof(CMD_GET_PARTITION_KYO32);
         }
-        this->send_command_async_(cmd, cmd_len, 2, 80);
+        this->send_command_async_(cmd, cmd_len, METRIC_OP_PARTITION, this->poll_timeout_ms_(METRIC_OP_PARTITION));
         return;  // Don't update health yet — wait for partition response
       }
       break;
-    case 2:  // partition status
+    case METRIC_OP_PARTITION:
       ok = this->parse_partition_status_(this->serial_rx_buf_, count);
       break;
+    case METRIC_OP_PROBE:
+      if (memcmp(this->serial_rx_buf_, CMD_PROBE, sizeof(CMD_PROBE)) != 0) {
+        this->handle_serial_failure_(false);
+        return;
+      }
+      // Health is left to the status poll, so the link is only reported up with real state
+      if (allow_chain)
+        this->send_command_async_(CMD_GET_SENSOR_STATUS, sizeof(CMD_GET_SENSOR_STATUS), METRIC_OP_SENSOR,
+                                  this->poll_timeout_ms_(METRIC_OP_SENSOR));
+      return;
   }
 
   // Update communication health
   if (ok) {
     bool was_ok = this->communication_ok_;
     this->communication_ok_ = true;
-    this->consecutive_failures_ = 0;
-    this->backoff_until_ms_ = 0;
     if (!was_ok) {
       this->force_publish_ = true;
       ESP_LOGI(TAG, "Panel communication restored");
     }
   } else {
-    this->handle_serial_failure_();
+    this->handle_serial_failure_(false);
   }
 }
 
-void BentelKyo::handle_serial_failure_() {
-  if (this->consecutive_failures_ < 7)
+uint32_t BentelKyo::poll_timeout_ms_(uint8_t pending_op) const {
+  // Before detection the sensor frame may be either length; size for the longer.
+  // The silence that marks the end of the frame comes on top of the estimate.
+  int expected = this->expected_async_len_(pending_op);
+  return this->rtt_.timeout_ms(RTT_CLASS_POLL, expected > 0 ? expected : RESP_SENSOR_KYO32) + INTER_BYTE_SILENCE_MS;
+}
+
+int BentelKyo::expected_async_len_(uint8_t pending_op) const {
+  bool is_kyo8 = (this->alarm_model_ == AlarmModel::KYO_8 || this->alarm_model_ == AlarmModel::KYO_4 ||
+                  this->alarm_model_ == AlarmModel::KYO_8G || this->alarm_model_ == AlarmModel::KYO_8W);
+  switch (pending_op) {
+    case METRIC_OP_VERSION:
+      return RESP_VERSION;
+    case METRIC_OP_SENSOR:
+      // Before any detection the sensor response length is what infers the model
+      if (this->alarm_model_ == AlarmModel::UNKNOWN)
+        return 0;
+      return is_kyo8 ? RESP_SENSOR_KYO8 : RESP_SENSOR_KYO32;
+    case METRIC_OP_PARTITION:
+      return is_kyo8 ? RESP_PARTITION_KYO8 : RESP_PARTITION_KYO32;
+    case METRIC_OP_PROBE:
+      return RESP_PROBE;
+    default:
+      return 0;
+  }
+}
+
+uint32_t BentelKyo::estimate_async_finish_ms_(uint32_t now) const {
+  // Time until the in-flight frame has fully gone by on the wire
+  int remaining = this->serial_expected_len_ - this->serial_rx_index_;
+  if (remaining <= 0)
+    return 0;
+  uint32_t wire_ms = (remaining * BYTE_TIME_US + 999) / 1000;
+  if (this->serial_rx_index_ > this->serial_cmd_len_)
+    return wire_ms;  // panel is already answering
+
+  // Panel has not started its answer yet — allow for its turnaround gap
+  uint32_t elapsed = now - this->serial_sent_ms_;
+  uint32_t turnaround_left = elapsed < PANEL_TURNAROUND_MS ? PANEL_TURNAROUND_MS - elapsed : 0;
+  return turnaround_left + wire_ms;
+}
+
+uint32_t BentelKyo::arbitrate_async_poll_(int *drain_bytes) {
+  // Called by send_message_() while an async poll owns the bus. Poll frame
+  // lengths are known, so either let a nearly-complete poll finish (keeping its
+  // result) or preempt it and wait only for the rest of its frame to pass.
+  // Returns the bus silence window the blocking command must observe.
+  *drain_bytes = 0;
+  while (this->transport_->available() > 0 && this->serial_rx_index_ < 254) {
+    this->serial_rx_buf_[this->serial_rx_index_++] = this->read_byte_();
+    this->serial_last_byte_ms_ = this->rx_byte_ms_();
+  }
+
+  int expected = this->serial_expected_len_;
+  if (expected <= 0) {
+    ESP_LOGD(TAG, "Preempting async poll (op=%d) of unknown length", this->serial_pending_op_);
+    this->serial_state_ = SerialState::IDLE;
+    this->trace_frame_(true, this->serial_pending_op_, this->serial_rx_buf_, this->serial_rx_index_);
+    return ARBITER_UNKNOWN_SILENCE_MS;
+  }
+
+  uint32_t finish_ms = this->estimate_async_finish_ms_(this->clock_->millis());
+  if (finish_ms <= ARBITER_FINISH_BUDGET_MS) {
+    uint32_t start_ms = this->clock_->millis();
+    uint32_t wait_ms = finish_ms + INTER_BYTE_SILENCE_MS;
+    while (this->serial_rx_index_ < expected && (this->clock_->millis() - start_ms) < wait_ms) {
+      while (this->transport_->available() > 0 && this->serial_rx_index_ < 254) {
+        this->serial_rx_buf_[this->serial_rx_index_++] = this->read_byte_();
+        this->serial_last_byte_ms_ = this->rx_byte_ms_();
+      }
+      this->clock_->yield();
+    }
+
+    this->serial_state_ = SerialState::IDLE;
+    if (this->serial_rx_index_ >= expected) {
+      ESP_LOGD(TAG, "Async poll (op=%d) finished before blocking command (%ums)",
+               this->serial_pending_op_, (unsigned) (this->clock_->millis() - start_ms));
+      this->dispatch_async_response_(false);
+      return INTER_BYTE_SILENCE_MS;  // frame boundary is known, only a guard gap is needed
+    }
+    ESP_LOGD(TAG, "Async poll (op=%d) did not finish in time, dropping it", this->serial_pending_op_);
+    this->trace_frame_(true, this->serial_pending_op_, this->serial_rx_buf_, this->serial_rx_index_);
+    *drain_bytes = expected - this->serial_rx_index_;
+    return INTER_BYTE_SILENCE_MS;
+  }
+
+  ESP_LOGD(TAG, "Preempting async poll (op=%d), %ums of frame left", this->serial_pending_op_,
+           (unsigned) finish_ms);
+  this->serial_state_ = SerialState::IDLE;
+  this->trace_frame_(true, this->serial_pending_op_, this->serial_rx_buf_, this->serial_rx_index_);
+  *drain_bytes = expected - this->serial_rx_index_;
+  return finish_ms + INTER_BYTE_SILENCE_MS;
+}
+
+bool BentelKyo::record_async_frame_(int count) {
+  // Length and checksum decide whether the frame is parsed at all and feed the
+  // counters; RTT is taken from well-formed frames.
+  uint8_t op = this->serial_pending_op_;
+  if (op == METRIC_OP_BLOCKING || op >= METRIC_OP_COUNT)
+    return false;
+  int expected = this->serial_expected_len_;
+  bool length_ok = expected > 0 ? count == expected : (count == RESP_SENSOR_KYO8 || count == RESP_SENSOR_KYO32);
+  if (!length_ok) {
+    this->metrics_.length_errors[op]++;
+    return false;
+  }
+  int data_end = count - 1;
+  if (calculate_checksum_(this->serial_rx_buf_, this->serial_cmd_len_, data_end) != this->serial_rx_buf_[data_end]) {
+    this->metrics_.checksum_errors[op]++;
+    return false;
+  }
+
+  KyoMetrics &m = this->metrics_;
+  uint32_t rtt = this->serial_last_byte_ms_ - this->serial_sent_ms_;
+  this->rtt_.sample(RTT_CLASS_POLL, rtt, count);
+  m.rtt_last_ms = rtt;
+  if (m.rtt_samples == 0) {
+    m.rtt_min_ms = rtt;
+    m.rtt_max_ms = rtt;
+    m.rtt_avg_ms = rtt;
+  } else {
+    if (rtt < m.rtt_min_ms)
+      m.rtt_min_ms = rtt;
+    if (rtt > m.rtt_max_ms)
+      m.rtt_max_ms = rtt;
+    m.rtt_avg_ms += ((float) rtt - m.rtt_avg_ms) / 8.0f;
+  }
+  m.rtt_samples++;
+  return true;
+}
+
+void BentelKyo::handle_serial_failure_(bool silent) {
+  if (this->consecutive_failures_ == 0)
+    this->outage_start_ms_ = this->clock_->millis();
+  if (this->consecutive_failures_ < 255)
     this->consecutive_failures_++;
-  if (this->consecutive_failures_ >= MAX_INVALID_COUNT) {
+  uint8_t &streak = silent ? this->silent_failures_ : this->bad_failures_;
+  if (streak < 255)
+    streak++;
+
+  if (this->link_state_ == LinkState::RECOVERING) {
+    this->schedule_probe_(silent);
+  } else if (this->silent_failures_ >= MAX_INVALID_COUNT || this->bad_failures_ >= MAX_BAD_FRAME_COUNT) {
+    this->link_state_ = LinkState::RECOVERING;
     this->communication_ok_ = false;
-    uint32_t backoff_ms = (1UL << (this->consecutive_failures_ - (MAX_INVALID_COUNT - 1))) * 1000UL;
-    this->backoff_until_ms_ = millis() + backoff_ms;
-    ESP_LOGW(TAG, "Panel not responding, retrying in %lus", backoff_ms / 1000UL);
+    this->probe_backoff_ = 0;
+    ESP_LOGW(TAG, "Panel %s, probing until it answers", silent ? "not responding" : "answers are garbled");
+    this->trigger_trace_(silent ? "panel not responding" : "garbled answers");
+    this->schedule_probe_(silent);
   }
 
-  // Publish communication status
-  for (auto &entry : this->binary_sensors_) {
-    if (entry.type == BinarySensorType::COMMUNICATION) {
-      entry.sensor->publish_state(this->communication_ok_);
-    }
+  this->publish_communication_();
+}
+
+void BentelKyo::mark_link_up_() {
+  if (this->link_state_ == LinkState::RECOVERING) {
+    uint32_t outage_ms = this->clock_->millis() - this->outage_start_ms_;
+    this->metrics_.recoveries++;
+    this->metrics_.recovery_ms_total += outage_ms;
+    this->metrics_.last_recovery_ms = outage_ms;
+    this->link_state_ = LinkState::ONLINE;
+    ESP_LOGI(TAG, "Panel answering again after %ums, resuming polling", (unsigned) outage_ms);
+  }
+  this->consecutive_failures_ = 0;
+  this->silent_failures_ = 0;
+  this->bad_failures_ = 0;
+}
+
+void BentelKyo::schedule_probe_(bool silent) {
+  // Garbled answers mean the panel is there: keep probing at the fast rate.
+  // Silence backs off, but only to seconds, not the tens of seconds a fixed
+  // exponential backoff reaches.
+  uint32_t interval = RECOVERY_PROBE_MIN_MS;
+  if (silent) {
+    interval <<= this->probe_backoff_;
+    if (interval >= RECOVERY_PROBE_MAX_MS)
+      interval = RECOVERY_PROBE_MAX_MS;
+    else
+      this->probe_backoff_++;
+  }
+
+  // +/-25% jitter so retries don't stay in lockstep with whatever disturbed the bus
+  if (this->jitter_state_ == 0)
+    this->jitter_state_ = this->clock_->micros() | 1;
+  uint32_t x = this->jitter_state_;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  this->jitter_state_ = x;
+  interval = interval - interval / 4 + x % (interval / 2 + 1);
+
+  this->next_probe_ms_ = this->clock_->millis() + interval;
+  ESP_LOGD(TAG, "Next link probe in %ums", (unsigned) interval);
+  this->schedule_loop_();  // loop() sends the probe, also when the failure was seen by update()
+}
+
+void BentelKyo::send_probe_() {
+  this->metrics_.probes++;
+  // Before detection the version query doubles as the probe
+  if (!this->model_detected_) {
+    this->send_command_async_(CMD_GET_VERSION, sizeof(CMD_GET_VERSION), METRIC_OP_VERSION,
+                              this->poll_timeout_ms_(METRIC_OP_VERSION));
+    return;
   }
+  this->send_command_async_(CMD_PROBE, sizeof(CMD_PROBE), METRIC_OP_PROBE, this->poll_timeout_ms_(METRIC_OP_PROBE));
 }
 
 // ========================================
@@ -186,10 +522,14 @@ void BentelKyo::reread_config() {
 }
 
 void BentelKyo::read_event_log() {
+#ifdef USE_BENTEL_KYO_EVENT_LOG
   ESP_LOGI(TAG, "Event log dump requested — reading 28 chunks...");
   this->event_log_read_pending_ = true;
   this->event_log_chunk_index_ = 0;
   this->event_log_entries_logged_ = 0;
+#else
+  ESP_LOGW(TAG, "Event log decoder not enabled, add a read_event_log button to the configuration");
+#endif
 }
 
 void BentelKyo::set_polling_enabled(bool enabled) {
@@ -201,25 +541,50 @@ void BentelKyo::set_polling_enabled(bool enabled) {
     this->force_publish_ = true;
   } else {
     ESP_LOGW(TAG, "Polling disabled — serial communication stopped");
-    // Abort any in-progress serial transaction
+    // Abort any in-progress serial transaction, keeping what it already decoded
     this->serial_state_ = SerialState::IDLE;
+    this->commit_status_();
+  }
+  this->schedule_loop_();
+}
+
+// Config read steps that do I/O in this build; the rest have no text sensor
+static bool config_step_compiled_in(uint8_t step) {
+  switch (step) {
+#ifndef USE_BENTEL_KYO_NAMES
+    case 2: case 4: case 6: case 7: case 9:
+      return false;
+#endif
+#ifndef USE_BENTEL_KYO_ESN
+    case 3: case 8:
+      return false;
+#endif
+    default:
+      return true;
   }
 }
 
 void BentelKyo::update() {
-  // Skip if polling is disabled
-  if (!this->polling_enabled_)
-    return;
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_UPDATE);
+
+  // Publish runtime metrics once per window (also while polling is paused)
+  if (this->clock_->millis() - this->metrics_window_start_ms_ >= METRICS_PUBLISH_INTERVAL_MS)
+    this->publish_metrics_();
 
-  // Skip if still waiting for a response or in backoff
-  if (this->serial_state_ != SerialState::IDLE)
+  // Skip if polling is disabled (and don't hold up the other hubs' blocking work)
+  if (!this->polling_enabled_) {
+    this->budget_->poll_done(this);
     return;
-  if (this->backoff_until_ms_ > 0 && millis() < this->backoff_until_ms_)
+  }
+
+  // Skip if still waiting for a response or probing for the panel (loop() does that)
+  if (this->serial_state_ != SerialState::IDLE || this->link_state_ == LinkState::RECOVERING)
     return;
 
-  // If model not yet detected, send version query
-  if (!this->model_detected_) {
-    this->send_command_async_(CMD_GET_VERSION, sizeof(CMD_GET_VERSION), 0, 80);
+  // If model not yet detected (or only restored), send version query
+  if (!this->model_detected_ || this->model_restored_) {
+    this->send_command_async_(CMD_GET_VERSION, sizeof(CMD_GET_VERSION), METRIC_OP_VERSION,
+                              this->poll_timeout_ms_(METRIC_OP_VERSION));
     return;
   }
 
@@ -227,64 +592,95 @@ void BentelKyo::update() {
   // Config reads use blocking send_message_(), so they must NOT run in the same
   // cycle as async sensor/partition polling (otherwise both commands collide on the bus)
   //
-  // Steps 3 and 6 (zone ESN and keyfob ESN) read one slot per cycle to avoid
+  // Steps 3 and 8 (zone ESN and keyfob ESN) read one slot per cycle to avoid
   // blocking the main loop for 90+ seconds (0xC0xx reads take ~1.5s each).
-  if (this->config_read_step_ < 13 && this->communication_ok_) {
-    switch (this->config_read_step_) {
+  // Name and ESN steps that no text sensor publishes are compiled out and
+  // skipped here, without taking a cycle or a budget grant.
+  //
+  // Each blocking step is budgeted against the other hubs on this device; a
+  // refused step falls through to a normal poll and is retried next cycle.
+  while (this->config_read_step_ < 13 && !config_step_compiled_in(this->config_read_step_))
+    this->config_read_step_++;
+  if (this->config_read_step_ < 13 && this->communication_ok_ && this->acquire_blocking_()) {
+    uint8_t step = this->config_read_step_;
+    uint16_t slot = step == 3 ? this->esn_read_index_ : (step == 8 ? this->keyfob_read_index_ : 0);
+    ProfileScope step_profile(&this->profiler_, this->clock_, (ProfilePhase) (PROFILE_CONFIG_STEP + step), slot);
+    switch (step) {
       case 0: this->config_read_step_ = 1; break;  // skip one cycle after detection
       case 1: this->read_zone_config_(); this->config_read_step_ = 2; break;
+#ifdef USE_BENTEL_KYO_NAMES
       case 2: this->read_zone_names_(); this->config_read_step_ = 3; break;
+#endif
+#ifdef USE_BENTEL_KYO_ESN
       case 3:
         // Read one zone ESN per cycle; advance to step 4 when done
         if (this->read_zone_esn_next_())
           this->config_read_step_ = 4;
         break;
+#endif
+#ifdef USE_BENTEL_KYO_NAMES
       case 4: this->read_output_names_(); this->config_read_step_ = 5; break;
+#endif
       case 5: this->read_partition_config_(); this->config_read_step_ = 6; break;
+#ifdef USE_BENTEL_KYO_NAMES
       case 6: this->read_partition_names_(); this->config_read_step_ = 7; break;
       case 7: this->read_code_names_(); this->config_read_step_ = 8; break;
+#endif
+#ifdef USE_BENTEL_KYO_ESN
       case 8:
         // Read one keyfob ESN per cycle; advance to step 9 when done
         if (this->read_keyfob_esn_next_())
           this->config_read_step_ = 9;
         break;
+#endif
+#ifdef USE_BENTEL_KYO_NAMES
       case 9: this->read_keyfob_names_(); this->config_read_step_ = 10; break;
+#endif
       case 10: this->read_panel_mode_(); this->config_read_step_ = 11; break;
       case 11: this->read_status_flags_(); this->config_read_step_ = 12; break;
       case 12: this->publish_text_sensors_(); this->config_read_step_ = 13; break;
     }
+    this->release_blocking_();
     return;  // Skip normal polling this cycle — avoid bus collision
   }
 
+#ifdef USE_BENTEL_KYO_EVENT_LOG
   // On-demand event log dump (triggered by read_event_log button)
-  if (this->event_log_read_pending_) {
-    if (this->read_event_log_next_())
-      this->event_log_read_pending_ = false;
+  if (this->event_log_read_pending_ && this->acquire_blocking_()) {
+    {
+      ProfileScope chunk_profile(&this->profiler_, this->clock_, PROFILE_EVENT_LOG, this->event_log_chunk_index_);
+      if (this->read_event_log_next_())
+        this->event_log_read_pending_ = false;
+    }
+    this->release_blocking_();
     return;  // Skip normal polling this cycle
   }
+#endif
 
   // Re-publish text sensors periodically (every 120 polling cycles = ~60s at 500ms)
   // Text sensors are static config data but must be re-published so API clients
   // that connect after initial publish (e.g. Home Assistant reconnects) get the state.
   if (this->config_read_step_ >= 13) {
-    this->text_sensor_republish_counter_++;
-    if (this->force_publish_ || this->text_sensor_republish_counter_ >= 120) {
-      this->read_panel_mode_();
-      this->read_status_flags_();
-      this->publish_text_sensors_();
+    if (this->text_sensor_republish_counter_ < 120)
+      this->text_sensor_republish_counter_++;
+    if ((this->force_publish_ || this->text_sensor_republish_counter_ >= 120) && this->acquire_blocking_()) {
+      {
+        ProfileScope refresh_profile(&this->profiler_, this->clock_, PROFILE_STATUS_REFRESH);
+        this->read_panel_mode_();
+        this->read_status_flags_();
+        this->publish_text_sensors_();
+      }
+      this->release_blocking_();
       this->text_sensor_republish_counter_ = 0;
     }
   }
 
   // Normal polling: send sensor status query (partition query chains from loop())
-  this->send_command_async_(CMD_GET_SENSOR_STATUS, sizeof(CMD_GET_SENSOR_STATUS), 1, 80);
+  this->metrics_.polls++;
+  this->send_command_async_(CMD_GET_SENSOR_STATUS, sizeof(CMD_GET_SENSOR_STATUS), METRIC_OP_SENSOR,
+                            this->poll_timeout_ms_(METRIC_OP_SENSOR));
 
-  // Publish communication status
-  for (auto &entry : this->binary_sensors_) {
-    if (entry.type == BinarySensorType::COMMUNICATION) {
-      entry.sensor->publish_state(this->communication_ok_);
-    }
-  }
+  this->publish_communication_();
 }
 
 // ========================================
@@ -299,10 +695,52 @@ void BentelKyo::register_binary_sensor(binary_sensor::BinarySensor *sensor, Bina
   this->binary_sensors_.push_back({sensor, type, index});
 }
 
+void BentelKyo::set_publish_filter(binary_sensor::BinarySensor *sensor, uint32_t debounce_ms,
+                                    uint32_t min_interval_ms) {
+  for (auto &entry : this->binary_sensors_) {
+    if (entry.sensor != sensor)
+      continue;
+    // Alarms, tampers and the siren always publish at once
+    switch (entry.type) {
+      case BinarySensorType::ZONE_TAMPER:
+      case BinarySensorType::PARTITION_ALARM:
+      case BinarySensorType::TAMPER_ZONE:
+      case BinarySensorType::TAMPER_FALSE_KEY:
+      case BinarySensorType::TAMPER_BPI:
+      case BinarySensorType::TAMPER_SYSTEM:
+      case BinarySensorType::TAMPER_RF_JAM:
+      case BinarySensorType::TAMPER_WIRELESS:
+      case BinarySensorType::SIREN:
+      case BinarySensorType::COMMUNICATION:
+        ESP_LOGW(TAG, "Publish filter ignored on an alarm, tamper or siren sensor");
+        return;
+      default:
+        break;
+    }
+    entry.debounce_ms = debounce_ms;
+    entry.min_interval_ms = min_interval_ms;
+    return;
+  }
+}
+
+void BentelKyo::register_metric_sensor(sensor::Sensor *sensor, MetricSensorType type, uint8_t op) {
+  this->metric_sensors_.push_back({sensor, type, op});
+}
+
 void BentelKyo::register_text_sensor(text_sensor::TextSensor *sensor, TextSensorType type, uint8_t index) {
   this->text_sensors_.push_back({sensor, type, index});
 }
 
+void BentelKyo::register_mask_sensor(text_sensor::TextSensor *sensor, MaskSensorType type) {
+  this->mask_sensors_.push_back({sensor, type});
+}
+
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+void BentelKyo::register_zone_stat_sensor(sensor::Sensor *sensor, ZoneStatType type, uint8_t index) {
+  this->zone_stat_sensors_.push_back({sensor, type, index});
+}
+#endif
+
 // ========================================
 // Model detection
 // ========================================
@@ -312,6 +750,7 @@ bool BentelKyo::detect_alarm_model_(const uint8_t *rx, int count) {
     ESP_LOGW(TAG, "Version query returned %d bytes", count);
     return false;
   }
+  AlarmModel restored_model = this->model_restored_ ? this->alarm_model_ : AlarmModel::UNKNOWN;
 
   // Extract firmware string from rx[6..17] (12 chars)
   memset(this->firmware_version_, 0, sizeof(this->firmware_version_));
@@ -351,26 +790,87 @@ bool BentelKyo::detect_alarm_model_(const uint8_t *rx, int count) {
   }
 
   this->model_detected_ = true;
+  this->model_restored_ = false;
+  if (restored_model != AlarmModel::UNKNOWN && restored_model != this->alarm_model_) {
+    // Different panel: the restored frames don't describe it, publish everything live
+    ESP_LOGW(TAG, "Panel is a %s, saved state was for a %s", model_name(this->alarm_model_), model_name(restored_model));
+    this->sensor_cache_len_ = 0;
+    this->partition_cache_len_ = 0;
+    this->force_publish_ = true;
+  }
 
   // Publish text sensors
   if (this->firmware_version_sensor_ != nullptr)
     this->firmware_version_sensor_->publish_state(this->firmware_version_);
+  if (this->alarm_model_sensor_ != nullptr)
+    this->alarm_model_sensor_->publish_state(model_name(this->alarm_model_));
 
-  if (this->alarm_model_sensor_ != nullptr) {
-    const char *model_name;
-    switch (this->alarm_model_) {
-      case AlarmModel::KYO_4: model_name = "KYO4"; break;
-      case AlarmModel::KYO_8: model_name = "KYO8"; break;
-      case AlarmModel::KYO_8G: model_name = "KYO8G"; break;
-      case AlarmModel::KYO_8W: model_name = "KYO8W"; break;
-      case AlarmModel::KYO_32: model_name = "KYO32"; break;
-      case AlarmModel::KYO_32G: model_name = "KYO32G"; break;
-      default: model_name = "Unknown"; break;
-    }
-    this->alarm_model_sensor_->publish_state(model_name);
+  return true;
+}
+
+// ========================================
+// Saved state — last known model and status across reboots
+// ========================================
+
+void BentelKyo::load_saved_state_() {
+  KyoSavedState saved{};
+  if (!this->state_pref_.load(&saved) || saved.version != SAVED_STATE_VERSION)
+    return;
+  if (saved.model == (uint8_t) AlarmModel::UNKNOWN || saved.model > (uint8_t) AlarmModel::KYO_32G)
+    return;
+  AlarmModel model = (AlarmModel) saved.model;
+  bool is_kyo8 = (model == AlarmModel::KYO_8 || model == AlarmModel::KYO_4 || model == AlarmModel::KYO_8G ||
+                  model == AlarmModel::KYO_8W);
+  if (saved.sensor_len != (is_kyo8 ? RESP_SENSOR_KYO8 : RESP_SENSOR_KYO32) ||
+      saved.partition_len != (is_kyo8 ? RESP_PARTITION_KYO8 : RESP_PARTITION_KYO32)) {
+    ESP_LOGW(TAG, "Saved state does not match its model, ignoring it");
+    return;
   }
+  this->saved_state_ = saved;
 
-  return true;
+  // Treated as detected so the frames decode, until the version query confirms it
+  this->alarm_model_ = model;
+  this->max_zones_ = is_kyo8 ? KYO_MAX_ZONES_8 : KYO_MAX_ZONES;
+  memcpy(this->firmware_version_, saved.firmware, sizeof(this->firmware_version_));
+  this->firmware_version_[sizeof(this->firmware_version_) - 1] = '\0';
+  this->model_detected_ = true;
+  this->model_restored_ = true;
+
+  // Publish through the normal parsers; the first live poll reconciles. The
+  // saved frames can be hours old, so they are not a baseline for activity
+  // or the timeline.
+  this->force_publish_ = true;
+  this->restoring_ = true;
+  this->parse_sensor_status_(saved.sensor, saved.sensor_len);
+  this->parse_partition_status_(saved.partition, saved.partition_len);
+  this->restoring_ = false;
+  this->commit_status_();
+  this->force_publish_ = true;
+  if (this->firmware_version_sensor_ != nullptr)
+    this->firmware_version_sensor_->publish_state(this->firmware_version_);
+  if (this->alarm_model_sensor_ != nullptr)
+    this->alarm_model_sensor_->publish_state(model_name(model));
+  ESP_LOGI(TAG, "Restored last known state of %s '%s': armed total=0x%02X partial=0x%02X", model_name(model),
+           this->firmware_version_, saved.partition[6], saved.partition[7]);
+}
+
+void BentelKyo::save_state_() {
+  // Called on every changed status frame; only differences reach preferences,
+  // and ESPHome batches those into flash on its own write interval
+  if (!this->restore_state_ || !this->model_detected_ || this->model_restored_)
+    return;
+  KyoSavedState state{};
+  state.version = SAVED_STATE_VERSION;
+  state.model = (uint8_t) this->alarm_model_;
+  memcpy(state.firmware, this->firmware_version_, sizeof(state.firmware));
+  state.sensor_len = this->sensor_cache_len_;
+  state.partition_len = this->partition_cache_len_;
+  memcpy(state.sensor, this->sensor_cache_, sizeof(state.sensor));
+  memcpy(state.partition, this->partition_cache_, sizeof(state.partition));
+  if (state.sensor_len == 0 || state.partition_len == 0 || memcmp(&state, &this->saved_state_, sizeof(state)) == 0)
+    return;
+  if (this->state_pref_.save(&state))
+    this->saved_state_ = state;
 }
 
 // ========================================
@@ -415,8 +915,17 @@ bool BentelKyo::parse_sensor_status_(const uint8_t *rx, int count) {
   memcpy(this->sensor_cache_, rx, count);
   this->sensor_cache_len_ = count;
 
-  if (!changed)
+  this->metrics_.cache_lookups++;
+  if (!changed) {
+    this->metrics_.cache_hits++;
+#ifdef USE_BENTEL_KYO_TIMELINE
+    // A pulse waits on the next sensor frame, changed or not
+    if (this->timeline_.has_pending())
+      this->timeline_.on_sensor_frame(this->get_mask(MASK_ZONE_OPEN), this->get_mask(MASK_ZONE_TAMPER),
+                                      this->get_mask(MASK_PARTITION_ALARM), this->clock_->millis());
+#endif
     return true;
+  }
 
   // Parse zone states
   for (int i = 0; i < this->max_zones_; i++) {
@@ -427,21 +936,19 @@ bool BentelKyo::parse_sensor_status_(const uint8_t *rx, int count) {
     }
   }
 
-  // Parse zone tamper
+  // Parse zone tamper (alarm-critical bits note whether they changed)
+  bool alarm_changed = false;
   for (int i = 0; i < this->max_zones_; i++) {
-    if (is_kyo8) {
-      this->zone_tamper_[i] = (rx[7] >> i) & 1;
-    } else {
-      this->zone_tamper_[i] = this->get_zone_bit_32_(rx, 10, i);
-    }
+    bool tamper = is_kyo8 ? (rx[7] >> i) & 1 : this->get_zone_bit_32_(rx, 10, i);
+    alarm_changed |= tamper != this->zone_tamper_[i];
+    this->zone_tamper_[i] = tamper;
   }
 
   // Parse partition alarm
   for (int i = 0; i < KYO_MAX_PARTITIONS; i++) {
-    if (is_kyo8)
-      this->partition_alarm_[i] = (rx[9] >> i) & 1;
-    else
-      this->partition_alarm_[i] = (rx[15] >> i) & 1;
+    bool alarm = is_kyo8 ? (rx[9] >> i) & 1 : (rx[15] >> i) & 1;
+    alarm_changed |= alarm != this->partition_alarm_[i];
+    this->partition_alarm_[i] = alarm;
   }
 
   // Parse warnings
@@ -462,6 +969,7 @@ bool BentelKyo::parse_sensor_status_(const uint8_t *rx, int count) {
 
   // Parse tamper/sabotage flags
   uint8_t tamper_byte = is_kyo8 ? rx[10] : rx[16];
+  bool tamper_system_before = this->tamper_system_;
   if (is_kyo8) {
     this->tamper_zone_ = (tamper_byte >> 4) & 1;
     this->tamper_false_key_ = (tamper_byte >> 5) & 1;
@@ -477,8 +985,24 @@ bool BentelKyo::parse_sensor_status_(const uint8_t *rx, int count) {
     this->tamper_rf_jam_ = (tamper_byte >> 6) & 1;
     this->tamper_wireless_ = (tamper_byte >> 7) & 1;
   }
-
-  this->publish_binary_sensors_();
+  alarm_changed |= this->tamper_system_ != tamper_system_before;
+
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  if (!this->restoring_)
+    this->zone_stats_.update(this->get_mask(MASK_ZONE_OPEN), this->get_mask(MASK_ZONE_TAMPER), this->clock_->millis());
+#endif
+#ifdef USE_BENTEL_KYO_TIMELINE
+  if (!this->restoring_)
+    this->timeline_.on_sensor_frame(this->get_mask(MASK_ZONE_OPEN), this->get_mask(MASK_ZONE_TAMPER),
+                                    this->get_mask(MASK_PARTITION_ALARM), this->clock_->millis());
+#endif
+
+  this->status_dirty_ = true;
+  // Alarms and tampers don't wait for the partition half of the cycle. A
+  // forced cycle (boot, restored link) publishes everything at its end anyway.
+  if (alarm_changed && !this->force_publish_)
+    this->publish_alarm_fast_path_();
+  this->save_state_();
   return true;
 }
 
@@ -492,6 +1016,8 @@ bool BentelKyo::parse_partition_status_(const uint8_t *rx, int count) {
              expected_len, is_kyo8 ? "KYO8" : "KYO32", count);
     return false;
   }
+  if (!this->restoring_)
+    this->partition_live_ = true;
 
   // Check cache
   bool changed = this->force_publish_ || (count != this->partition_cache_len_) ||
@@ -499,8 +1025,11 @@ bool BentelKyo::parse_partition_status_(const uint8_t *rx, int count) {
   memcpy(this->partition_cache_, rx, count);
   this->partition_cache_len_ = count;
 
-  if (!changed)
+  this->metrics_.cache_lookups++;
+  if (!changed) {
+    this->metrics_.cache_hits++;
     return true;
+  }
 
   ESP_LOGD(TAG, "Partition status: total=0x%02X partial=0x%02X partial_d0=0x%02X disarmed=0x%02X rx10=0x%02X rx11=0x%02X rx12=0x%02X",
            rx[6], rx[7], rx[8], rx[9], rx[10], rx[11], rx[12]);
@@ -548,9 +1077,14 @@ bool BentelKyo::parse_partition_status_(const uint8_t *rx, int count) {
     }
   }
 
-  this->force_publish_ = false;
-  this->publish_binary_sensors_();
-  this->publish_alarm_panels_();
+#ifdef USE_BENTEL_KYO_TIMELINE
+  if (!this->restoring_)
+    this->timeline_.on_partition_frame(this->get_mask(MASK_ZONE_ALARM_MEMORY),
+                                       this->get_mask(MASK_ZONE_TAMPER_MEMORY), this->clock_->millis());
+#endif
+
+  this->status_dirty_ = true;
+  this->save_state_();
   return true;
 }
 
@@ -558,95 +1092,362 @@ bool BentelKyo::parse_partition_status_(const uint8_t *rx, int count) {
 // State publishing
 // ========================================
 
-void BentelKyo::publish_binary_sensors_() {
+void BentelKyo::commit_status_() {
+  // One publish pass per poll cycle, after both frames are decoded, so
+  // nothing sees new zone state next to old partition state. A filter still
+  // holding a change back is looked at again every cycle.
+  if (!this->status_dirty_ && !this->filter_pending_)
+    return;
+  bool all = this->force_publish_;
+  this->status_dirty_ = false;
+  this->force_publish_ = false;
+  this->publish_binary_sensors_(all);
+  this->publish_mask_sensors_(all, false);
+  this->publish_alarm_panels_();
+}
+
+bool BentelKyo::binary_sensor_state_(const RegisteredBinarySensor &entry) const {
+  bool state = false;
+  uint8_t idx = entry.index;
+
+  switch (entry.type) {
+    case BinarySensorType::ZONE:
+      if (idx < this->max_zones_) state = this->zone_state_[idx];
+      break;
+    case BinarySensorType::ZONE_TAMPER:
+      if (idx < this->max_zones_) state = this->zone_tamper_[idx];
+      break;
+    case BinarySensorType::ZONE_BYPASS:
+      if (idx < this->max_zones_) state = this->zone_bypass_[idx];
+      break;
+    case BinarySensorType::ZONE_ALARM_MEMORY:
+      if (idx < this->max_zones_) state = this->zone_alarm_memory_[idx];
+      break;
+    case BinarySensorType::ZONE_TAMPER_MEMORY:
+      if (idx < this->max_zones_) state = this->zone_tamper_memory_[idx];
+      break;
+    case BinarySensorType::PARTITION_ALARM:
+      if (idx < KYO_MAX_PARTITIONS) state = this->partition_alarm_[idx];
+      break;
+    case BinarySensorType::WARNING_MAINS_FAILURE:
+      state = this->warn_mains_failure_;
+      break;
+    case BinarySensorType::WARNING_BPI_MISSING:
+      state = this->warn_bpi_missing_;
+      break;
+    case BinarySensorType::WARNING_FUSE_FAULT:
+      state = this->warn_fuse_fault_;
+      break;
+    case BinarySensorType::WARNING_LOW_BATTERY:
+      state = this->warn_low_battery_;
+      break;
+    case BinarySensorType::WARNING_PHONE_LINE_FAULT:
+      state = this->warn_phone_line_fault_;
+      break;
+    case BinarySensorType::WARNING_DEFAULT_CODES:
+      state = this->warn_default_codes_;
+      break;
+    case BinarySensorType::WARNING_WIRELESS_FAULT:
+      state = this->warn_wireless_fault_;
+      break;
+    case BinarySensorType::TAMPER_ZONE:
+      state = this->tamper_zone_;
+      break;
+    case BinarySensorType::TAMPER_FALSE_KEY:
+      state = this->tamper_false_key_;
+      break;
+    case BinarySensorType::TAMPER_BPI:
+      state = this->tamper_bpi_;
+      break;
+    case BinarySensorType::TAMPER_SYSTEM:
+      state = this->tamper_system_;
+      break;
+    case BinarySensorType::TAMPER_RF_JAM:
+      state = this->tamper_rf_jam_;
+      break;
+    case BinarySensorType::TAMPER_WIRELESS:
+      state = this->tamper_wireless_;
+      break;
+    case BinarySensorType::SIREN:
+      state = this->siren_active_;
+      break;
+    case BinarySensorType::OUTPUT_STATE:
+      if (idx < KYO_MAX_OUTPUTS) state = this->output_state_[idx];
+      break;
+    case BinarySensorType::PANEL_PROGRAMMING_MODE:
+      state = this->panel_programming_mode_;
+      break;
+    case BinarySensorType::TROUBLE_ACTIVE:
+      state = this->trouble_active_;
+      break;
+    case BinarySensorType::COMMUNICATION:
+      // Published by publish_communication_()
+      break;
+  }
+  return state;
+}
+
+void BentelKyo::publish_binary_sensors_(bool all) {
+  // Only entities whose state differs from what they last sent, unless all
+  uint32_t now = this->clock_->millis();
+  this->filter_pending_ = false;
   for (auto &entry : this->binary_sensors_) {
-    bool state = false;
-    uint8_t idx = entry.index;
+    if (entry.type == BinarySensorType::COMMUNICATION)
+      continue;
+    bool state = this->binary_sensor_state_(entry);
+    if (!all && entry.published == (int8_t) state) {
+      if (entry.held) {
+        // Changed and changed back before the filter let it through
+        entry.held = false;
+        this->metrics_.suppressed += 2;
+      }
+      continue;
+    }
+    if (!all && entry.published >= 0 && (entry.debounce_ms > 0 || entry.min_interval_ms > 0)) {
+      if (!entry.held) {
+        entry.held = true;
+        entry.held_since_ms = now;
+      }
+      if (now - entry.held_since_ms < entry.debounce_ms || now - entry.published_ms < entry.min_interval_ms) {
+        this->filter_pending_ = true;
+        continue;
+      }
+    }
+    entry.held = false;
+    entry.published = state;
+    entry.published_ms = now;
+    entry.sensor->publish_state(state);
+    this->metrics_.publishes++;
+  }
+}
+
+void BentelKyo::publish_alarm_fast_path_() {
+  // Partition alarm, zone tamper and system tamper straight from the sensor
+  // frame; the panels see the new alarm bits against the last partition frame
+  for (auto &entry : this->binary_sensors_) {
+    if (entry.type != BinarySensorType::PARTITION_ALARM && entry.type != BinarySensorType::ZONE_TAMPER &&
+        entry.type != BinarySensorType::TAMPER_SYSTEM)
+      continue;
+    bool state = this->binary_sensor_state_(entry);
+    if (entry.published == (int8_t) state)
+      continue;
+    entry.published = state;
+    entry.sensor->publish_state(state);
+    this->metrics_.publishes++;
+  }
+  this->publish_mask_sensors_(false, true);
+  this->publish_alarm_panels_();
+}
+
+void BentelKyo::publish_communication_() {
+  for (auto &entry : this->binary_sensors_) {
+    if (entry.type != BinarySensorType::COMMUNICATION || entry.published == (int8_t) this->communication_ok_)
+      continue;
+    entry.published = this->communication_ok_;
+    entry.sensor->publish_state(this->communication_ok_);
+    this->metrics_.publishes++;
+  }
+}
+
+void BentelKyo::publish_alarm_panels_() {
+  for (auto *panel : this->alarm_panels_) {
+    if (panel->update_state_from_hub())
+      this->metrics_.publishes++;
+  }
+}
 
+static uint32_t pack_bits(const bool *bits, int count) {
+  uint32_t mask = 0;
+  for (int i = 0; i < count; i++) {
+    if (bits[i])
+      mask |= 1UL << i;
+  }
+  return mask;
+}
+
+uint32_t BentelKyo::get_mask(MaskSensorType type) const {
+  switch (type) {
+    case MASK_ZONE_OPEN:
+      return pack_bits(this->zone_state_, this->max_zones_);
+    case MASK_ZONE_TAMPER:
+      return pack_bits(this->zone_tamper_, this->max_zones_);
+    case MASK_ZONE_BYPASS:
+      return pack_bits(this->zone_bypass_, this->max_zones_);
+    case MASK_ZONE_ALARM_MEMORY:
+      return pack_bits(this->zone_alarm_memory_, this->max_zones_);
+    case MASK_ZONE_TAMPER_MEMORY:
+      return pack_bits(this->zone_tamper_memory_, this->max_zones_);
+    case MASK_PARTITION_ALARM:
+      return pack_bits(this->partition_alarm_, KYO_MAX_PARTITIONS);
+    case MASK_PARTITION_ARMED_TOTAL:
+      return pack_bits(this->partition_armed_total_, KYO_MAX_PARTITIONS);
+    case MASK_PARTITION_ARMED_PARTIAL:
+      return pack_bits(this->partition_armed_partial_, KYO_MAX_PARTITIONS);
+    case MASK_PARTITION_ARMED_PARTIAL_DELAY0:
+      return pack_bits(this->partition_armed_partial_delay0_, KYO_MAX_PARTITIONS);
+    case MASK_WARNINGS: {
+      const bool bits[] = {this->warn_mains_failure_,    this->warn_bpi_missing_,     this->warn_fuse_fault_,
+                           this->warn_low_battery_,      this->warn_phone_line_fault_, this->warn_default_codes_,
+                           this->warn_wireless_fault_};
+      return pack_bits(bits, sizeof(bits));
+    }
+    case MASK_TAMPERS: {
+      const bool bits[] = {this->tamper_zone_,   this->tamper_false_key_, this->tamper_bpi_,
+                           this->tamper_system_, this->tamper_rf_jam_,    this->tamper_wireless_};
+      return pack_bits(bits, sizeof(bits));
+    }
+  }
+  return 0;
+}
+
+void BentelKyo::publish_mask_sensors_(bool all, bool alarms_only) {
+  // Hex, fixed width; only when the mask changed, unless all
+  for (auto &entry : this->mask_sensors_) {
+    if (alarms_only && entry.type != MASK_ZONE_TAMPER && entry.type != MASK_PARTITION_ALARM &&
+        entry.type != MASK_TAMPERS)
+      continue;
+    uint32_t mask = this->get_mask(entry.type);
+    if (!all && entry.published == (int64_t) mask)
+      continue;
+    entry.published = mask;
+    char buf[9];
+    bool zones = entry.type <= MASK_ZONE_TAMPER_MEMORY;
+    snprintf(buf, sizeof(buf), zones ? "%08lX" : "%02lX", (unsigned long) mask);
+    entry.sensor->publish_state(buf);
+    this->metrics_.publishes++;
+  }
+}
+
+static uint32_t metric_op_total(const uint32_t *counters, uint8_t op) {
+  if (op < METRIC_OP_COUNT)
+    return counters[op];
+  uint32_t total = 0;
+  for (int i = 0; i < METRIC_OP_COUNT; i++)
+    total += counters[i];
+  return total;
+}
+
+void BentelKyo::publish_metrics_() {
+  // Counters are published as totals since boot; rates cover the window since
+  // the previous call (METRICS_PUBLISH_INTERVAL_MS)
+  uint32_t now = this->clock_->millis();
+  uint32_t window_ms = now - this->metrics_window_start_ms_;
+  const KyoMetrics &cur = this->metrics_;
+  const KyoMetrics &prev = this->metrics_snapshot_;
+  float per_minute = window_ms > 0 ? 60000.0f / window_ms : 0.0f;
+  uint32_t lookups = cur.cache_lookups - prev.cache_lookups;
+
+  for (auto &entry : this->metric_sensors_) {
+    float value = NAN;
     switch (entry.type) {
-      case BinarySensorType::ZONE:
-        if (idx < this->max_zones_) state = this->zone_state_[idx];
-        break;
-      case BinarySensorType::ZONE_TAMPER:
-        if (idx < this->max_zones_) state = this->zone_tamper_[idx];
+      case METRIC_POLL_RTT:
+        if (cur.rtt_samples > 0) value = cur.rtt_last_ms;
         break;
-      case BinarySensorType::ZONE_BYPASS:
-        if (idx < this->max_zones_) state = this->zone_bypass_[idx];
+      case METRIC_POLL_RTT_MIN:
+        if (cur.rtt_samples > 0) value = cur.rtt_min_ms;
         break;
-      case BinarySensorType::ZONE_ALARM_MEMORY:
-        if (idx < this->max_zones_) state = this->zone_alarm_memory_[idx];
+      case METRIC_POLL_RTT_MAX:
+        if (cur.rtt_samples > 0) value = cur.rtt_max_ms;
         break;
-      case BinarySensorType::ZONE_TAMPER_MEMORY:
-        if (idx < this->max_zones_) state = this->zone_tamper_memory_[idx];
+      case METRIC_POLL_RTT_AVG:
+        if (cur.rtt_samples > 0) value = cur.rtt_avg_ms;
         break;
-      case BinarySensorType::PARTITION_ALARM:
-        if (idx < KYO_MAX_PARTITIONS) state = this->partition_alarm_[idx];
+      case METRIC_POLLS_PER_MINUTE:
+        value = (cur.polls - prev.polls) * per_minute;
         break;
-      case BinarySensorType::WARNING_MAINS_FAILURE:
-        state = this->warn_mains_failure_;
+      case METRIC_TIMEOUTS:
+        value = metric_op_total(cur.timeouts, entry.op);
         break;
-      case BinarySensorType::WARNING_BPI_MISSING:
-        state = this->warn_bpi_missing_;
+      case METRIC_LENGTH_ERRORS:
+        value = metric_op_total(cur.length_errors, entry.op);
         break;
-      case BinarySensorType::WARNING_FUSE_FAULT:
-        state = this->warn_fuse_fault_;
+      case METRIC_CHECKSUM_ERRORS:
+        value = metric_op_total(cur.checksum_errors, entry.op);
         break;
-      case BinarySensorType::WARNING_LOW_BATTERY:
-        state = this->warn_low_battery_;
+      case METRIC_BYTES_TX:
+        value = cur.bytes_tx;
         break;
-      case BinarySensorType::WARNING_PHONE_LINE_FAULT:
-        state = this->warn_phone_line_fault_;
+      case METRIC_BYTES_RX:
+        value = cur.bytes_rx;
         break;
-      case BinarySensorType::WARNING_DEFAULT_CODES:
-        state = this->warn_default_codes_;
+      case METRIC_CACHE_HIT_RATE:
+        if (lookups > 0) value = 100.0f * (cur.cache_hits - prev.cache_hits) / lookups;
         break;
-      case BinarySensorType::WARNING_WIRELESS_FAULT:
-        state = this->warn_wireless_fault_;
+      case METRIC_PUBLISHES_PER_MINUTE:
+        value = (cur.publishes - prev.publishes) * per_minute;
         break;
-      case BinarySensorType::TAMPER_ZONE:
-        state = this->tamper_zone_;
+      case METRIC_BLOCKED_TIME:
+        if (window_ms > 0) value = 100.0f * (cur.blocked_ms - prev.blocked_ms) / window_ms;
         break;
-      case BinarySensorType::TAMPER_FALSE_KEY:
-        state = this->tamper_false_key_;
+      case METRIC_RECOVERIES:
+        value = cur.recoveries;
         break;
-      case BinarySensorType::TAMPER_BPI:
-        state = this->tamper_bpi_;
+      case METRIC_MEAN_TIME_TO_RECOVERY:
+        if (cur.recoveries > 0) value = (float) cur.recovery_ms_total / cur.recoveries;
         break;
-      case BinarySensorType::TAMPER_SYSTEM:
-        state = this->tamper_system_;
+      case METRIC_SUPPRESSED_TRANSITIONS:
+        value = cur.suppressed;
         break;
-      case BinarySensorType::TAMPER_RF_JAM:
-        state = this->tamper_rf_jam_;
-        break;
-      case BinarySensorType::TAMPER_WIRELESS:
-        state = this->tamper_wireless_;
-        break;
-      case BinarySensorType::SIREN:
-        state = this->siren_active_;
+    }
+    entry.sensor->publish_state(value);
+  }
+
+  ESP_LOGD(TAG, "Metrics: %u polls, rtt avg %.1fms, %u timeouts, %u length / %u checksum errors, %u/%u bytes tx/rx",
+           (unsigned) (cur.polls - prev.polls), cur.rtt_avg_ms, (unsigned) metric_op_total(cur.timeouts, METRIC_OP_ALL),
+           (unsigned) metric_op_total(cur.length_errors, METRIC_OP_ALL),
+           (unsigned) metric_op_total(cur.checksum_errors, METRIC_OP_ALL), (unsigned) cur.bytes_tx,
+           (unsigned) cur.bytes_rx);
+
+  this->metrics_snapshot_ = this->metrics_;
+  this->metrics_window_start_ms_ = now;
+
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  this->publish_zone_stats_();
+  if (now - this->stats_saved_ms_ >= ZONE_STATS_SAVE_INTERVAL_MS)
+    this->save_zone_stats_();
+#endif
+}
+
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+void BentelKyo::publish_zone_stats_() {
+  // With the metrics, once a minute: open time and time since the last change
+  // move on their own, so these are not published on change
+  uint32_t now = this->clock_->millis();
+  for (auto &entry : this->zone_stat_sensors_) {
+    if (entry.index >= ZONE_STATS_ZONES)
+      continue;
+    float value = NAN;
+    switch (entry.type) {
+      case ZONE_STAT_ACTIVATIONS:
+        value = this->zone_stats_.get_activations(entry.index);
         break;
-      case BinarySensorType::OUTPUT_STATE:
-        if (idx < KYO_MAX_OUTPUTS) state = this->output_state_[idx];
+      case ZONE_STAT_OPEN_TIME:
+        value = this->zone_stats_.get_open_s(entry.index, now);
         break;
-      case BinarySensorType::PANEL_PROGRAMMING_MODE:
-        state = this->panel_programming_mode_;
+      case ZONE_STAT_LAST_CHANGE: {
+        uint32_t since_ms;
+        if (this->zone_stats_.get_since_change_ms(entry.index, now, &since_ms))
+          value = since_ms / 1000;
         break;
-      case BinarySensorType::TROUBLE_ACTIVE:
-        state = this->trouble_active_;
+      }
+      case ZONE_STAT_TAMPER_EVENTS:
+        value = this->zone_stats_.get_tamper_events(entry.index);
         break;
-      case BinarySensorType::COMMUNICATION:
-        // Handled separately in update()
-        continue;
     }
-
-    entry.sensor->publish_state(state);
+    entry.sensor->publish_state(value);
   }
 }
 
-void BentelKyo::publish_alarm_panels_() {
-  for (auto *panel : this->alarm_panels_) {
-    panel->update_state_from_hub();
-  }
+void BentelKyo::save_zone_stats_() {
+  // Only when a counter moved; open stretches are folded in first so a zone
+  // left open across a reboot keeps its time
+  uint32_t now = this->clock_->millis();
+  this->stats_saved_ms_ = now;
+  this->zone_stats_.flush(now);
+  if (this->zone_stats_.take_dirty())
+    this->stats_pref_.save(&this->zone_stats_.get_counters());
 }
+#endif
 
 // ========================================
 // Commands
@@ -657,8 +1458,13 @@ void BentelKyo::arm_partition(uint8_t partition, uint8_t arm_type) {
     ESP_LOGE(TAG, "Invalid partition %d (1-%d)", partition, KYO_MAX_PARTITIONS);
     return;
   }
+  if (!this->partition_live_) {
+    ESP_LOGW(TAG, "Arm refused: partition status not read from the panel yet");
+    return;
+  }
 
   ESP_LOGI(TAG, "Arm partition %d type %d", partition, arm_type);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_ARM);
   uint8_t cmd[11] = {0x0F, 0x00, 0xF0, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0xCC, 0xFF};
 
   // Read current arming state to preserve other partitions
@@ -682,8 +1488,7 @@ void BentelKyo::arm_partition(uint8_t partition, uint8_t arm_type) {
   cmd[8] = partial_d0_mask;
   cmd[9] = calculate_crc_(cmd, 9);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::disarm_partition(uint8_t partition) {
@@ -691,8 +1496,13 @@ void BentelKyo::disarm_partition(uint8_t partition) {
     ESP_LOGE(TAG, "Invalid partition %d (1-%d)", partition, KYO_MAX_PARTITIONS);
     return;
   }
+  if (!this->partition_live_) {
+    ESP_LOGW(TAG, "Disarm refused: partition status not read from the panel yet");
+    return;
+  }
 
   ESP_LOGI(TAG, "Disarm partition %d", partition);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_DISARM);
   uint8_t cmd[11] = {0x0F, 0x00, 0xF0, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0xFF, 0xFF};
 
   // Read current arming state, clear this partition from all modes
@@ -714,12 +1524,16 @@ void BentelKyo::disarm_partition(uint8_t partition) {
   cmd[8] = partial_d0_mask;
   cmd[9] = calculate_crc_(cmd, 9);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::arm_all_partitions(uint8_t arm_type) {
+  if (!this->partition_live_) {
+    ESP_LOGW(TAG, "Arm all refused: partition status not read from the panel yet");
+    return;
+  }
   ESP_LOGI(TAG, "Arm all partitions type %d", arm_type);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_ARM_ALL);
   uint8_t cmd[11] = {0x0F, 0x00, 0xF0, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0xCC, 0xFF};
 
   // Build masks from current state
@@ -746,24 +1560,24 @@ void BentelKyo::arm_all_partitions(uint8_t arm_type) {
   cmd[8] = partial_d0_mask;
   cmd[9] = calculate_crc_(cmd, 9);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::disarm_all_partitions() {
   ESP_LOGI(TAG, "Disarm all partitions");
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_DISARM_ALL);
   // Send all-zero masks unconditionally — same as upstream specific_area=0
   uint8_t cmd[11] = {0x0F, 0x00, 0xF0, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0xFF, 0xFF};
   cmd[9] = calculate_crc_(cmd, 9);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::arm_preset(uint8_t total_mask, uint8_t partial_mask,
                            uint8_t partial_d0_mask) {
   ESP_LOGI(TAG, "Arm preset: total=0x%02X partial=0x%02X partial_d0=0x%02X",
            total_mask, partial_mask, partial_d0_mask);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_ARM_PRESET);
   uint8_t cmd[11] = {0x0F, 0x00, 0xF0, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0xCC, 0xFF};
 
   // Send preset masks directly — unconfigured partitions get 0 (disarmed)
@@ -774,14 +1588,13 @@ void BentelKyo::arm_preset(uint8_t total_mask, uint8_t partial_mask,
   cmd[8] = partial_d0_mask;
   cmd[9] = calculate_crc_(cmd, 9);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::reset_alarms() {
   ESP_LOGI(TAG, "Reset alarms");
-  uint8_t rx[255];
-  this->send_message_(CMD_RESET_ALARMS, sizeof(CMD_RESET_ALARMS), rx, 250);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_RESET_ALARMS);
+  this->send_message_(CMD_RESET_ALARMS, sizeof(CMD_RESET_ALARMS));
 }
 
 void BentelKyo::activate_output(uint8_t output_number) {
@@ -792,12 +1605,12 @@ void BentelKyo::activate_output(uint8_t output_number) {
   }
 
   ESP_LOGI(TAG, "Activate output %d", output_number);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_OUTPUT_ON);
   uint8_t cmd[9] = {0x0F, 0x06, 0xF0, 0x01, 0x00, 0x06, 0x00, 0x00, 0x00};
   cmd[6] = 1 << (output_number - 1);
   cmd[8] = cmd[6];
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::deactivate_output(uint8_t output_number) {
@@ -808,12 +1621,12 @@ void BentelKyo::deactivate_output(uint8_t output_number) {
   }
 
   ESP_LOGI(TAG, "Deactivate output %d", output_number);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_OUTPUT_OFF);
   uint8_t cmd[9] = {0x0F, 0x06, 0xF0, 0x01, 0x00, 0x06, 0x00, 0x00, 0xCC};
   cmd[7] = 1 << (output_number - 1);
   cmd[8] = cmd[7];
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::include_zone(uint8_t zone_number) {
@@ -823,6 +1636,7 @@ void BentelKyo::include_zone(uint8_t zone_number) {
   }
 
   ESP_LOGI(TAG, "Include zone %d", zone_number);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_ZONE_INCLUDE);
   uint8_t cmd[15] = {0x0F, 0x01, 0xF0, 0x07, 0x00, 0x07,
                      0x00, 0x00, 0x00, 0x00,   // exclude bytes [6-9]
                      0x00, 0x00, 0x00, 0x00,   // include bytes [10-13]
@@ -841,8 +1655,7 @@ void BentelKyo::include_zone(uint8_t zone_number) {
 
   cmd[14] = calculate_checksum_(cmd, 6, 14);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::exclude_zone(uint8_t zone_number) {
@@ -852,6 +1665,7 @@ void BentelKyo::exclude_zone(uint8_t zone_number) {
   }
 
   ESP_LOGI(TAG, "Exclude zone %d", zone_number);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_ZONE_EXCLUDE);
   uint8_t cmd[15] = {0x0F, 0x01, 0xF0, 0x07, 0x00, 0x07,
                      0x00, 0x00, 0x00, 0x00,   // exclude bytes [6-9]
                      0x00, 0x00, 0x00, 0x00,   // include bytes [10-13]
@@ -870,8 +1684,7 @@ void BentelKyo::exclude_zone(uint8_t zone_number) {
 
   cmd[14] = calculate_checksum_(cmd, 6, 14);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 250);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 void BentelKyo::update_datetime(uint8_t day, uint8_t month, uint16_t year,
@@ -883,6 +1696,7 @@ void BentelKyo::update_datetime(uint8_t day, uint8_t month, uint16_t year,
   }
 
   ESP_LOGI(TAG, "Update datetime %02d/%02d/%04d %02d:%02d:%02d", day, month, year, hours, minutes, seconds);
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_COMMAND, PROFILE_CMD_SET_DATETIME);
   uint8_t cmd[13] = {0x0F, 0x03, 0xF0, 0x05, 0x00, 0x07,
                      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
@@ -894,87 +1708,188 @@ void BentelKyo::update_datetime(uint8_t day, uint8_t month, uint16_t year,
   cmd[11] = seconds;
   cmd[12] = calculate_checksum_(cmd, 6, 12);
 
-  uint8_t rx[255];
-  this->send_message_(cmd, sizeof(cmd), rx, 300);
+  this->send_message_(cmd, sizeof(cmd));
 }
 
 // ========================================
 // Serial I/O
 // ========================================
 
-int BentelKyo::send_message_(const uint8_t *cmd, int cmd_len, uint8_t *response, uint32_t timeout_ms) {
-  // Cancel any in-flight async transaction so loop() won't steal our bytes
-  bool aborted_async = false;
+uint8_t BentelKyo::read_byte_() {
+  this->metrics_.bytes_rx++;
+  return this->transport_->read();
+}
+
+// When the last byte read arrived: stamped by the RX task when there is one,
+// otherwise now, since loop() reads bytes as soon as it runs
+uint32_t BentelKyo::rx_byte_ms_() const {
+#ifdef USE_BENTEL_KYO_RX_TASK
+  if (this->transport_ == &this->rx_pump_)
+    return this->rx_pump_.last_read_ms();
+#endif
+  return this->clock_->millis();
+}
+
+void BentelKyo::write_bytes_(const uint8_t *data, int len) {
+  this->metrics_.bytes_tx += len;
+  this->transport_->write_array(data, len);
+}
+
+void BentelKyo::trace_frame_(bool rx, uint8_t op, const uint8_t *data, int len) {
+#ifdef USE_BENTEL_KYO_TRACE
+  this->trace_.record(this->clock_->micros(), rx, op, data, len);
+#endif
+}
+
+void BentelKyo::trigger_trace_(const char *reason) {
+#ifdef USE_BENTEL_KYO_TRACE
+  if (this->trace_.is_frozen())
+    return;  // the first failure's lead-up is already kept
+  if (this->trace_freeze_on_failure_) {
+    this->trace_.set_frozen(true);
+    ESP_LOGW(TAG, "Frame trace frozen (%s): %u frames kept, dump with bentel_kyo.dump_trace", reason,
+             (unsigned) this->trace_.records());
+  }
+  if (this->trace_dump_on_failure_)
+    this->trace_.dump(this->trace_window_ms_);
+#endif
+}
+
+void BentelKyo::dump_zone_stats(bool reset) {
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  uint32_t now = this->clock_->millis();
+  this->zone_stats_.dump(now);
+  if (reset) {
+    this->zone_stats_.reset(now);
+    this->save_zone_stats_();
+    this->publish_zone_stats_();
+  }
+#else
+  ESP_LOGW(TAG, "Zone stats not enabled, add zone_stats sensors to the bentel_kyo sensor platform");
+#endif
+}
+
+void BentelKyo::dump_timeline(bool clear) {
+#ifdef USE_BENTEL_KYO_TIMELINE
+  this->timeline_.dump(this->clock_->millis());
+  if (clear)
+    this->timeline_.clear();
+#else
+  ESP_LOGW(TAG, "Transition timeline not enabled, add a timeline: block to the bentel_kyo configuration");
+#endif
+}
+
+void BentelKyo::dump_trace(bool clear) {
+#ifdef USE_BENTEL_KYO_TRACE
+  this->trace_.dump(this->trace_window_ms_);
+  if (clear)
+    this->trace_.clear();
+  this->trace_.set_frozen(false);
+#else
+  ESP_LOGW(TAG, "Frame trace not enabled, add a trace: block to the bentel_kyo configuration");
+#endif
+}
+
+KyoResponse BentelKyo::send_message_(const uint8_t *cmd, int cmd_len, RttClass cls, int expected_len) {
+  KyoResponse response;
+  uint32_t blocked_start = this->clock_->millis();
+  ProfileScope profile(&this->profiler_, this->clock_, PROFILE_SEND_MESSAGE,
+                       cmd_len >= 3 ? (uint16_t) ((cmd[2] << 8) | cmd[1]) : 0);
+
+  // Resolve any in-flight async transaction first so loop() won't steal our bytes
+  uint32_t silence_ms = 20;
+  int drain_bytes = 0;
   if (this->serial_state_ == SerialState::WAITING_RESPONSE) {
-    ESP_LOGD(TAG, "Aborting in-flight async poll for blocking command");
-    this->serial_state_ = SerialState::IDLE;
-    aborted_async = true;
-  }
-
-  // Wait for bus silence — drain any remaining panel response bytes.
-  // After aborting an async poll, the panel may still be processing the
-  // previous query (variable 10-50ms gap before it starts responding).
-  // Use a longer silence window to ensure the panel has finished.
-  uint32_t silence_ms = aborted_async ? 100 : 20;
-  uint32_t quiet_start = millis();
-  while ((millis() - quiet_start) < silence_ms) {
-    if (this->available() > 0) {
-      while (this->available() > 0)
-        this->read();
-      quiet_start = millis();  // Reset silence timer
+    silence_ms = this->arbitrate_async_poll_(&drain_bytes);
+    this->commit_status_();  // a sensor frame whose partition poll was cut short
+  }
+
+  // Wait for bus silence — drain any remaining panel response bytes. Once the
+  // rest of a preempted frame has been drained only the inter-byte gap is needed.
+  // A line that keeps babbling (noise, wrong device) must not wedge the main loop.
+  uint32_t quiet_start = this->clock_->millis();
+  uint32_t drain_start = quiet_start;
+  while ((this->clock_->millis() - quiet_start) < silence_ms) {
+    if ((this->clock_->millis() - drain_start) >= silence_ms + BUS_SILENCE_MAX_MS) {
+      ESP_LOGW(TAG, "Serial bus never went quiet, command not sent");
+      this->metrics_.blocked_ms += this->clock_->millis() - blocked_start;
+      return response;
     }
-    yield();
+    if (this->transport_->available() > 0) {
+      // At most one buffer's worth per pass so the deadline above is re-checked
+      for (int n = 0; n < 255 && this->transport_->available() > 0; n++) {
+        this->read_byte_();
+        if (drain_bytes > 0 && --drain_bytes == 0)
+          silence_ms = INTER_BYTE_SILENCE_MS;
+      }
+      quiet_start = this->clock_->millis();  // Reset silence timer
+    }
+    this->clock_->yield();
   }
 
   // Send command
-  this->write_array(cmd, cmd_len);
+  this->write_bytes_(cmd, cmd_len);
+  this->trace_frame_(false, METRIC_OP_BLOCKING, cmd, cmd_len);
 
-  // Non-blocking read with inter-byte silence detection
+  // Non-blocking read with inter-byte silence detection, straight into the
+  // frame buffer the async polls use: the poll was resolved above
+  uint8_t *rx_buf = this->serial_rx_buf_;
   int index = 0;
-  uint8_t rx_buf[255];
-  memset(response, 0, 254);
 
-  uint32_t start_ms = millis();
+  uint32_t timeout_ms = this->rtt_.timeout_ms(cls, expected_len > 0 ? expected_len : cmd_len) + INTER_BYTE_SILENCE_MS;
+  uint32_t start_ms = this->clock_->millis();
   uint32_t last_byte_ms = start_ms;
-
-  while ((millis() - start_ms) < timeout_ms) {
-    if (this->available() > 0) {
-      while (this->available() > 0 && index < 254)
-        rx_buf[index++] = this->read();
-      last_byte_ms = millis();
-    } else if (index > cmd_len && (millis() - last_byte_ms) > INTER_BYTE_SILENCE_MS) {
+  bool complete = false;
+
+  while ((this->clock_->millis() - start_ms) < timeout_ms) {
+    if (this->transport_->available() > 0) {
+      while (this->transport_->available() > 0 && index < 254)
+        rx_buf[index++] = this->read_byte_();
+      last_byte_ms = this->rx_byte_ms_();
+    } else if (index > cmd_len && (this->clock_->millis() - last_byte_ms) > INTER_BYTE_SILENCE_MS) {
       // Got data beyond echo and silence detected — response complete
+      complete = true;
       break;
     }
-    yield();
+    this->clock_->yield();
   }
+  if (!complete)
+    this->rtt_.timed_out(cls);
 
+  this->metrics_.blocked_ms += this->clock_->millis() - blocked_start;
+  this->trace_frame_(true, METRIC_OP_BLOCKING, rx_buf, index);
   if (index <= 0) {
     ESP_LOGE(TAG, "No answer from serial port");
-    return -1;
+    this->metrics_.timeouts[METRIC_OP_BLOCKING]++;
+    return response;
   }
 
+  response.frame = rx_buf;
+  response.len = index;
+  response.data = rx_buf + (index < cmd_len ? index : cmd_len);
+
   // Validate response checksum
   if (index > cmd_len + 1) {
-    int data_start = cmd_len;
     int data_end = index - 1;
-    uint8_t expected_chk = 0;
-    for (int i = data_start; i < data_end; i++)
-      expected_chk += rx_buf[i];
-
-    if (expected_chk != rx_buf[data_end])
+    uint8_t expected_chk = calculate_checksum_(rx_buf, cmd_len, data_end);
+    if (expected_chk != rx_buf[data_end]) {
       ESP_LOGW(TAG, "Response checksum mismatch: expected 0x%02X, got 0x%02X", expected_chk, rx_buf[data_end]);
+      this->metrics_.checksum_errors[METRIC_OP_BLOCKING]++;
+    } else {
+      response.data_len = data_end - cmd_len;
+      response.valid = true;
+      if (complete && (expected_len <= 0 || index == expected_len))
+        this->rtt_.sample(cls, last_byte_ms - start_ms, index);
+    }
   }
-
-  memcpy(response, rx_buf, index);
-  return index;
+  return response;
 }
 
 // ========================================
 // Configuration register reads
 // ========================================
 
-int BentelKyo::read_register_(uint16_t address, uint8_t length, uint8_t *response, uint32_t timeout_ms) {
+KyoResponse BentelKyo::read_register_(uint16_t address, uint8_t length, RttClass cls) {
   uint8_t cmd[6];
   cmd[0] = 0xF0;
   cmd[1] = address & 0xFF;           // ADDR_LO first (little-endian)
@@ -986,42 +1901,46 @@ int BentelKyo::read_register_(uint16_t address, uint8_t length, uint8_t *respons
   ESP_LOGD(TAG, "Read register 0x%04X len=%d cmd: %02X %02X %02X %02X %02X %02X",
            address, length, cmd[0], cmd[1], cmd[2], cmd[3], cmd[4], cmd[5]);
 
-  return this->send_message_(cmd, 6, response, timeout_ms);
+  // Echo + (length + 1) data bytes + checksum
+  KyoResponse response = this->send_message_(cmd, 6, cls, 6 + length + 2);
+  if (response.len > 0 && response.len != 6 + length + 2) {
+    this->metrics_.length_errors[METRIC_OP_BLOCKING]++;
+    response.valid = false;
+  }
+  return response;
 }
 
 void BentelKyo::read_zone_config_() {
-  uint8_t rx[255];
-
   // Read zones 1-16: address 0x009F, 63 bytes (returns 64 data bytes)
-  int count = this->read_register_(0x009F, 0x3F, rx, 300);
-  if (count < 6 + 64) {
-    ESP_LOGW(TAG, "Zone config read 1-16 failed: got %d bytes", count);
+  KyoResponse rx = this->read_register_(0x009F, 0x3F);
+  if (!rx.valid) {
+    ESP_LOGW(TAG, "Zone config read 1-16 failed: got %d bytes", rx.len);
     return;
   }
 
   for (int i = 0; i < 16 && i < this->max_zones_; i++) {
-    int offset = 6 + (i * 4);
-    this->zone_type_raw_[i] = rx[offset];
-    this->zone_enrolled_[i] = (rx[offset + 1] == 0x01);
-    this->zone_area_mask_[i] = rx[offset + 2];
+    int offset = i * 4;
+    this->zone_type_raw_[i] = rx.data[offset];
+    this->zone_enrolled_[i] = (rx.data[offset + 1] == 0x01);
+    this->zone_area_mask_[i] = rx.data[offset + 2];
     ESP_LOGD(TAG, "Zone %d raw: [%02X %02X %02X %02X] type=0x%02X enrolled=%d area=0x%02X",
-             i + 1, rx[offset], rx[offset + 1], rx[offset + 2], rx[offset + 3],
+             i + 1, rx.data[offset], rx.data[offset + 1], rx.data[offset + 2], rx.data[offset + 3],
              this->zone_type_raw_[i], this->zone_enrolled_[i], this->zone_area_mask_[i]);
   }
 
   // Read zones 17-32 (only for KYO32 models)
   if (this->max_zones_ > 16) {
-    count = this->read_register_(0x00DF, 0x3F, rx, 300);
-    if (count < 6 + 64) {
-      ESP_LOGW(TAG, "Zone config read 17-32 failed: got %d bytes", count);
+    rx = this->read_register_(0x00DF, 0x3F);
+    if (!rx.valid) {
+      ESP_LOGW(TAG, "Zone config read 17-32 failed: got %d bytes", rx.len);
       return;
     }
 
     for (int i = 0; i < 16; i++) {
-      int offset = 6 + (i * 4);
-      this->zone_type_raw_[16 + i] = rx[offset];
-      this->zone_enrolled_[16 + i] = (rx[offset + 1] == 0x01);
-      this->zone_area_mask_[16 + i] = rx[offset + 2];
+      int offset = i * 4;
+      this->zone_type_raw_[16 + i] = rx.data[offset];
+      this->zone_enrolled_[16 + i] = (rx.data[offset + 1] == 0x01);
+      this->zone_area_mask_[16 + i] = rx.data[offset + 2];
     }
   }
 
@@ -1031,16 +1950,16 @@ void BentelKyo::read_zone_config_() {
   }
 }
 
+#ifdef USE_BENTEL_KYO_NAMES
 void BentelKyo::read_zone_names_() {
   // Zone names at 0x2E00-0x2FFF: 16 ASCII bytes per zone, 4 zones per 64-byte read
   static const uint16_t BASE_ADDRS[] = {0x2E00, 0x2E40, 0x2E80, 0x2EC0, 0x2F00, 0x2F40, 0x2F80, 0x2FC0};
   int num_reads = (this->max_zones_ <= 8) ? 2 : 8;
 
   for (int r = 0; r < num_reads; r++) {
-    uint8_t rx[255];
-    int count = this->read_register_(BASE_ADDRS[r], 0x3F, rx, 300);
-    if (count < 6 + 64) {
-      ESP_LOGW(TAG, "Zone names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], count);
+    KyoResponse rx = this->read_register_(BASE_ADDRS[r], 0x3F);
+    if (!rx.valid) {
+      ESP_LOGW(TAG, "Zone names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], rx.len);
       break;
     }
 
@@ -1049,9 +1968,9 @@ void BentelKyo::read_zone_names_() {
       if (zone_idx >= this->max_zones_)
         break;
 
-      int offset = 6 + (n * 16);
+      int offset = n * 16;
       char name_buf[17];
-      memcpy(name_buf, &rx[offset], 16);
+      memcpy(name_buf, &rx.data[offset], 16);
       name_buf[16] = '\0';
 
       // Trim trailing spaces
@@ -1067,7 +1986,9 @@ void BentelKyo::read_zone_names_() {
     }
   }
 }
+#endif
 
+#ifdef USE_BENTEL_KYO_ESN
 bool BentelKyo::read_zone_esn_next_() {
   // Zone ESN at 0xC045: 3 bytes per zone, per-zone reads with stride 3
   // Reads ONE zone per call (one per update cycle) to avoid blocking the main loop.
@@ -1084,11 +2005,10 @@ bool BentelKyo::read_zone_esn_next_() {
     return true;
   }
 
-  uint8_t rx[255];
   uint16_t addr = 0xC045 + (i * 3);
-  int count = this->read_register_(addr, 0x02, rx, 1500);
-  if (count < 6 + 3) {
-    ESP_LOGW(TAG, "Zone %d ESN read failed at 0x%04X (%d bytes)", i + 1, addr, count);
+  KyoResponse rx = this->read_register_(addr, 0x02, RTT_CLASS_EEPROM);
+  if (!rx.valid) {
+    ESP_LOGW(TAG, "Zone %d ESN read failed at 0x%04X (%d bytes)", i + 1, addr, rx.len);
     if (i == 0) {
       ESP_LOGW(TAG, "Zone ESN register 0xC045 not available on this panel");
       // Skip all zone ESN reads
@@ -1099,29 +2019,30 @@ bool BentelKyo::read_zone_esn_next_() {
     return false;
   }
 
-  bool is_empty = (rx[6] == 0x00 && rx[7] == 0x00 && rx[8] == 0x00);
+  bool is_empty = (rx.data[0] == 0x00 && rx.data[1] == 0x00 && rx.data[2] == 0x00);
   if (is_empty) {
     this->zone_esn_[i] = "Not enrolled";
   } else {
     char sn_buf[12];
-    snprintf(sn_buf, sizeof(sn_buf), "%02X%02X%02X", rx[6], rx[7], rx[8]);
+    snprintf(sn_buf, sizeof(sn_buf), "%02X%02X%02X", rx.data[0], rx.data[1], rx.data[2]);
     this->zone_esn_[i] = sn_buf;
   }
 
   this->esn_read_index_++;
   return false;
 }
+#endif
 
+#ifdef USE_BENTEL_KYO_NAMES
 void BentelKyo::read_output_names_() {
   // Output names at 0x3280-0x337F: 16 ASCII bytes per output, 4 per 64-byte read, 16 outputs total
   static const uint16_t BASE_ADDRS[] = {0x3280, 0x32C0, 0x3300, 0x3340};
   int num_reads = 4;  // 16 outputs = 4 reads of 4
 
   for (int r = 0; r < num_reads; r++) {
-    uint8_t rx[255];
-    int count = this->read_register_(BASE_ADDRS[r], 0x3F, rx, 300);
-    if (count < 6 + 64) {
-      ESP_LOGW(TAG, "Output names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], count);
+    KyoResponse rx = this->read_register_(BASE_ADDRS[r], 0x3F);
+    if (!rx.valid) {
+      ESP_LOGW(TAG, "Output names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], rx.len);
       break;
     }
 
@@ -1130,9 +2051,9 @@ void BentelKyo::read_output_names_() {
       if (out_idx >= KYO_MAX_OUTPUTS)
         break;
 
-      int offset = 6 + (n * 16);
+      int offset = n * 16;
       char name_buf[17];
-      memcpy(name_buf, &rx[offset], 16);
+      memcpy(name_buf, &rx.data[offset], 16);
       name_buf[16] = '\0';
 
       // Trim trailing spaces
@@ -1148,22 +2069,22 @@ void BentelKyo::read_output_names_() {
     }
   }
 }
+#endif
 
 void BentelKyo::read_partition_config_() {
   // Timers at 0x016F: 26 bytes total (section 10.5)
   // Bytes 0-15: entry/exit timers (2 bytes per partition: entry, exit) for 8 partitions
   // Bytes 16-23: siren duration (1 byte per partition)
-  uint8_t rx[255];
-  int count = this->read_register_(0x016F, 0x1A, rx, 300);
-  if (count < 6 + 26) {
-    ESP_LOGW(TAG, "Timer register read failed: got %d bytes", count);
+  KyoResponse rx = this->read_register_(0x016F, 0x1A);
+  if (!rx.valid) {
+    ESP_LOGW(TAG, "Timer register read failed: got %d bytes", rx.len);
     return;
   }
 
   for (int i = 0; i < KYO_MAX_PARTITIONS; i++) {
-    this->partition_entry_delay_[i] = rx[6 + (i * 2)];      // entry delay
-    this->partition_exit_delay_[i] = rx[6 + (i * 2) + 1];   // exit delay
-    this->partition_siren_timer_[i] = rx[6 + 16 + i];        // siren duration
+    this->partition_entry_delay_[i] = rx.data[i * 2];      // entry delay
+    this->partition_exit_delay_[i] = rx.data[i * 2 + 1];   // exit delay
+    this->partition_siren_timer_[i] = rx.data[16 + i];     // siren duration
 
     if (this->partition_entry_delay_[i] != 0 || this->partition_exit_delay_[i] != 0)
       ESP_LOGD(TAG, "Partition %d: entry=%ds, exit=%ds, siren=%d", i + 1,
@@ -1172,6 +2093,7 @@ void BentelKyo::read_partition_config_() {
   }
 }
 
+#ifdef USE_BENTEL_KYO_ESN
 bool BentelKyo::read_keyfob_esn_next_() {
   // Keyfob ESN at 0xC0B1: 3 bytes per keyfob, 16 slots
   // Reads ONE keyfob per call (one per update cycle) to avoid blocking the main loop.
@@ -1183,10 +2105,9 @@ bool BentelKyo::read_keyfob_esn_next_() {
     return true;
   }
 
-  uint8_t rx[255];
   uint16_t addr = 0xC0B1 + (i * 3);
-  int count = this->read_register_(addr, 0x02, rx, 1500);
-  if (count < 6 + 3) {
+  KyoResponse rx = this->read_register_(addr, 0x02, RTT_CLASS_EEPROM);
+  if (!rx.valid) {
     if (i == 0) {
       ESP_LOGW(TAG, "Keyfob ESN register 0xC0B1 not available on this panel");
       this->keyfob_read_index_ = 0;
@@ -1196,12 +2117,12 @@ bool BentelKyo::read_keyfob_esn_next_() {
     return false;
   }
 
-  bool is_empty = (rx[6] == 0x00 && rx[7] == 0x00 && rx[8] == 0x00);
+  bool is_empty = (rx.data[0] == 0x00 && rx.data[1] == 0x00 && rx.data[2] == 0x00);
   if (is_empty) {
     this->keyfob_esn_[i] = "Not enrolled";
   } else {
     char sn_buf[12];
-    snprintf(sn_buf, sizeof(sn_buf), "%02X%02X%02X", rx[6], rx[7], rx[8]);
+    snprintf(sn_buf, sizeof(sn_buf), "%02X%02X%02X", rx.data[0], rx.data[1], rx.data[2]);
     this->keyfob_esn_[i] = sn_buf;
     ESP_LOGD(TAG, "Keyfob %d serial: %s", i + 1, sn_buf);
   }
@@ -1209,17 +2130,18 @@ bool BentelKyo::read_keyfob_esn_next_() {
   this->keyfob_read_index_++;
   return false;
 }
+#endif
 
+#ifdef USE_BENTEL_KYO_NAMES
 void BentelKyo::read_keyfob_names_() {
   // Keyfob names at 0x3180-0x31FF: 16 ASCII bytes per keyfob, 4 per 64-byte read, 16 keyfobs total
   static const uint16_t BASE_ADDRS[] = {0x3180, 0x31C0, 0x3200, 0x3240};
   int num_reads = 4;  // 16 keyfobs = 4 reads of 4
 
   for (int r = 0; r < num_reads; r++) {
-    uint8_t rx[255];
-    int count = this->read_register_(BASE_ADDRS[r], 0x3F, rx, 300);
-    if (count < 6 + 64) {
-      ESP_LOGW(TAG, "Keyfob names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], count);
+    KyoResponse rx = this->read_register_(BASE_ADDRS[r], 0x3F);
+    if (!rx.valid) {
+      ESP_LOGW(TAG, "Keyfob names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], rx.len);
       break;
     }
 
@@ -1228,9 +2150,9 @@ void BentelKyo::read_keyfob_names_() {
       if (kf_idx >= KYO_MAX_KEYFOBS)
         break;
 
-      int offset = 6 + (n * 16);
+      int offset = n * 16;
       char name_buf[17];
-      memcpy(name_buf, &rx[offset], 16);
+      memcpy(name_buf, &rx.data[offset], 16);
       name_buf[16] = '\0';
 
       // Trim trailing spaces
@@ -1253,10 +2175,9 @@ void BentelKyo::read_partition_names_() {
   int num_reads = 2;  // 8 partitions = 2 reads of 4
 
   for (int r = 0; r < num_reads; r++) {
-    uint8_t rx[255];
-    int count = this->read_register_(BASE_ADDRS[r], 0x3F, rx, 300);
-    if (count < 6 + 64) {
-      ESP_LOGW(TAG, "Partition names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], count);
+    KyoResponse rx = this->read_register_(BASE_ADDRS[r], 0x3F);
+    if (!rx.valid) {
+      ESP_LOGW(TAG, "Partition names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], rx.len);
       break;
     }
 
@@ -1265,9 +2186,9 @@ void BentelKyo::read_partition_names_() {
       if (part_idx >= KYO_MAX_PARTITIONS)
         break;
 
-      int offset = 6 + (n * 16);
+      int offset = n * 16;
       char name_buf[17];
-      memcpy(name_buf, &rx[offset], 16);
+      memcpy(name_buf, &rx.data[offset], 16);
       name_buf[16] = '\0';
 
       // Trim trailing spaces
@@ -1290,10 +2211,9 @@ void BentelKyo::read_code_names_() {
   int num_reads = 6;  // 24 codes = 6 reads of 4
 
   for (int r = 0; r < num_reads; r++) {
-    uint8_t rx[255];
-    int count = this->read_register_(BASE_ADDRS[r], 0x3F, rx, 300);
-    if (count < 6 + 64) {
-      ESP_LOGW(TAG, "Code names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], count);
+    KyoResponse rx = this->read_register_(BASE_ADDRS[r], 0x3F);
+    if (!rx.valid) {
+      ESP_LOGW(TAG, "Code names read at 0x%04X failed: got %d bytes", BASE_ADDRS[r], rx.len);
       break;
     }
 
@@ -1302,9 +2222,9 @@ void BentelKyo::read_code_names_() {
       if (code_idx >= KYO_MAX_CODES)
         break;
 
-      int offset = 6 + (n * 16);
+      int offset = n * 16;
       char name_buf[17];
-      memcpy(name_buf, &rx[offset], 16);
+      memcpy(name_buf, &rx.data[offset], 16);
       name_buf[16] = '\0';
 
       // Trim trailing spaces
@@ -1320,50 +2240,52 @@ void BentelKyo::read_code_names_() {
     }
   }
 }
+#endif
 
 void BentelKyo::read_panel_mode_() {
-  uint8_t rx[255];
-  int count = this->read_register_(0x01E6, 0x02, rx, 300);
-  if (count < 6 + 2) {
-    ESP_LOGW(TAG, "Panel mode read failed: got %d bytes", count);
+  KyoResponse rx = this->read_register_(0x01E6, 0x02);
+  if (!rx.valid) {
+    ESP_LOGW(TAG, "Panel mode read failed: got %d bytes", rx.len);
     return;
   }
 
-  this->panel_mode_raw_[0] = rx[6];
-  this->panel_mode_raw_[1] = rx[7];
+  this->panel_mode_raw_[0] = rx.data[0];
+  this->panel_mode_raw_[1] = rx.data[1];
 
   // Programming mode = bytes differ from idle baseline {0x11, 0x10}
-  this->panel_programming_mode_ = (rx[6] != 0x11 || rx[7] != 0x10);
+  this->panel_programming_mode_ = (rx.data[0] != 0x11 || rx.data[1] != 0x10);
+  this->status_dirty_ = true;  // published with the next poll cycle
 
   ESP_LOGD(TAG, "Panel mode: %02X %02X (programming=%s)",
-           rx[6], rx[7], this->panel_programming_mode_ ? "YES" : "no");
+           rx.data[0], rx.data[1], this->panel_programming_mode_ ? "YES" : "no");
 }
 
 void BentelKyo::read_status_flags_() {
-  uint8_t rx[255];
-  int count = this->read_register_(0x1503, 0x05, rx, 300);
-  if (count < 6 + 5) {
-    ESP_LOGW(TAG, "Status flags read failed: got %d bytes", count);
+  KyoResponse rx = this->read_register_(0x1503, 0x05);
+  if (!rx.valid) {
+    ESP_LOGW(TAG, "Status flags read failed: got %d bytes", rx.len);
     return;
   }
 
   for (int i = 0; i < 5; i++)
-    this->status_flags_raw_[i] = rx[6 + i];
+    this->status_flags_raw_[i] = rx.data[i];
 
   // Trouble active = any byte != 0xFF (all-FF = no troubles)
   this->trouble_active_ = false;
   for (int i = 0; i < 5; i++) {
-    if (rx[6 + i] != 0xFF) {
+    if (rx.data[i] != 0xFF) {
       this->trouble_active_ = true;
       break;
     }
   }
+  this->status_dirty_ = true;
 
   ESP_LOGD(TAG, "Status flags: %02X %02X %02X %02X %02X (trouble=%s)",
-           rx[6], rx[7], rx[8], rx[9], rx[10],
+           rx.data[0], rx.data[1], rx.data[2], rx.data[3], rx.data[4],
            this->trouble_active_ ? "YES" : "no");
 }
 
+#ifdef USE_BENTEL_KYO_EVENT_LOG
 const char *BentelKyo::decode_event_code_(uint16_t code, uint8_t *entity_out, char *buf, size_t buf_len) {
   // Event code table from BIS KYO Unit PDF + KyoUnit 5.5 serial capture correlation.
   //
@@ -1466,7 +2388,6 @@ const char *BentelKyo::decode_event_code_(uint16_t code, uint8_t *entity_out, ch
 bool BentelKyo::read_event_log_next_() {
   static const int EVENT_LOG_CHUNKS = 28;
   static const uint16_t EVENT_LOG_BASE = 0x0D27;
-  static const int RECORDS_PER_CHUNK = 9;  // 63 bytes / 7 bytes per record
 
   int chunk = this->event_log_chunk_index_;
   if (chunk >= EVENT_LOG_CHUNKS) {
@@ -1477,17 +2398,27 @@ bool BentelKyo::read_event_log_next_() {
   uint16_t addr = EVENT_LOG_BASE + (chunk * 0x40);
   ESP_LOGD(TAG, "Event log chunk %d/28 (0x%04X)", chunk + 1, addr);
 
-  uint8_t rx[255];
-  int count = this->read_register_(addr, 0x3F, rx, 500);
-  if (count < 6 + 63) {
-    ESP_LOGW(TAG, "Event log chunk %d read failed at 0x%04X: got %d bytes", chunk + 1, addr, count);
+  KyoResponse rx = this->read_register_(addr, 0x3F, RTT_CLASS_EVENT_LOG);
+  if (!rx.valid) {
+    ESP_LOGW(TAG, "Event log chunk %d read failed at 0x%04X: got %d bytes", chunk + 1, addr, rx.len);
     this->event_log_chunk_index_++;
     return false;
   }
 
+  this->event_log_entries_logged_ += this->decode_event_log_chunk_(rx.frame, rx.len, chunk);
+  this->event_log_chunk_index_++;
+  return false;
+}
+
+int BentelKyo::decode_event_log_chunk_(const uint8_t *rx, int count, int chunk) {
+  static const int RECORDS_PER_CHUNK = 9;  // 63 bytes / 7 bytes per record
+
+  int logged = 0;
   for (int i = 0; i < RECORDS_PER_CHUNK; i++) {
     int slot = chunk * RECORDS_PER_CHUNK + i;
     int offset = 6 + (i * 7);
+    if (offset + 7 > count)
+      break;
 
     uint8_t code_hi = rx[offset];
     uint8_t code_lo = rx[offset + 1];
@@ -1513,12 +2444,11 @@ bool BentelKyo::read_event_log_next_() {
       ESP_LOGI(TAG, "Event [%03d]: %02d-%02d-%04d %02d:%02d  %s",
                slot + 1, day, month, 2000 + year, hour, minute, event_name);
     }
-    this->event_log_entries_logged_++;
+    logged++;
   }
-
-  this->event_log_chunk_index_++;
-  return false;
+  return logged;
 }
+#endif
 
 void BentelKyo::publish_text_sensors_() {
   for (auto &entry : this->text_sensors_) {
@@ -1538,10 +2468,6 @@ void BentelKyo::publish_text_sensors_() {
         entry.sensor->publish_state(type_str);
         break;
       }
-      case TEXT_ZONE_NAME:
-        if (idx >= (uint8_t) this->max_zones_) continue;
-        entry.sensor->publish_state(this->zone_name_[idx]);
-        break;
       case TEXT_ZONE_AREA: {
         if (idx >= (uint8_t) this->max_zones_) continue;
         std::string partitions;
@@ -1557,22 +2483,6 @@ void BentelKyo::publish_text_sensors_() {
         entry.sensor->publish_state(partitions);
         break;
       }
-      case TEXT_ZONE_ESN:
-        if (idx >= (uint8_t) this->max_zones_) continue;
-        entry.sensor->publish_state(this->zone_esn_[idx].empty() ? "N/A" : this->zone_esn_[idx]);
-        break;
-      case TEXT_OUTPUT_NAME:
-        if (idx >= KYO_MAX_OUTPUTS) continue;
-        entry.sensor->publish_state(this->output_name_[idx]);
-        break;
-      case TEXT_KEYFOB_ESN:
-        if (idx >= KYO_MAX_KEYFOBS) continue;
-        entry.sensor->publish_state(this->keyfob_esn_[idx].empty() ? "N/A" : this->keyfob_esn_[idx]);
-        break;
-      case TEXT_KEYFOB_NAME:
-        if (idx >= KYO_MAX_KEYFOBS) continue;
-        entry.sensor->publish_state(this->keyfob_name_[idx].empty() ? "N/A" : this->keyfob_name_[idx]);
-        break;
       case TEXT_PARTITION_ENTRY_DELAY:
         if (idx >= KYO_MAX_PARTITIONS) continue;
         entry.sensor->publish_state(to_string(this->partition_entry_delay_[idx]) + "s");
@@ -1585,14 +2495,6 @@ void BentelKyo::publish_text_sensors_() {
         if (idx >= KYO_MAX_PARTITIONS) continue;
         entry.sensor->publish_state(to_string(this->partition_siren_timer_[idx]));
         break;
-      case TEXT_PARTITION_NAME:
-        if (idx >= KYO_MAX_PARTITIONS) continue;
-        entry.sensor->publish_state(this->partition_name_[idx].empty() ? "N/A" : this->partition_name_[idx]);
-        break;
-      case TEXT_CODE_NAME:
-        if (idx >= KYO_MAX_CODES) continue;
-        entry.sensor->publish_state(this->code_name_[idx].empty() ? "N/A" : this->code_name_[idx]);
-        break;
       case TEXT_PANEL_MODE_RAW: {
         char buf[8];
         snprintf(buf, sizeof(buf), "%02X %02X", this->panel_mode_raw_[0], this->panel_mode_raw_[1]);
@@ -1608,7 +2510,42 @@ void BentelKyo::publish_text_sensors_() {
         entry.sensor->publish_state(buf);
         break;
       }
+#ifdef USE_BENTEL_KYO_NAMES
+      case TEXT_ZONE_NAME:
+        if (idx >= (uint8_t) this->max_zones_) continue;
+        entry.sensor->publish_state(this->zone_name_[idx]);
+        break;
+      case TEXT_OUTPUT_NAME:
+        if (idx >= KYO_MAX_OUTPUTS) continue;
+        entry.sensor->publish_state(this->output_name_[idx]);
+        break;
+      case TEXT_KEYFOB_NAME:
+        if (idx >= KYO_MAX_KEYFOBS) continue;
+        entry.sensor->publish_state(this->keyfob_name_[idx].empty() ? "N/A" : this->keyfob_name_[idx]);
+        break;
+      case TEXT_PARTITION_NAME:
+        if (idx >= KYO_MAX_PARTITIONS) continue;
+        entry.sensor->publish_state(this->partition_name_[idx].empty() ? "N/A" : this->partition_name_[idx]);
+        break;
+      case TEXT_CODE_NAME:
+        if (idx >= KYO_MAX_CODES) continue;
+        entry.sensor->publish_state(this->code_name_[idx].empty() ? "N/A" : this->code_name_[idx]);
+        break;
+#endif
+#ifdef USE_BENTEL_KYO_ESN
+      case TEXT_ZONE_ESN:
+        if (idx >= (uint8_t) this->max_zones_) continue;
+        entry.sensor->publish_state(this->zone_esn_[idx].empty() ? "N/A" : this->zone_esn_[idx]);
+        break;
+      case TEXT_KEYFOB_ESN:
+        if (idx >= KYO_MAX_KEYFOBS) continue;
+        entry.sensor->publish_state(this->keyfob_esn_[idx].empty() ? "N/A" : this->keyfob_esn_[idx]);
+        break;
+#endif
+      default:
+        continue;  // compiled out: codegen only registers sensors it enabled
     }
+    this->metrics_.publishes++;
   }
 }
 
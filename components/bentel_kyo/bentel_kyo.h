@@ -10,10 +10,21 @@
 
 #include "esphome/core/component.h"
 #include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #include "esphome/components/text_sensor/text_sensor.h"
+#include "esphome/components/sensor/sensor.h"
 #include "esphome/components/alarm_control_panel/alarm_control_panel.h"
+#include "clock.h"
+#include "loop_budget.h"
+#include "profiler.h"
+#include "rtt.h"
+#include "rx_task.h"
+#include "timeline.h"
+#include "trace.h"
+#include "transport.h"
+#include "zone_stats.h"
 
 #include <vector>
 #include <string>
@@ -37,12 +48,28 @@ static const int RESP_SENSOR_KYO8 = 12;
 static const int RESP_PARTITION_KYO32 = 26;
 static const int RESP_PARTITION_KYO8 = 17;
 static const int RESP_VERSION = 19;
+static const int RESP_PROBE = 8;  // echo + 1 data byte + checksum
 
-// Communication health
+// Communication health: the link is declared down after this many polls in a
+// row got no answer, or got a garbled one (the panel is there, the line is noisy)
 static const int MAX_INVALID_COUNT = 3;
-static const uint32_t SERIAL_TIMEOUT_MS = 250;
+static const int MAX_BAD_FRAME_COUNT = 6;
+// While down, a one-byte register read probes the panel with jittered retries:
+// at the minimum interval after garbled answers, doubling up to the maximum
+// while the panel stays silent
+static const uint32_t RECOVERY_PROBE_MIN_MS = 250;
+static const uint32_t RECOVERY_PROBE_MAX_MS = 4000;
 static const uint32_t INTER_BYTE_SILENCE_MS = 10;
 
+// Bus arbitration (blocking command vs in-flight async poll)
+static const uint32_t PANEL_TURNAROUND_MS = 50;         // worst observed gap before the panel answers
+static const uint32_t ARBITER_FINISH_BUDGET_MS = 40;    // let a poll finish if it completes within this
+static const uint32_t ARBITER_UNKNOWN_SILENCE_MS = 100;  // preempt window when the frame length is unknown
+static const uint32_t BUS_SILENCE_MAX_MS = 500;          // give up on a bus that never goes quiet
+
+// Runtime metrics
+static const uint32_t METRICS_PUBLISH_INTERVAL_MS = 60000;  // rate window and sensor publish period
+
 enum class AlarmModel : uint8_t {
   UNKNOWN = 0,
   KYO_4,
@@ -97,12 +124,113 @@ enum TextSensorType : uint8_t {
   TEXT_STATUS_FLAGS_RAW,
 };
 
+// Packed state for large sites: one entity per mask instead of one per bit.
+// Bit 0 is zone/partition 1; warnings and tampers follow the binary sensor order.
+enum MaskSensorType : uint8_t {
+  MASK_ZONE_OPEN = 0,
+  MASK_ZONE_TAMPER,
+  MASK_ZONE_BYPASS,
+  MASK_ZONE_ALARM_MEMORY,
+  MASK_ZONE_TAMPER_MEMORY,
+  MASK_PARTITION_ALARM,
+  MASK_PARTITION_ARMED_TOTAL,
+  MASK_PARTITION_ARMED_PARTIAL,
+  MASK_PARTITION_ARMED_PARTIAL_DELAY0,
+  MASK_WARNINGS,
+  MASK_TAMPERS,
+};
+
+enum MetricSensorType : uint8_t {
+  METRIC_POLL_RTT = 0,
+  METRIC_POLL_RTT_MIN,
+  METRIC_POLL_RTT_MAX,
+  METRIC_POLL_RTT_AVG,
+  METRIC_POLLS_PER_MINUTE,
+  METRIC_TIMEOUTS,
+  METRIC_LENGTH_ERRORS,
+  METRIC_CHECKSUM_ERRORS,
+  METRIC_BYTES_TX,
+  METRIC_BYTES_RX,
+  METRIC_CACHE_HIT_RATE,
+  METRIC_PUBLISHES_PER_MINUTE,
+  METRIC_BLOCKED_TIME,
+  METRIC_RECOVERIES,
+  METRIC_MEAN_TIME_TO_RECOVERY,
+  METRIC_SUPPRESSED_TRANSITIONS,
+};
+
+// Bus operations the error counters are kept for
+enum MetricOp : uint8_t {
+  METRIC_OP_VERSION = 0,  // async model detection
+  METRIC_OP_SENSOR,       // async sensor status poll
+  METRIC_OP_PARTITION,    // async partition status poll
+  METRIC_OP_BLOCKING,     // send_message_(): register reads and commands
+  METRIC_OP_PROBE,        // async link probe while recovering
+  METRIC_OP_COUNT,
+};
+static const uint8_t METRIC_OP_ALL = 0xFF;
+
+// Cheap always-on counters, cumulative since boot. Rates are derived per
+// publish window from the difference to the previous snapshot.
+struct KyoMetrics {
+  uint32_t polls{0};  // sensor+partition poll cycles started by update()
+  uint32_t timeouts[METRIC_OP_COUNT]{};
+  uint32_t length_errors[METRIC_OP_COUNT]{};
+  uint32_t checksum_errors[METRIC_OP_COUNT]{};
+  uint32_t bytes_tx{0};
+  uint32_t bytes_rx{0};
+  uint32_t cache_lookups{0};  // sensor_cache_ / partition_cache_ comparisons
+  uint32_t cache_hits{0};
+  uint32_t publishes{0};      // entity states published
+  uint32_t suppressed{0};     // state changes held back by a publish filter and never published
+  uint32_t blocked_ms{0};     // time spent inside send_message_()
+
+  // Link outages: first failed poll to the first good frame afterwards
+  uint32_t probes{0};
+  uint32_t recoveries{0};
+  uint32_t recovery_ms_total{0};
+  uint32_t last_recovery_ms{0};
+
+  // Async poll round-trip: command sent to last response byte
+  uint32_t rtt_samples{0};
+  uint32_t rtt_last_ms{0};
+  uint32_t rtt_min_ms{0};
+  uint32_t rtt_max_ms{0};
+  float rtt_avg_ms{0};  // EWMA, 1/8 weight per sample
+};
+
+struct RegisteredMetricSensor {
+  sensor::Sensor *sensor;
+  MetricSensorType type;
+  uint8_t op;  // MetricOp for the error counters, METRIC_OP_ALL for the sum
+};
+
 struct RegisteredTextSensor {
   text_sensor::TextSensor *sensor;
   TextSensorType type;
   uint8_t index;  // 0-based zone index
 };
 
+// Per-zone activity counters (built with zone_stats sensors)
+enum ZoneStatType : uint8_t {
+  ZONE_STAT_ACTIVATIONS = 0,
+  ZONE_STAT_OPEN_TIME,
+  ZONE_STAT_LAST_CHANGE,
+  ZONE_STAT_TAMPER_EVENTS,
+};
+
+struct RegisteredZoneStatSensor {
+  sensor::Sensor *sensor;
+  ZoneStatType type;
+  uint8_t index;  // 0-based zone index
+};
+
+struct RegisteredMaskSensor {
+  text_sensor::TextSensor *sensor;
+  MaskSensorType type;
+  int64_t published{-1};  // last mask sent, -1 before the first
+};
+
 // Forward declarations
 class BentelKyoAlarmPanel;
 
@@ -110,6 +238,34 @@ struct RegisteredBinarySensor {
   binary_sensor::BinarySensor *sensor;
   BinarySensorType type;
   uint8_t index;  // 0-based zone/partition/output index
+  int8_t published{-1};  // last state sent, -1 before the first
+
+  // Publish filter for chattering detectors (0 = off)
+  uint32_t debounce_ms{0};      // a new state must hold this long before it publishes
+  uint32_t min_interval_ms{0};  // at least this long between publishes
+  bool held{false};             // state differs from published, waiting on the filter
+  uint32_t held_since_ms{0};
+  uint32_t published_ms{0};
+};
+
+// Last known panel state, kept in preferences so a reboot starts from it: the
+// raw status frames are stored and decoded by the normal parsers on restore
+static const uint8_t SAVED_STATE_VERSION = 1;
+static const char *const SAVED_STATE_KEY = "bentel_kyo_state";
+struct KyoSavedState {
+  uint8_t version;
+  uint8_t model;  // AlarmModel
+  char firmware[14];
+  uint8_t sensor_len;
+  uint8_t partition_len;
+  uint8_t sensor[RESP_SENSOR_KYO32];
+  uint8_t partition[RESP_PARTITION_KYO32];
+};
+
+// Link health: normal polling, or probing for the panel after an outage
+enum class LinkState : uint8_t {
+  ONLINE = 0,
+  RECOVERING,
 };
 
 // Async serial state machine states
@@ -118,6 +274,16 @@ enum class SerialState : uint8_t {
   WAITING_RESPONSE,
 };
 
+// A blocking response, read in place into the hub's frame buffer: echo, data,
+// checksum. Only good until the next exchange on the bus.
+struct KyoResponse {
+  const uint8_t *frame{nullptr};
+  int len{-1};                   // bytes received, -1 without an answer
+  const uint8_t *data{nullptr};  // past the command echo
+  int data_len{0};               // without the trailing checksum
+  bool valid{false};             // data checksummed, and the requested length for register reads
+};
+
 class BentelKyo : public PollingComponent, public uart::UARTDevice {
  public:
   void setup() override;
@@ -129,9 +295,34 @@ class BentelKyo : public PollingComponent, public uart::UARTDevice {
   // Registration methods called from code generation
   void register_alarm_panel(BentelKyoAlarmPanel *panel);
   void register_binary_sensor(binary_sensor::BinarySensor *sensor, BinarySensorType type, uint8_t index);
+  // Debounce and rate-limit a registered sensor (not for alarm, tamper or siren sensors)
+  void set_publish_filter(binary_sensor::BinarySensor *sensor, uint32_t debounce_ms, uint32_t min_interval_ms);
   void set_firmware_version_text_sensor(text_sensor::TextSensor *sensor) { this->firmware_version_sensor_ = sensor; }
   void set_alarm_model_text_sensor(text_sensor::TextSensor *sensor) { this->alarm_model_sensor_ = sensor; }
   void register_text_sensor(text_sensor::TextSensor *sensor, TextSensorType type, uint8_t index);
+  void register_metric_sensor(sensor::Sensor *sensor, MetricSensorType type, uint8_t op = METRIC_OP_ALL);
+  void register_mask_sensor(text_sensor::TextSensor *sensor, MaskSensorType type);
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  void register_zone_stat_sensor(sensor::Sensor *sensor, ZoneStatType type, uint8_t index);
+  const KyoZoneStats &get_zone_stats() const { return this->zone_stats_; }
+#endif
+
+  // Byte transport (defaults to this device's UART)
+  void set_transport(KyoTransport *transport) { this->transport_ = transport; }
+  // Time source (defaults to the system clock)
+  void set_clock(KyoClock *clock) { this->clock_ = clock; }
+  // Publish the last known state from preferences at boot (default on)
+  void set_restore_state(bool restore) { this->restore_state_ = restore; }
+  // Main loop time shared with the other hubs on this device (defaults to one of its own)
+  void set_loop_budget(KyoLoopBudget *budget) { this->budget_ = budget; }
+  const KyoLoopBudget &get_loop_budget() const { return *this->budget_; }
+  // YAML id, to tell hubs apart in logs and in the saved state
+  void set_instance_id(const char *id) { this->instance_id_ = id; }
+#ifdef USE_BENTEL_KYO_RX_TASK
+  // Read the line from a dedicated task instead of loop() (ESP32 only)
+  void set_rx_task(bool enabled) { this->rx_task_enabled_ = enabled; }
+  const KyoRxPump &get_rx_pump() const { return this->rx_pump_; }
+#endif
 
   // Public command methods
   void arm_partition(uint8_t partition, uint8_t arm_type);
@@ -151,10 +342,42 @@ class BentelKyo : public PollingComponent, public uart::UARTDevice {
   // Polling control
   void set_polling_enabled(bool enabled);
   bool is_polling_enabled() const { return this->polling_enabled_; }
+  bool is_recovering() const { return this->link_state_ == LinkState::RECOVERING; }
 
   // Re-read panel configuration registers
   void reread_config();
 
+  // Current value of a packed state mask
+  uint32_t get_mask(MaskSensorType type) const;
+
+  // Runtime bus and poll-loop counters
+  const KyoMetrics &get_metrics() const { return this->metrics_; }
+
+  // Adaptive response timeouts
+  const KyoRttEstimator &get_rtt() const { return this->rtt_; }
+
+  // Blocking profiler (also part of dump_config())
+  void dump_profiler() const { this->profiler_.dump(false); }
+  void reset_profiler() { this->profiler_.reset(); }
+  const KyoProfiler &get_profiler() const { return this->profiler_; }
+
+  // Raw frame trace: frames are only recorded when built with a trace: block.
+  // Dumping logs the window and resumes a ring frozen by a failure.
+  void dump_trace(bool clear = false);
+  // Per-zone activity counters, logged; reset starts them over
+  void dump_zone_stats(bool reset = false);
+  // Zone and partition transitions in the order seen (built with a timeline: block)
+  void dump_timeline(bool clear = false);
+#ifdef USE_BENTEL_KYO_TIMELINE
+  const KyoTimeline &get_timeline() const { return this->timeline_; }
+#endif
+#ifdef USE_BENTEL_KYO_TRACE
+  void set_trace_window(uint32_t window_ms) { this->trace_window_ms_ = window_ms; }
+  void set_trace_freeze_on_failure(bool freeze) { this->trace_freeze_on_failure_ = freeze; }
+  void set_trace_dump_on_failure(bool dump) { this->trace_dump_on_failure_ = dump; }
+  const KyoTraceRing &get_trace() const { return this->trace_; }
+#endif
+
   friend class BentelKyoAlarmPanel;
 
  protected:
@@ -165,30 +388,62 @@ class BentelKyo : public PollingComponent, public uart::UARTDevice {
   static constexpr uint8_t CMD_GET_PARTITION_KYO8[6] = {0xF0, 0x68, 0x0E, 0x09, 0x00, 0x6F};
   static constexpr uint8_t CMD_GET_VERSION[6] = {0xF0, 0x00, 0x00, 0x0B, 0x00, 0xFB};
   static constexpr uint8_t CMD_RESET_ALARMS[9] = {0x0F, 0x05, 0xF0, 0x01, 0x00, 0x05, 0xFF, 0x00, 0xFF};
+  // First byte of the version string: the shortest read every model answers
+  static constexpr uint8_t CMD_PROBE[6] = {0xF0, 0x00, 0x00, 0x00, 0x00, 0xF0};
 
   // Internal methods
   bool detect_alarm_model_(const uint8_t *rx, int count);
   bool parse_sensor_status_(const uint8_t *rx, int count);
   bool parse_partition_status_(const uint8_t *rx, int count);
-  void send_command_async_(const uint8_t *cmd, int cmd_len, uint8_t pending_op, uint32_t timeout_ms = 80);
-  void handle_serial_failure_();
-  int send_message_(const uint8_t *cmd, int cmd_len, uint8_t *response, uint32_t timeout_ms = SERIAL_TIMEOUT_MS);
-  int read_register_(uint16_t address, uint8_t length, uint8_t *response, uint32_t timeout_ms = SERIAL_TIMEOUT_MS);
+  void send_command_async_(const uint8_t *cmd, int cmd_len, uint8_t pending_op, uint32_t timeout_ms);
+  uint32_t poll_timeout_ms_(uint8_t pending_op) const;
+  void dispatch_async_response_(bool allow_chain);
+  int expected_async_len_(uint8_t pending_op) const;
+  uint32_t estimate_async_finish_ms_(uint32_t now) const;
+  uint32_t arbitrate_async_poll_(int *drain_bytes);
+  void handle_serial_failure_(bool silent);
+  void mark_link_up_();
+  void schedule_probe_(bool silent);
+  void send_probe_();
+  void schedule_loop_();
+  bool acquire_blocking_();
+  void release_blocking_();
+  void service_serial_();
+  bool record_async_frame_(int count);
+  uint8_t read_byte_();
+  uint32_t rx_byte_ms_() const;
+  void write_bytes_(const uint8_t *data, int len);
+  void trace_frame_(bool rx, uint8_t op, const uint8_t *data, int len);
+  void trigger_trace_(const char *reason);
+  // expected_len sizes the timeout; commands pass 0 and get the class estimate
+  KyoResponse send_message_(const uint8_t *cmd, int cmd_len, RttClass cls = RTT_CLASS_COMMAND, int expected_len = 0);
+  KyoResponse read_register_(uint16_t address, uint8_t length, RttClass cls = RTT_CLASS_REGISTER);
   void read_zone_config_();
+  void read_partition_config_();
+#ifdef USE_BENTEL_KYO_NAMES
   void read_zone_names_();
-  bool read_zone_esn_next_();    // reads one zone ESN per call, returns true when done
   void read_output_names_();
-  void read_partition_config_();
-  bool read_keyfob_esn_next_();  // reads one keyfob ESN per call, returns true when done
   void read_keyfob_names_();
   void read_partition_names_();
   void read_code_names_();
+#endif
+#ifdef USE_BENTEL_KYO_ESN
+  bool read_zone_esn_next_();    // reads one zone ESN per call, returns true when done
+  bool read_keyfob_esn_next_();  // reads one keyfob ESN per call, returns true when done
+#endif
+#ifdef USE_BENTEL_KYO_EVENT_LOG
   bool read_event_log_next_();  // reads one 64-byte chunk per call, returns true when done
+  int decode_event_log_chunk_(const uint8_t *rx, int count, int chunk);  // returns records logged
   const char *decode_event_code_(uint16_t code, uint8_t *entity_out, char *buf, size_t buf_len);
+#endif
   void read_panel_mode_();
   void read_status_flags_();
   void publish_text_sensors_();
 
+  // Saved state (preferences)
+  void load_saved_state_();
+  void save_state_();
+
   // Checksum helpers
   static uint8_t calculate_crc_(const uint8_t *cmd, int len);
   static uint8_t calculate_checksum_(const uint8_t *data, int offset, int len);
@@ -198,40 +453,120 @@ class BentelKyo : public PollingComponent, public uart::UARTDevice {
   bool get_zone_bit_8_(const uint8_t *rx, int offset, int zone_index);
 
   // State publishing
-  void publish_binary_sensors_();
+  bool binary_sensor_state_(const RegisteredBinarySensor &entry) const;
+  void publish_binary_sensors_(bool all);
+  void publish_mask_sensors_(bool all, bool alarms_only);
+  void commit_status_();
+  void publish_alarm_fast_path_();
+  void publish_communication_();
   void publish_alarm_panels_();
+  void publish_metrics_();
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  void publish_zone_stats_();
+  void save_zone_stats_();
+#endif
 
   // Registered entities
   std::vector<BentelKyoAlarmPanel *> alarm_panels_;
   std::vector<RegisteredBinarySensor> binary_sensors_;
   std::vector<RegisteredTextSensor> text_sensors_;
+  std::vector<RegisteredMetricSensor> metric_sensors_;
+  std::vector<RegisteredMaskSensor> mask_sensors_;
   text_sensor::TextSensor *firmware_version_sensor_{nullptr};
   text_sensor::TextSensor *alarm_model_sensor_{nullptr};
 
   // Model and state
   AlarmModel alarm_model_{AlarmModel::UNKNOWN};
   bool model_detected_{false};
+  bool model_restored_{false};  // model came from preferences, version query not answered yet
+  bool restoring_{false};       // decoding the saved frames: state only, no activity counted
+  bool partition_live_{false};  // arming masks come from the panel, not the saved snapshot
   int max_zones_{KYO_MAX_ZONES};
   char firmware_version_[14]{};
 
+  // Last known state across reboots
+  bool restore_state_{true};
+  ESPPreferenceObject state_pref_;
+  KyoSavedState saved_state_{};  // what state_pref_ holds, to skip unchanged saves
+
+  // Byte transport
+  UARTTransport uart_transport_{this};
+  KyoTransport *transport_{&this->uart_transport_};
+#ifdef USE_BENTEL_KYO_RX_TASK
+  KyoRxPump rx_pump_;
+  bool rx_task_enabled_{false};
+#endif
+
+  // Time source
+  SystemClock system_clock_;
+  KyoClock *clock_{&this->system_clock_};
+
+  // Blocking work budget and identity among several hubs
+  KyoLoopBudget own_budget_;
+  KyoLoopBudget *budget_{&this->own_budget_};
+  const char *instance_id_{nullptr};
+
   // Async serial I/O state machine
   SerialState serial_state_{SerialState::IDLE};
+  // The one frame buffer: async polls, and blocking exchanges once the poll is
+  // resolved (arbitrate_async_poll_() parses or drops it first)
   uint8_t serial_rx_buf_[255]{};
   int serial_rx_index_{0};
   int serial_cmd_len_{0};  // length of command sent (to detect echo end)
+  int serial_expected_len_{0};  // full frame length (echo + data + checksum), 0 if unknown
   uint32_t serial_sent_ms_{0};
   uint32_t serial_last_byte_ms_{0};
   uint32_t serial_timeout_ms_{80};
-  // Callback: 0=detect, 1=sensor, 2=partition
+  // MetricOp of the exchange in flight: version, sensor, partition or probe
   uint8_t serial_pending_op_{0};
+  // Held while an exchange is in flight, so its end is seen within ~1ms
+  // instead of the 16ms main loop interval
+  HighFrequencyLoopRequester high_freq_;
 
   // Polling control
   bool polling_enabled_{true};
 
-  // Communication health and backoff
+  // Communication health and recovery
   bool communication_ok_{false};
-  uint32_t backoff_until_ms_{0};  // skip polling until this millis() value
-  uint8_t consecutive_failures_{0};  // for exponential backoff (caps at 7 = 32s)
+  LinkState link_state_{LinkState::ONLINE};
+  uint8_t consecutive_failures_{0};  // failed polls in a row, silent or garbled
+  uint8_t silent_failures_{0};       // of which got no bytes at all
+  uint8_t bad_failures_{0};          // of which got bytes that did not parse
+  uint8_t probe_backoff_{0};         // silent probes since the link went down
+  uint32_t next_probe_ms_{0};
+  uint32_t outage_start_ms_{0};
+  uint32_t jitter_state_{0};         // xorshift32, seeded from the clock on first use
+
+  // Runtime metrics (snapshot = counters at the start of the current window)
+  KyoMetrics metrics_;
+  KyoMetrics metrics_snapshot_;
+  uint32_t metrics_window_start_ms_{0};
+
+  // Blocking profiler
+  KyoProfiler profiler_;
+
+  // Per-class response time estimates driving every timeout
+  KyoRttEstimator rtt_;
+
+#ifdef USE_BENTEL_KYO_ZONE_STATS
+  // Zone activity from the sensor frame diff, saved every ZONE_STATS_SAVE_INTERVAL_MS
+  KyoZoneStats zone_stats_;
+  std::vector<RegisteredZoneStatSensor> zone_stat_sensors_;
+  ESPPreferenceObject stats_pref_;
+  uint32_t stats_saved_ms_{0};
+#endif
+
+#ifdef USE_BENTEL_KYO_TIMELINE
+  KyoTimeline timeline_;
+#endif
+
+#ifdef USE_BENTEL_KYO_TRACE
+  // Raw frame trace, frozen on communication loss so the lead-up survives
+  KyoTraceRing trace_;
+  uint32_t trace_window_ms_{20000};
+  bool trace_freeze_on_failure_{true};
+  bool trace_dump_on_failure_{false};
+#endif
 
   // Response caches for change detection
   uint8_t sensor_cache_[32]{};
@@ -239,8 +574,11 @@ class BentelKyo : public PollingComponent, public uart::UARTDevice {
   int sensor_cache_len_{0};
   int partition_cache_len_{0};
   bool force_publish_{true};
+  bool status_dirty_{false};  // decoded into the state below, not yet published
+  bool filter_pending_{false};  // a filtered sensor is holding back a change
 
-  // Parsed state buffers (updated from responses)
+  // Parsed state buffers: the parsers stage both frames of a poll cycle here,
+  // commit_status_() publishes them together once the cycle is over
   // Sensor status
   bool zone_state_[KYO_MAX_ZONES]{};
   bool zone_tamper_[KYO_MAX_ZONES]{};
@@ -287,26 +625,24 @@ class BentelKyo : public PollingComponent, public uart::UARTDevice {
   uint8_t zone_type_raw_[KYO_MAX_ZONES]{};   // raw type byte
   uint8_t zone_area_mask_[KYO_MAX_ZONES]{};   // area bitmask
   bool zone_enrolled_[KYO_MAX_ZONES]{};
-  std::string zone_name_[KYO_MAX_ZONES];
-  std::string zone_esn_[KYO_MAX_ZONES];
-
-  // Output names (read once from 0x3280)
-  std::string output_name_[KYO_MAX_OUTPUTS];
 
   // Partition configuration (read once from 0x01E9)
   uint8_t partition_entry_delay_[KYO_MAX_PARTITIONS]{};
   uint8_t partition_exit_delay_[KYO_MAX_PARTITIONS]{};
   uint8_t partition_siren_timer_[KYO_MAX_PARTITIONS]{};
 
-  // Partition names (read once from 0x2BA0)
-  std::string partition_name_[KYO_MAX_PARTITIONS];
-
-  // Keyfob ESN (read once from 0xC0B1) and names (read once from 0x3180)
-  std::string keyfob_esn_[KYO_MAX_KEYFOBS];
-  std::string keyfob_name_[KYO_MAX_KEYFOBS];
-
-  // Code names (read once from 0x3000)
-  std::string code_name_[KYO_MAX_CODES];
+  // Names and ESNs, only compiled in when a text sensor publishes them
+#ifdef USE_BENTEL_KYO_NAMES
+  std::string zone_name_[KYO_MAX_ZONES];
+  std::string output_name_[KYO_MAX_OUTPUTS];       // read once from 0x3280
+  std::string partition_name_[KYO_MAX_PARTITIONS];  // read once from 0x2BA0
+  std::string keyfob_name_[KYO_MAX_KEYFOBS];        // read once from 0x3180
+  std::string code_name_[KYO_MAX_CODES];            // read once from 0x3000
+#endif
+#ifdef USE_BENTEL_KYO_ESN
+  std::string zone_esn_[KYO_MAX_ZONES];      // read once from 0xC045
+  std::string keyfob_esn_[KYO_MAX_KEYFOBS];  // read once from 0xC0B1
+#endif
 
   // Event log dump (on-demand via button)
   bool event_log_read_pending_{false};
@@ -5,6 +5,7 @@ import esphome.config_validation as cv
 from esphome.components import binary_sensor, text_sensor
 from esphome.const import (
     CONF_ID,
+    CONF_MIN_INTERVAL,
     CONF_NAME,
     CONF_DEVICE_CLASS,
     DEVICE_CLASS_CONNECTIVITY,
@@ -39,6 +40,7 @@ CONF_OUTPUT_STATE = "output_state"
 CONF_OUTPUT_NUMBER = "output_number"
 CONF_PANEL_PROGRAMMING_MODE = "panel_programming_mode"
 CONF_TROUBLE_ACTIVE = "trouble_active"
+CONF_DEBOUNCE = "debounce"
 
 # Zone diagnostic text sensor keys (nested inside zone entries)
 CONF_ZONE_TYPE = "zone_type"
@@ -111,11 +113,14 @@ TEXT_SENSOR_TYPES = {
 
 # Zone sensors: no default device_class (user picks motion/door/window/etc)
 # Includes optional nested text_sensor diagnostics for zone_type, panel_name, zone_area
+# debounce / min_interval hold back chattering detectors at the hub, per poll
 ZONE_SENSOR_SCHEMA = binary_sensor.binary_sensor_schema(
     icon="mdi:shield-home",
 ).extend(
     {
         cv.Required(CONF_ZONE): cv.int_range(min=1, max=32),
+        cv.Optional(CONF_DEBOUNCE): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MIN_INTERVAL): cv.positive_time_period_milliseconds,
         cv.Optional(CONF_ZONE_TYPE): text_sensor.text_sensor_schema(
             icon="mdi:shield-alert-outline",
             entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
@@ -327,10 +332,16 @@ async def _register_sensor(hub, config, sensor_type_str, index=0, disabled_by_de
     if disabled_by_default:
         cg.add(var.set_disabled_by_default(True))
     cg.add(hub.register_binary_sensor(var, SENSOR_TYPES[sensor_type_str], index))
+    return var
 
 
 async def _register_text_sensor(hub, config, type_str, index):
     """Register a zone diagnostic text sensor with the hub."""
+    # The name and ESN register reads are only compiled in when published
+    if type_str in ("TEXT_ZONE_NAME", "TEXT_OUTPUT_NAME", "TEXT_KEYFOB_NAME"):
+        cg.add_define("USE_BENTEL_KYO_NAMES")
+    elif type_str == "TEXT_ZONE_ESN":
+        cg.add_define("USE_BENTEL_KYO_ESN")
     var = await text_sensor.new_text_sensor(config)
     cg.add(var.set_disabled_by_default(True))
     cg.add(hub.register_text_sensor(var, TEXT_SENSOR_TYPES[type_str], index))
@@ -343,7 +354,17 @@ async def to_code(config):
     if CONF_ZONES in config:
         for zone_conf in config[CONF_ZONES]:
             zone_index = zone_conf[CONF_ZONE] - 1  # Convert to 0-based
-            await _register_sensor(hub, zone_conf, "ZONE", zone_index)
+            var = await _register_sensor(hub, zone_conf, "ZONE", zone_index)
+            if CONF_DEBOUNCE in zone_conf or CONF_MIN_INTERVAL in zone_conf:
+                debounce = zone_conf.get(CONF_DEBOUNCE)
+                interval = zone_conf.get(CONF_MIN_INTERVAL)
+                cg.add(
+                    hub.set_publish_filter(
+                        var,
+                        debounce.total_milliseconds if debounce else 0,
+                        interval.total_milliseconds if interval else 0,
+                    )
+                )
 
             # Nested zone diagnostic text sensors
             if CONF_ZONE_TYPE in zone_conf:
@@ -114,7 +114,10 @@ async def to_code(config):
     cg.add(var.set_parent(parent))
 
     type_str = config[CONF_TYPE]
-    if type_str in ARM_TYPE_MAP:
+    if type_str == "read_event_log":
+        # The event log reader and its event name table are compiled in only with this button
+        cg.add_define("USE_BENTEL_KYO_EVENT_LOG")
+    elif type_str in ARM_TYPE_MAP:
         cg.add(var.set_arm_type(ARM_TYPE_MAP[type_str]))
     elif type_str == "arm_preset":
         partitions = config[CONF_PARTITIONS]
@@ -0,0 +1,38 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include "esphome/core/hal.h"
+
+#include <cstdint>
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Time source used by the protocol engine for timeouts, silence detection and
+// backoff, and yield() for its busy-wait loops. The system clock is the
+// production default; the host build injects a virtual clock so the engine and
+// a simulated panel run faster than real time and reproducibly.
+class KyoClock {
+ public:
+  virtual ~KyoClock() = default;
+  virtual uint32_t millis() = 0;
+  virtual uint32_t micros() = 0;
+  virtual void yield() = 0;
+};
+
+class SystemClock : public KyoClock {
+ public:
+  uint32_t millis() override { return esphome::millis(); }
+  uint32_t micros() override { return esphome::micros(); }
+  void yield() override { esphome::yield(); }
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
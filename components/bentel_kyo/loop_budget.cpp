@@ -0,0 +1,109 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "loop_budget.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_BUDGET = "bentel_kyo.budget";
+
+void KyoLoopBudget::add_hub(const void *hub) {
+  if (this->find_(hub) != nullptr)
+    return;
+  if (this->count_ >= LOOP_BUDGET_MAX_HUBS) {
+    ESP_LOGE(TAG_BUDGET, "More than %u hubs, extra hubs block without a budget", (unsigned) LOOP_BUDGET_MAX_HUBS);
+    return;
+  }
+  // A new hub has not polled yet; blocking waits for its first poll
+  this->slots_[this->count_++] = {hub, false, 0, 0};
+}
+
+KyoLoopBudget::Slot *KyoLoopBudget::find_(const void *hub) {
+  for (uint8_t i = 0; i < this->count_; i++) {
+    if (this->slots_[i].hub == hub)
+      return &this->slots_[i];
+  }
+  return nullptr;
+}
+
+const KyoLoopBudget::Slot *KyoLoopBudget::find_(const void *hub) const {
+  for (uint8_t i = 0; i < this->count_; i++) {
+    if (this->slots_[i].hub == hub)
+      return &this->slots_[i];
+  }
+  return nullptr;
+}
+
+void KyoLoopBudget::refill_(uint32_t now_ms) {
+  if (!this->credit_started_) {
+    this->credit_started_ = true;
+    this->credit_at_ms_ = now_ms;
+    return;
+  }
+  uint32_t elapsed = now_ms - this->credit_at_ms_;
+  this->credit_at_ms_ = now_ms;
+  int64_t credit = (int64_t) this->credit_ms_ + (int64_t) elapsed * LOOP_BUDGET_DUTY_PERCENT / 100;
+  this->credit_ms_ = credit > (int64_t) LOOP_BUDGET_BURST_MS ? (int32_t) LOOP_BUDGET_BURST_MS : (int32_t) credit;
+}
+
+bool KyoLoopBudget::try_acquire(const void *hub, uint32_t now_ms) {
+  Slot *slot = this->find_(hub);
+  if (slot == nullptr)
+    return true;  // over the hub limit: unbudgeted
+  this->refill_(now_ms);
+
+  bool all_polled = true;
+  for (uint8_t i = 0; i < this->count_; i++)
+    all_polled = all_polled && this->slots_[i].polled;
+  if (this->holder_ != nullptr || !all_polled || this->credit_ms_ <= 0) {
+    slot->deferrals++;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < this->count_; i++)
+    this->slots_[i].polled = false;
+  slot->grants++;
+  this->holder_ = hub;
+  this->acquired_ms_ = now_ms;
+  return true;
+}
+
+void KyoLoopBudget::release(const void *hub, uint32_t now_ms) {
+  if (this->holder_ != hub)
+    return;
+  this->refill_(now_ms);
+  this->credit_ms_ -= (int32_t) (now_ms - this->acquired_ms_);
+  this->holder_ = nullptr;
+}
+
+void KyoLoopBudget::poll_done(const void *hub) {
+  Slot *slot = this->find_(hub);
+  if (slot != nullptr)
+    slot->polled = true;
+}
+
+uint32_t KyoLoopBudget::get_grants(const void *hub) const {
+  const Slot *slot = this->find_(hub);
+  return slot != nullptr ? slot->grants : 0;
+}
+
+uint32_t KyoLoopBudget::get_deferrals(const void *hub) const {
+  const Slot *slot = this->find_(hub);
+  return slot != nullptr ? slot->deferrals : 0;
+}
+
+void KyoLoopBudget::dump_config(const void *hub) const {
+  ESP_LOGCONFIG(TAG_BUDGET, "  Blocking budget: %u hub(s), %u%% duty, %u blocking steps, %u deferred",
+                (unsigned) this->count_, (unsigned) LOOP_BUDGET_DUTY_PERCENT, (unsigned) this->get_grants(hub),
+                (unsigned) this->get_deferrals(hub));
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,65 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const uint8_t LOOP_BUDGET_MAX_HUBS = 4;
+static const uint32_t LOOP_BUDGET_DUTY_PERCENT = 50;  // blocking share of main loop time, long-run
+static const uint32_t LOOP_BUDGET_BURST_MS = 2000;    // credit a quiet main loop saves up
+
+// Main loop time shared by the hubs on one device. Configuration reads, event
+// log chunks and status refreshes block the main loop, and while one hub
+// blocks no other hub can finish a live poll. A blocking step is granted only
+// once every hub has completed a poll since the last step (so each panel gets
+// a status refresh between any two steps, its own included), and only while
+// the token bucket has credit: credit accrues at the duty share of elapsed
+// time up to the burst and blocking time is taken off it. A hub that is
+// refused polls instead and asks again on its next update().
+class KyoLoopBudget {
+ public:
+  void add_hub(const void *hub);
+  uint8_t get_hub_count() const { return this->count_; }
+
+  bool try_acquire(const void *hub, uint32_t now_ms);
+  void release(const void *hub, uint32_t now_ms);
+  // The hub's exchange (or chain of them) is over, or it has nothing to poll
+  void poll_done(const void *hub);
+
+  int32_t get_credit_ms() const { return this->credit_ms_; }
+  uint32_t get_grants(const void *hub) const;
+  uint32_t get_deferrals(const void *hub) const;
+  void dump_config(const void *hub) const;
+
+ protected:
+  struct Slot {
+    const void *hub;
+    bool polled;
+    uint32_t grants;
+    uint32_t deferrals;
+  };
+
+  Slot *find_(const void *hub);
+  const Slot *find_(const void *hub) const;
+  void refill_(uint32_t now_ms);
+
+  Slot slots_[LOOP_BUDGET_MAX_HUBS]{};
+  uint8_t count_{0};
+  int32_t credit_ms_{(int32_t) LOOP_BUDGET_BURST_MS};
+  uint32_t credit_at_ms_{0};
+  bool credit_started_{false};
+  const void *holder_{nullptr};
+  uint32_t acquired_ms_{0};
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,139 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "profiler.h"
+#include "esphome/core/log.h"
+
+#include <cstdio>
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_PROFILER = "bentel_kyo.profiler";
+
+static const uint32_t BUCKET_LIMITS_US[PROFILE_BUCKETS - 1] = {
+    100, 1000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000,
+};
+static const char *const BUCKET_LABELS[PROFILE_BUCKETS] = {
+    "<0.1ms", "<1ms", "<5ms", "<10ms", "<20ms", "<50ms", "<100ms", "<200ms", "<500ms", "<1s", "<2s", ">=2s",
+};
+
+static const char *const CONFIG_STEP_NAMES[13] = {
+    "wait", "zone config", "zone names", "zone ESN", "output names", "partition config", "partition names",
+    "code names", "keyfob ESN", "keyfob names", "panel mode", "status flags", "publish text sensors",
+};
+
+static const char *const COMMAND_NAMES[] = {
+    "arm", "disarm", "arm all", "disarm all", "arm preset", "reset alarms",
+    "output on", "output off", "zone include", "zone exclude", "set datetime",
+};
+
+static void phase_label(int phase, char *buf, size_t len) {
+  if (phase >= PROFILE_CONFIG_STEP && phase < PROFILE_EVENT_LOG) {
+    int step = phase - PROFILE_CONFIG_STEP;
+    snprintf(buf, len, "config step %d (%s)", step, CONFIG_STEP_NAMES[step]);
+    return;
+  }
+  switch (phase) {
+    case PROFILE_LOOP: snprintf(buf, len, "loop()"); break;
+    case PROFILE_UPDATE: snprintf(buf, len, "update()"); break;
+    case PROFILE_EVENT_LOG: snprintf(buf, len, "event log chunk"); break;
+    case PROFILE_STATUS_REFRESH: snprintf(buf, len, "status refresh"); break;
+    case PROFILE_COMMAND: snprintf(buf, len, "command"); break;
+    case PROFILE_SEND_MESSAGE: snprintf(buf, len, "send_message"); break;
+    default: snprintf(buf, len, "phase %d", phase); break;
+  }
+}
+
+// What the detail of a phase means, empty when it carries none
+static void detail_label(int phase, uint16_t detail, char *buf, size_t len) {
+  buf[0] = '\0';
+  if (phase == PROFILE_CONFIG_STEP + 3 || phase == PROFILE_CONFIG_STEP + 8) {
+    snprintf(buf, len, "slot %u", (unsigned) detail + 1);
+  } else if (phase == PROFILE_EVENT_LOG) {
+    snprintf(buf, len, "chunk %u", (unsigned) detail + 1);
+  } else if (phase == PROFILE_COMMAND) {
+    if (detail < sizeof(COMMAND_NAMES) / sizeof(COMMAND_NAMES[0]))
+      snprintf(buf, len, "%s", COMMAND_NAMES[detail]);
+  } else if (phase == PROFILE_SEND_MESSAGE) {
+    snprintf(buf, len, "0x%04X", (unsigned) detail);
+  }
+}
+
+int KyoProfiler::bucket_for(uint32_t elapsed_us) {
+  for (int i = 0; i < PROFILE_BUCKETS - 1; i++) {
+    if (elapsed_us < BUCKET_LIMITS_US[i])
+      return i;
+  }
+  return PROFILE_BUCKETS - 1;
+}
+
+void KyoProfiler::record(ProfilePhase phase, uint16_t detail, uint32_t elapsed_us) {
+  ProfileHistogram &h = this->histograms_[phase];
+  h.buckets[bucket_for(elapsed_us)]++;
+  h.count++;
+  h.total_us += elapsed_us;
+  if (elapsed_us >= h.max_us) {
+    h.max_us = elapsed_us;
+    h.max_detail = detail;
+  }
+
+  // Attribute long stalls as they happen. loop()/update() contain the sections
+  // and send_message_() runs inside them, so only the sections are logged.
+  if (elapsed_us >= PROFILE_STALL_LOG_US && phase >= PROFILE_CONFIG_STEP && phase < PROFILE_SEND_MESSAGE) {
+    char name[40], what[24];
+    phase_label(phase, name, sizeof(name));
+    detail_label(phase, detail, what, sizeof(what));
+    ESP_LOGD(TAG_PROFILER, "Blocked %ums in %s%s%s", (unsigned) (elapsed_us / 1000), name, what[0] ? ", " : "",
+             what);
+  }
+}
+
+void KyoProfiler::reset() {
+  for (auto &h : this->histograms_)
+    h = ProfileHistogram{};
+}
+
+void KyoProfiler::dump(bool config) const {
+  bool any = false;
+  for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+    const ProfileHistogram &h = this->histograms_[phase];
+    if (h.count == 0)
+      continue;
+    if (!any) {
+      if (config)
+        ESP_LOGCONFIG(TAG_PROFILER, "  Blocking profile (count, avg, max, histogram):");
+      else
+        ESP_LOGI(TAG_PROFILER, "Blocking profile (count, avg, max, histogram):");
+      any = true;
+    }
+
+    char name[40], what[24], buckets[160];
+    phase_label(phase, name, sizeof(name));
+    detail_label(phase, h.max_detail, what, sizeof(what));
+    int pos = 0;
+    for (int i = 0; i < PROFILE_BUCKETS && pos < (int) sizeof(buckets); i++) {
+      if (h.buckets[i] > 0)
+        pos += snprintf(buckets + pos, sizeof(buckets) - pos, " %s:%u", BUCKET_LABELS[i], (unsigned) h.buckets[i]);
+    }
+    double avg_ms = h.total_us / 1000.0 / h.count;
+    double max_ms = h.max_us / 1000.0;
+    if (config) {
+      ESP_LOGCONFIG(TAG_PROFILER, "    %s: n=%u avg=%.1fms max=%.1fms%s%s%s |%s", name, (unsigned) h.count, avg_ms,
+                    max_ms, what[0] ? " (" : "", what, what[0] ? ")" : "", buckets);
+    } else {
+      ESP_LOGI(TAG_PROFILER, "  %s: n=%u avg=%.1fms max=%.1fms%s%s%s |%s", name, (unsigned) h.count, avg_ms, max_ms,
+               what[0] ? " (" : "", what, what[0] ? ")" : "", buckets);
+    }
+  }
+  if (!any && !config)
+    ESP_LOGI(TAG_PROFILER, "Blocking profile: no samples yet");
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
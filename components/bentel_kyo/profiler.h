@@ -0,0 +1,93 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include "clock.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Main-loop blocking profiler. Every loop()/update() call and every blocking
+// section is timed into a fixed-bucket histogram for its phase; each histogram
+// also remembers the detail (ESN slot, event log chunk, command, register
+// address) of its slowest sample so a stall can be traced to its source.
+enum ProfilePhase : uint8_t {
+  PROFILE_LOOP = 0,
+  PROFILE_UPDATE,
+  PROFILE_CONFIG_STEP,                           // + config_read_step_ (0-12), detail: ESN slot
+  PROFILE_EVENT_LOG = PROFILE_CONFIG_STEP + 13,  // detail: chunk
+  PROFILE_STATUS_REFRESH,                        // periodic panel mode / status flags re-read
+  PROFILE_COMMAND,                               // detail: ProfileCommand
+  PROFILE_SEND_MESSAGE,                          // every blocking exchange, detail: command bytes 1-2
+  PROFILE_PHASE_COUNT,
+};
+
+enum ProfileCommand : uint8_t {
+  PROFILE_CMD_ARM = 0,
+  PROFILE_CMD_DISARM,
+  PROFILE_CMD_ARM_ALL,
+  PROFILE_CMD_DISARM_ALL,
+  PROFILE_CMD_ARM_PRESET,
+  PROFILE_CMD_RESET_ALARMS,
+  PROFILE_CMD_OUTPUT_ON,
+  PROFILE_CMD_OUTPUT_OFF,
+  PROFILE_CMD_ZONE_INCLUDE,
+  PROFILE_CMD_ZONE_EXCLUDE,
+  PROFILE_CMD_SET_DATETIME,
+};
+
+// Bucket upper bounds: 0.1, 1, 5, 10, 20, 50, 100, 200, 500, 1000, 2000 ms, then overflow
+static const int PROFILE_BUCKETS = 12;
+static const uint32_t PROFILE_STALL_LOG_US = 100000;  // log blocking sections at least this long
+
+struct ProfileHistogram {
+  uint32_t buckets[PROFILE_BUCKETS]{};
+  uint32_t count{0};
+  uint64_t total_us{0};
+  uint32_t max_us{0};
+  uint16_t max_detail{0};
+};
+
+class KyoProfiler {
+ public:
+  void record(ProfilePhase phase, uint16_t detail, uint32_t elapsed_us);
+  void reset();
+  // Logs every phase that has samples (ESP_LOGCONFIG from dump_config(), ESP_LOGI otherwise)
+  void dump(bool config) const;
+
+  const ProfileHistogram &get(ProfilePhase phase) const { return this->histograms_[phase]; }
+  static int bucket_for(uint32_t elapsed_us);
+
+ protected:
+  ProfileHistogram histograms_[PROFILE_PHASE_COUNT];
+};
+
+// Records the lifetime of the scope into the profiler
+class ProfileScope {
+ public:
+  ProfileScope(KyoProfiler *profiler, KyoClock *clock, ProfilePhase phase, uint16_t detail = 0)
+      : profiler_(profiler), clock_(clock), phase_(phase), detail_(detail), start_us_(clock->micros()) {}
+  ~ProfileScope() { this->profiler_->record(this->phase_, this->detail_, this->clock_->micros() - this->start_us_); }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+ protected:
+  KyoProfiler *profiler_;
+  KyoClock *clock_;
+  ProfilePhase phase_;
+  uint16_t detail_;
+  uint32_t start_us_;
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,88 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "rtt.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_RTT = "bentel_kyo.rtt";
+
+// Initial values are the timeouts used before estimation; EEPROM reads take
+// about a second on a KYO32G, everything else answers within tens of ms.
+static const RttClassLimits LIMITS[RTT_CLASS_COUNT] = {
+    {80, 40, 320},       // poll
+    {300, 60, 1200},     // register
+    {500, 120, 2000},    // event log
+    {1500, 300, 4000},   // EEPROM
+    {250, 60, 1000},     // command
+};
+
+static const char *const CLASS_NAMES[RTT_CLASS_COUNT] = {"poll", "register", "event log", "EEPROM", "command"};
+
+const RttClassLimits &KyoRttEstimator::limits(RttClass cls) { return LIMITS[cls]; }
+
+void KyoRttEstimator::sample(RttClass cls, uint32_t elapsed_ms, int bytes) {
+  RttClassState &s = this->state_[cls];
+  uint32_t wire = wire_ms(bytes);
+  int32_t m = elapsed_ms > wire ? (int32_t) (elapsed_ms - wire) : 0;
+  if (s.samples == 0) {
+    s.srtt_x8 = m << 3;
+    s.rttvar_x4 = m << 1;  // RTTVAR = R/2
+  } else {
+    int32_t delta = m - (s.srtt_x8 >> 3);
+    s.srtt_x8 += delta;  // SRTT += (R - SRTT)/8
+    if (delta < 0)
+      delta = -delta;
+    s.rttvar_x4 += delta - (s.rttvar_x4 >> 2);  // RTTVAR += (|R - SRTT| - RTTVAR)/4
+  }
+  s.samples++;
+  s.backoff = 0;
+}
+
+void KyoRttEstimator::timed_out(RttClass cls) {
+  RttClassState &s = this->state_[cls];
+  s.timeouts++;
+  if (s.backoff < RTT_MAX_BACKOFF)
+    s.backoff++;
+}
+
+uint32_t KyoRttEstimator::timeout_ms(RttClass cls, int expected_bytes) const {
+  const RttClassState &s = this->state_[cls];
+  const RttClassLimits &lim = LIMITS[cls];
+  uint32_t base;
+  if (s.samples == 0) {
+    base = lim.initial_ms;
+  } else {
+    uint32_t variance = s.rttvar_x4 > (int32_t) RTT_MIN_VARIANCE_MS ? s.rttvar_x4 : RTT_MIN_VARIANCE_MS;
+    base = wire_ms(expected_bytes) + (s.srtt_x8 >> 3) + variance;
+  }
+  base <<= s.backoff;
+  if (base < lim.floor_ms)
+    return lim.floor_ms;
+  if (base > lim.ceiling_ms)
+    return lim.ceiling_ms;
+  return base;
+}
+
+void KyoRttEstimator::dump_config() const {
+  ESP_LOGCONFIG(TAG_RTT, "  Response timeouts (turnaround SRTT/RTTVAR):");
+  for (int cls = 0; cls < RTT_CLASS_COUNT; cls++) {
+    const RttClassState &s = this->state_[cls];
+    if (s.samples == 0) {
+      ESP_LOGCONFIG(TAG_RTT, "    %s: no samples, %ums", CLASS_NAMES[cls], (unsigned) LIMITS[cls].initial_ms);
+      continue;
+    }
+    ESP_LOGCONFIG(TAG_RTT, "    %s: %d/%dms, n=%u, timeouts=%u, backoff x%u", CLASS_NAMES[cls], (int) (s.srtt_x8 >> 3),
+                  (int) (s.rttvar_x4 >> 2), (unsigned) s.samples, (unsigned) s.timeouts, 1u << s.backoff);
+  }
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,69 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const uint32_t BYTE_TIME_US = 1146;  // 9600 baud 8E1 = 11 bits per byte
+
+// Exchanges whose panel-side latency differs: async status polls, RAM register
+// reads, event log chunks, EEPROM (0xC0xx) reads and write commands.
+enum RttClass : uint8_t {
+  RTT_CLASS_POLL = 0,
+  RTT_CLASS_REGISTER,
+  RTT_CLASS_EVENT_LOG,
+  RTT_CLASS_EEPROM,
+  RTT_CLASS_COMMAND,
+  RTT_CLASS_COUNT,
+};
+
+struct RttClassLimits {
+  uint32_t initial_ms;  // before the first sample (the former fixed timeout)
+  uint32_t floor_ms;
+  uint32_t ceiling_ms;
+};
+
+static const uint32_t RTT_MIN_VARIANCE_MS = 10;  // lower bound of the 4*RTTVAR term (clock granularity)
+static const uint8_t RTT_MAX_BACKOFF = 4;        // timeouts double per consecutive timeout, up to x16
+
+// Scaled like the BSD TCP timer: SRTT x8 and RTTVAR x4, in milliseconds
+struct RttClassState {
+  int32_t srtt_x8{0};
+  int32_t rttvar_x4{0};
+  uint32_t samples{0};
+  uint32_t timeouts{0};
+  uint8_t backoff{0};
+};
+
+// Per-class round-trip estimation (RFC 6298). A sample is the time from the
+// command leaving to the last response byte, less the response's own wire
+// time, so short and long reads of one class share an estimate of the panel's
+// turnaround. The timeout for an exchange adds back the wire time of the frame
+// it expects.
+class KyoRttEstimator {
+ public:
+  void sample(RttClass cls, uint32_t elapsed_ms, int bytes);
+  // The exchange got no complete answer: back off until the next good sample
+  void timed_out(RttClass cls);
+  uint32_t timeout_ms(RttClass cls, int expected_bytes) const;
+
+  const RttClassState &get(RttClass cls) const { return this->state_[cls]; }
+  static const RttClassLimits &limits(RttClass cls);
+  static uint32_t wire_ms(int bytes) { return (bytes * BYTE_TIME_US + 999) / 1000; }
+  void dump_config() const;
+
+ protected:
+  RttClassState state_[RTT_CLASS_COUNT];
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
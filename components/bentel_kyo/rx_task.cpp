@@ -0,0 +1,104 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "rx_task.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+#ifdef USE_HOST
+#include <chrono>
+#endif
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_RX = "bentel_kyo.rx_task";
+
+#ifdef USE_ESP32
+static const uint32_t RX_TASK_STACK = 2048;
+static const UBaseType_t RX_TASK_PRIORITY = 5;  // above the main loop task (1)
+#endif
+
+void KyoRxPump::drain() {
+  // Bounded like the engine's own flush loops, so a babbling line can't pin the task
+  for (int n = 0; n < 255 && this->inner_->available() > 0; n++) {
+    RxByte rx{this->clock_->millis(), this->inner_->read()};
+    if (!this->ring_.push(rx))
+      this->overflows_.fetch_add(1, std::memory_order_relaxed);
+  }
+  uint32_t depth = this->ring_.size();
+  if (depth > this->high_water_.load(std::memory_order_relaxed))
+    this->high_water_.store(depth, std::memory_order_relaxed);
+}
+
+uint8_t KyoRxPump::read() {
+  RxByte rx;
+  if (!this->ring_.pop(&rx))
+    return 0;
+  this->last_read_ms_ = rx.at_ms;
+  return rx.byte;
+}
+
+void KyoRxPump::task_entry_(void *arg) {
+  auto *pump = static_cast<KyoRxPump *>(arg);
+  // A 9600 baud byte takes 1.15ms; polling every tick keeps stamps within one byte time
+  while (pump->running_.load(std::memory_order_relaxed)) {
+    pump->drain();
+#ifdef USE_ESP32
+    vTaskDelay(1);
+#elif defined(USE_HOST)
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+#endif
+  }
+#ifdef USE_ESP32
+  vTaskDelete(nullptr);
+#endif
+}
+
+bool KyoRxPump::start() {
+  if (this->inner_ == nullptr || this->clock_ == nullptr || this->is_running())
+    return false;
+  this->running_.store(true);
+#ifdef USE_ESP32
+  TaskHandle_t handle = nullptr;
+#if portNUM_PROCESSORS > 1
+  BaseType_t core = 1 - xPortGetCoreID();  // the core the main loop isn't on
+  BaseType_t ok = xTaskCreatePinnedToCore(task_entry_, "kyo_rx", RX_TASK_STACK, this, RX_TASK_PRIORITY, &handle, core);
+  ESP_LOGD(TAG_RX, "RX task on core %d", (int) core);
+#else
+  BaseType_t ok = xTaskCreate(task_entry_, "kyo_rx", RX_TASK_STACK, this, RX_TASK_PRIORITY, &handle);
+#endif
+  if (ok != pdPASS) {
+    this->running_.store(false);
+    ESP_LOGE(TAG_RX, "Cannot create RX task");
+    return false;
+  }
+  return true;
+#elif defined(USE_HOST)
+  this->thread_ = std::thread(task_entry_, this);
+  return true;
+#else
+  this->running_.store(false);
+  ESP_LOGE(TAG_RX, "RX task not supported on this platform");
+  return false;
+#endif
+}
+
+void KyoRxPump::stop() {
+#ifdef USE_HOST
+  this->running_.store(false);
+  if (this->thread_.joinable())
+    this->thread_.join();
+#endif
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
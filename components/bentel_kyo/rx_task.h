@@ -0,0 +1,120 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "clock.h"
+#include "transport.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_HOST
+#include <thread>
+#endif
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Lock-free single-producer/single-consumer ring: push() from one thread,
+// pop() from one other thread. N must be a power of two; one slot is kept
+// free to tell full from empty.
+template<typename T, size_t N> class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+ public:
+  bool push(const T &item) {
+    size_t head = this->head_.load(std::memory_order_relaxed);
+    size_t next = (head + 1) & (N - 1);
+    if (next == this->tail_.load(std::memory_order_acquire))
+      return false;
+    this->items_[head] = item;
+    this->head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T *out) {
+    size_t tail = this->tail_.load(std::memory_order_relaxed);
+    if (tail == this->head_.load(std::memory_order_acquire))
+      return false;
+    *out = this->items_[tail];
+    this->tail_.store((tail + 1) & (N - 1), std::memory_order_release);
+    return true;
+  }
+
+  // Exact on the consumer side, a lower bound on the producer side
+  size_t size() const {
+    return (this->head_.load(std::memory_order_acquire) - this->tail_.load(std::memory_order_acquire)) & (N - 1);
+  }
+  static constexpr size_t capacity() { return N - 1; }
+
+ protected:
+  T items_[N];
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+// A byte and the millis() at which the RX task took it off the line
+struct RxByte {
+  uint32_t at_ms;
+  uint8_t byte;
+};
+
+static const size_t RX_RING_SIZE = 256;  // ~270ms of line time at 9600 baud
+
+// Drains the panel line on a task of its own (FreeRTOS on ESP32, pinned to
+// the core the main loop isn't on; std::thread on the host) into an SPSC ring
+// of timestamped bytes. The engine reads through it like any transport, and
+// takes each byte's arrival time from the stamp instead of from when the main
+// loop got round to it, so round-trip times and the end-of-frame silence no
+// longer depend on how long other components held the loop. Parsing and
+// publishing stay on the main loop, where the entities live.
+class KyoRxPump : public KyoTransport {
+ public:
+  ~KyoRxPump() override { this->stop(); }
+
+  void set_inner(KyoTransport *inner) { this->inner_ = inner; }
+  void set_clock(KyoClock *clock) { this->clock_ = clock; }
+
+  bool start();
+  // Host only: the ESP32 task runs for the life of the device
+  void stop();
+  bool is_running() const { return this->running_.load(std::memory_order_relaxed); }
+
+  // One pass of the task: move whatever the line has into the ring
+  void drain();
+
+  // Engine side (main loop). Writes go straight to the line.
+  int available() override { return (int) this->ring_.size(); }
+  uint8_t read() override;
+  void write_array(const uint8_t *data, size_t len) override { this->inner_->write_array(data, len); }
+
+  // Arrival time of the last byte read()
+  uint32_t last_read_ms() const { return this->last_read_ms_; }
+  uint32_t get_overflows() const { return this->overflows_.load(std::memory_order_relaxed); }
+  uint32_t get_high_water() const { return this->high_water_.load(std::memory_order_relaxed); }
+
+ protected:
+  static void task_entry_(void *arg);
+
+  KyoTransport *inner_{nullptr};
+  KyoClock *clock_{nullptr};
+  SpscRing<RxByte, RX_RING_SIZE> ring_;
+  uint32_t last_read_ms_{0};
+  std::atomic<bool> running_{false};
+  std::atomic<uint32_t> overflows_{0};   // bytes dropped on a full ring
+  std::atomic<uint32_t> high_water_{0};  // deepest the ring has been
+#ifdef USE_HOST
+  std::thread thread_;
+#endif
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,236 @@
+"""Bentel KYO sensor platform — runtime bus and poll-loop metrics."""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
+    UNIT_SECOND,
+)
+
+from . import bentel_kyo_ns, BentelKyo, CONF_BENTEL_KYO_ID
+
+DEPENDENCIES = ["bentel_kyo"]
+
+CONF_POLL_RTT = "poll_rtt"
+CONF_POLL_RTT_MIN = "poll_rtt_min"
+CONF_POLL_RTT_MAX = "poll_rtt_max"
+CONF_POLL_RTT_AVG = "poll_rtt_avg"
+CONF_POLLS_PER_MINUTE = "polls_per_minute"
+CONF_TIMEOUTS = "timeouts"
+CONF_LENGTH_ERRORS = "length_errors"
+CONF_CHECKSUM_ERRORS = "checksum_errors"
+CONF_BYTES_TX = "bytes_tx"
+CONF_BYTES_RX = "bytes_rx"
+CONF_CACHE_HIT_RATE = "cache_hit_rate"
+CONF_PUBLISHES_PER_MINUTE = "publishes_per_minute"
+CONF_BLOCKED_TIME = "blocked_time"
+CONF_RECOVERIES = "recoveries"
+CONF_MEAN_TIME_TO_RECOVERY = "mean_time_to_recovery"
+CONF_SUPPRESSED_TRANSITIONS = "suppressed_transitions"
+CONF_OPERATION = "operation"
+CONF_ZONE_STATS = "zone_stats"
+CONF_ZONE = "zone"
+CONF_ACTIVATIONS = "activations"
+CONF_OPEN_TIME = "open_time"
+CONF_LAST_CHANGE = "last_change"
+CONF_TAMPER_EVENTS = "tamper_events"
+
+UNIT_BYTES = "B"
+UNIT_PER_MINUTE = "/min"
+
+MetricSensorType = bentel_kyo_ns.enum("MetricSensorType")
+ZoneStatType = bentel_kyo_ns.enum("ZoneStatType")
+
+# Error counters can be kept per bus operation or summed over all of them
+OPERATIONS = {
+    "all": 0xFF,
+    "version": 0,
+    "sensor_status": 1,
+    "partition_status": 2,
+    "blocking": 3,
+    "probe": 4,
+}
+
+RTT_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    accuracy_decimals=0,
+    icon="mdi:timer-sync-outline",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+RATE_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_PER_MINUTE,
+    state_class=STATE_CLASS_MEASUREMENT,
+    accuracy_decimals=0,
+    icon="mdi:speedometer",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+ERROR_COUNTER_SCHEMA = sensor.sensor_schema(
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    accuracy_decimals=0,
+    icon="mdi:alert-circle-outline",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+).extend(
+    {
+        cv.Optional(CONF_OPERATION, default="all"): cv.enum(OPERATIONS, lower=True),
+    }
+)
+
+BYTES_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_BYTES,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    accuracy_decimals=0,
+    icon="mdi:swap-horizontal",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+RECOVERIES_SCHEMA = sensor.sensor_schema(
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    accuracy_decimals=0,
+    icon="mdi:lan-connect",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+MTTR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    accuracy_decimals=0,
+    icon="mdi:timer-refresh-outline",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+SUPPRESSED_SCHEMA = sensor.sensor_schema(
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    accuracy_decimals=0,
+    icon="mdi:filter-outline",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+PERCENT_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_PERCENT,
+    state_class=STATE_CLASS_MEASUREMENT,
+    accuracy_decimals=1,
+    icon="mdi:percent",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+# Per-zone activity, counted on the hub and published with the metrics
+ZONE_STATS_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ZONE): cv.int_range(min=1, max=32),
+        cv.Optional(CONF_ACTIVATIONS): sensor.sensor_schema(
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            accuracy_decimals=0,
+            icon="mdi:counter",
+        ),
+        cv.Optional(CONF_OPEN_TIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_SECOND,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            accuracy_decimals=0,
+            icon="mdi:timer-outline",
+        ),
+        cv.Optional(CONF_LAST_CHANGE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_SECOND,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            accuracy_decimals=0,
+            icon="mdi:history",
+        ),
+        cv.Optional(CONF_TAMPER_EVENTS): sensor.sensor_schema(
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            accuracy_decimals=0,
+            icon="mdi:shield-alert",
+        ),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_BENTEL_KYO_ID): cv.use_id(BentelKyo),
+        cv.Optional(CONF_POLL_RTT): RTT_SCHEMA,
+        cv.Optional(CONF_POLL_RTT_MIN): RTT_SCHEMA,
+        cv.Optional(CONF_POLL_RTT_MAX): RTT_SCHEMA,
+        cv.Optional(CONF_POLL_RTT_AVG): RTT_SCHEMA,
+        cv.Optional(CONF_POLLS_PER_MINUTE): RATE_SCHEMA,
+        cv.Optional(CONF_TIMEOUTS): cv.ensure_list(ERROR_COUNTER_SCHEMA),
+        cv.Optional(CONF_LENGTH_ERRORS): cv.ensure_list(ERROR_COUNTER_SCHEMA),
+        cv.Optional(CONF_CHECKSUM_ERRORS): cv.ensure_list(ERROR_COUNTER_SCHEMA),
+        cv.Optional(CONF_BYTES_TX): BYTES_SCHEMA,
+        cv.Optional(CONF_BYTES_RX): BYTES_SCHEMA,
+        cv.Optional(CONF_CACHE_HIT_RATE): PERCENT_SCHEMA,
+        cv.Optional(CONF_PUBLISHES_PER_MINUTE): RATE_SCHEMA,
+        cv.Optional(CONF_BLOCKED_TIME): PERCENT_SCHEMA,
+        cv.Optional(CONF_RECOVERIES): RECOVERIES_SCHEMA,
+        cv.Optional(CONF_MEAN_TIME_TO_RECOVERY): MTTR_SCHEMA,
+        cv.Optional(CONF_SUPPRESSED_TRANSITIONS): SUPPRESSED_SCHEMA,
+        cv.Optional(CONF_ZONE_STATS): cv.ensure_list(ZONE_STATS_SCHEMA),
+    }
+)
+
+METRIC_TYPES = {
+    CONF_POLL_RTT: "METRIC_POLL_RTT",
+    CONF_POLL_RTT_MIN: "METRIC_POLL_RTT_MIN",
+    CONF_POLL_RTT_MAX: "METRIC_POLL_RTT_MAX",
+    CONF_POLL_RTT_AVG: "METRIC_POLL_RTT_AVG",
+    CONF_POLLS_PER_MINUTE: "METRIC_POLLS_PER_MINUTE",
+    CONF_BYTES_TX: "METRIC_BYTES_TX",
+    CONF_BYTES_RX: "METRIC_BYTES_RX",
+    CONF_CACHE_HIT_RATE: "METRIC_CACHE_HIT_RATE",
+    CONF_PUBLISHES_PER_MINUTE: "METRIC_PUBLISHES_PER_MINUTE",
+    CONF_BLOCKED_TIME: "METRIC_BLOCKED_TIME",
+    CONF_RECOVERIES: "METRIC_RECOVERIES",
+    CONF_MEAN_TIME_TO_RECOVERY: "METRIC_MEAN_TIME_TO_RECOVERY",
+    CONF_SUPPRESSED_TRANSITIONS: "METRIC_SUPPRESSED_TRANSITIONS",
+}
+
+ZONE_STAT_TYPES = {
+    CONF_ACTIVATIONS: "ZONE_STAT_ACTIVATIONS",
+    CONF_OPEN_TIME: "ZONE_STAT_OPEN_TIME",
+    CONF_LAST_CHANGE: "ZONE_STAT_LAST_CHANGE",
+    CONF_TAMPER_EVENTS: "ZONE_STAT_TAMPER_EVENTS",
+}
+
+ERROR_METRIC_TYPES = {
+    CONF_TIMEOUTS: "METRIC_TIMEOUTS",
+    CONF_LENGTH_ERRORS: "METRIC_LENGTH_ERRORS",
+    CONF_CHECKSUM_ERRORS: "METRIC_CHECKSUM_ERRORS",
+}
+
+
+async def to_code(config):
+    hub = await cg.get_variable(config[CONF_BENTEL_KYO_ID])
+
+    for conf_key, type_str in METRIC_TYPES.items():
+        if conf_key in config:
+            var = await sensor.new_sensor(config[conf_key])
+            cg.add(hub.register_metric_sensor(var, getattr(MetricSensorType, type_str)))
+
+    for conf_key, type_str in ERROR_METRIC_TYPES.items():
+        if conf_key in config:
+            for counter_conf in config[conf_key]:
+                var = await sensor.new_sensor(counter_conf)
+                cg.add(
+                    hub.register_metric_sensor(
+                        var, getattr(MetricSensorType, type_str), counter_conf[CONF_OPERATION]
+                    )
+                )
+
+    if CONF_ZONE_STATS in config:
+        cg.add_define("USE_BENTEL_KYO_ZONE_STATS")
+        for zone_conf in config[CONF_ZONE_STATS]:
+            zone_index = zone_conf[CONF_ZONE] - 1  # 0-based
+            for conf_key, type_str in ZONE_STAT_TYPES.items():
+                if conf_key in zone_conf:
+                    var = await sensor.new_sensor(zone_conf[conf_key])
+                    cg.add(hub.register_zone_stat_sensor(var, getattr(ZoneStatType, type_str), zone_index))
@@ -25,6 +25,25 @@ CONF_PANEL_MODE_RAW = "panel_mode_raw"
 CONF_STATUS_FLAGS_RAW = "status_flags_raw"
 
 TextSensorType = bentel_kyo_ns.enum("TextSensorType")
+MaskSensorType = bentel_kyo_ns.enum("MaskSensorType")
+
+# Packed state, hex: one entity per mask instead of one binary sensor per bit
+MASK_SENSORS = {
+    "zone_open_mask": (MaskSensorType.MASK_ZONE_OPEN, "mdi:shield-home"),
+    "zone_tamper_mask": (MaskSensorType.MASK_ZONE_TAMPER, "mdi:shield-alert"),
+    "zone_bypass_mask": (MaskSensorType.MASK_ZONE_BYPASS, "mdi:shield-off"),
+    "zone_alarm_memory_mask": (MaskSensorType.MASK_ZONE_ALARM_MEMORY, "mdi:alarm-light"),
+    "zone_tamper_memory_mask": (MaskSensorType.MASK_ZONE_TAMPER_MEMORY, "mdi:alarm-light"),
+    "partition_alarm_mask": (MaskSensorType.MASK_PARTITION_ALARM, "mdi:bell-ring"),
+    "partition_armed_total_mask": (MaskSensorType.MASK_PARTITION_ARMED_TOTAL, "mdi:shield-lock"),
+    "partition_armed_partial_mask": (MaskSensorType.MASK_PARTITION_ARMED_PARTIAL, "mdi:shield-half-full"),
+    "partition_armed_partial_delay0_mask": (
+        MaskSensorType.MASK_PARTITION_ARMED_PARTIAL_DELAY0,
+        "mdi:shield-half-full",
+    ),
+    "warnings_mask": (MaskSensorType.MASK_WARNINGS, "mdi:alert"),
+    "tampers_mask": (MaskSensorType.MASK_TAMPERS, "mdi:alert-octagon"),
+}
 
 PARTITION_NAME_SCHEMA = text_sensor.text_sensor_schema(
     icon="mdi:form-textbox",
@@ -80,6 +99,11 @@ CONFIG_SCHEMA = cv.Schema(
             entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
         ),
     }
+).extend(
+    {
+        cv.Optional(conf_key): text_sensor.text_sensor_schema(icon=icon)
+        for conf_key, (_, icon) in MASK_SENSORS.items()
+    }
 )
 
 
@@ -96,18 +120,22 @@ async def to_code(config):
         cg.add(var.set_disabled_by_default(True))
         cg.add(hub.set_alarm_model_text_sensor(var))
 
+    # The name and ESN register reads are only compiled in when published
     if CONF_KEYFOBS in config:
+        cg.add_define("USE_BENTEL_KYO_ESN")
         for keyfob_conf in config[CONF_KEYFOBS]:
             slot_index = keyfob_conf[CONF_SLOT] - 1  # 0-based
             var = await text_sensor.new_text_sensor(keyfob_conf)
             cg.add(var.set_disabled_by_default(True))
             cg.add(hub.register_text_sensor(var, TextSensorType.TEXT_KEYFOB_ESN, slot_index))
             if CONF_PANEL_NAME in keyfob_conf:
+                cg.add_define("USE_BENTEL_KYO_NAMES")
                 name_var = await text_sensor.new_text_sensor(keyfob_conf[CONF_PANEL_NAME])
                 cg.add(name_var.set_disabled_by_default(True))
                 cg.add(hub.register_text_sensor(name_var, TextSensorType.TEXT_KEYFOB_NAME, slot_index))
 
     if CONF_PARTITIONS in config:
+        cg.add_define("USE_BENTEL_KYO_NAMES")
         for part_conf in config[CONF_PARTITIONS]:
             part_index = part_conf[CONF_PARTITION] - 1  # 0-based
             var = await text_sensor.new_text_sensor(part_conf)
@@ -115,6 +143,7 @@ async def to_code(config):
             cg.add(hub.register_text_sensor(var, TextSensorType.TEXT_PARTITION_NAME, part_index))
 
     if CONF_CODES in config:
+        cg.add_define("USE_BENTEL_KYO_NAMES")
         for code_conf in config[CONF_CODES]:
             code_index = code_conf[CONF_CODE] - 1  # 0-based
             var = await text_sensor.new_text_sensor(code_conf)
@@ -130,3 +159,8 @@ async def to_code(config):
         var = await text_sensor.new_text_sensor(config[CONF_STATUS_FLAGS_RAW])
         cg.add(var.set_disabled_by_default(True))
         cg.add(hub.register_text_sensor(var, TextSensorType.TEXT_STATUS_FLAGS_RAW, 0))
+
+    for conf_key, (mask_type, _) in MASK_SENSORS.items():
+        if conf_key in config:
+            var = await text_sensor.new_text_sensor(config[conf_key])
+            cg.add(hub.register_mask_sensor(var, mask_type))
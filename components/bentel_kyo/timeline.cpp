@@ -0,0 +1,134 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "timeline.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_TIMELINE = "bentel_kyo.timeline";
+
+static const char *transition_name(uint8_t kind) {
+  switch (kind) {
+    case TRANSITION_OPEN: return "open";
+    case TRANSITION_CLOSE: return "closed";
+    case TRANSITION_TAMPER: return "tamper";
+    case TRANSITION_TAMPER_END: return "tamper cleared";
+    case TRANSITION_ALARM_MEMORY: return "alarm memory";
+    case TRANSITION_TAMPER_MEMORY: return "tamper memory";
+    case TRANSITION_PULSE: return "opened and closed between polls";
+    case TRANSITION_TAMPER_PULSE: return "tampered between polls";
+    case TRANSITION_PARTITION_ALARM: return "alarm";
+    case TRANSITION_PARTITION_ALARM_END: return "alarm cleared";
+    default: return "?";
+  }
+}
+
+void KyoTimeline::on_sensor_frame(uint32_t open_mask, uint32_t tamper_mask, uint8_t partition_alarm,
+                                  uint32_t now_ms) {
+  if (!this->sensor_primed_) {
+    this->sensor_primed_ = true;
+    this->open_mask_ = this->seen_open_ = open_mask;
+    this->tamper_mask_ = this->seen_tamper_ = tamper_mask;
+    this->partition_alarm_ = partition_alarm;
+    return;
+  }
+
+  // Pulses first: they happened before anything this frame shows
+  this->record_bits_(this->pending_pulse_ & ~open_mask, this->pending_ms_, TRANSITION_PULSE);
+  this->record_bits_(this->pending_tamper_pulse_ & ~tamper_mask, this->pending_ms_, TRANSITION_TAMPER_PULSE);
+  this->pending_pulse_ = 0;
+  this->pending_tamper_pulse_ = 0;
+
+  this->record_bits_(open_mask & ~this->open_mask_, now_ms, TRANSITION_OPEN);
+  this->record_bits_(this->open_mask_ & ~open_mask, now_ms, TRANSITION_CLOSE);
+  this->record_bits_(tamper_mask & ~this->tamper_mask_, now_ms, TRANSITION_TAMPER);
+  this->record_bits_(this->tamper_mask_ & ~tamper_mask, now_ms, TRANSITION_TAMPER_END);
+  this->record_bits_(partition_alarm & ~this->partition_alarm_, now_ms, TRANSITION_PARTITION_ALARM);
+  this->record_bits_(this->partition_alarm_ & ~partition_alarm, now_ms, TRANSITION_PARTITION_ALARM_END);
+
+  this->open_mask_ = open_mask;
+  this->tamper_mask_ = tamper_mask;
+  this->partition_alarm_ = partition_alarm;
+  this->seen_open_ |= open_mask;
+  this->seen_tamper_ |= tamper_mask;
+}
+
+void KyoTimeline::on_partition_frame(uint32_t alarm_memory, uint32_t tamper_memory, uint32_t now_ms) {
+  if (!this->partition_primed_) {
+    this->partition_primed_ = true;
+    this->alarm_memory_ = alarm_memory;
+    this->tamper_memory_ = tamper_memory;
+    return;
+  }
+
+  uint32_t alarm_latched = alarm_memory & ~this->alarm_memory_;
+  uint32_t tamper_latched = tamper_memory & ~this->tamper_memory_;
+  this->record_bits_(alarm_latched, now_ms, TRANSITION_ALARM_MEMORY);
+  this->record_bits_(tamper_latched, now_ms, TRANSITION_TAMPER_MEMORY);
+  if ((alarm_latched & ~this->seen_open_) | (tamper_latched & ~this->seen_tamper_)) {
+    this->pending_pulse_ |= alarm_latched & ~this->seen_open_;
+    this->pending_tamper_pulse_ |= tamper_latched & ~this->seen_tamper_;
+    this->pending_ms_ = now_ms;
+  }
+
+  this->alarm_memory_ = alarm_memory;
+  this->tamper_memory_ = tamper_memory;
+  this->seen_open_ = this->open_mask_;
+  this->seen_tamper_ = this->tamper_mask_;
+}
+
+void KyoTimeline::record_bits_(uint32_t bits, uint32_t ms, TransitionKind kind) {
+  for (uint8_t i = 0; bits != 0; i++, bits >>= 1) {
+    if (bits & 1)
+      this->record(ms, kind, i);
+  }
+}
+
+void KyoTimeline::record(uint32_t ms, TransitionKind kind, uint8_t index) {
+  size_t pos = (this->head_ + this->count_) % TIMELINE_SIZE;
+  if (this->count_ == TIMELINE_SIZE) {
+    this->head_ = (this->head_ + 1) % TIMELINE_SIZE;
+    this->overwritten_++;
+  } else {
+    this->count_++;
+  }
+  this->entries_[pos] = {ms, index, (uint8_t) kind};
+  this->recorded_++;
+}
+
+void KyoTimeline::clear() {
+  this->head_ = 0;
+  this->count_ = 0;
+}
+
+bool KyoTimeline::next(size_t *cursor, KyoTransition *out) const {
+  if (*cursor >= this->count_)
+    return false;
+  *out = this->entries_[(this->head_ + *cursor) % TIMELINE_SIZE];
+  (*cursor)++;
+  return true;
+}
+
+void KyoTimeline::dump(uint32_t now_ms) const {
+  ESP_LOGI(TAG_TIMELINE, "Transition timeline: %u entries, %u recorded, %u overwritten", (unsigned) this->count_,
+           (unsigned) this->recorded_, (unsigned) this->overwritten_);
+  size_t cursor = 0;
+  KyoTransition entry;
+  while (this->next(&cursor, &entry)) {
+    bool partition = entry.kind == TRANSITION_PARTITION_ALARM || entry.kind == TRANSITION_PARTITION_ALARM_END;
+    uint32_t age_ms = now_ms - entry.ms;
+    ESP_LOGI(TAG_TIMELINE, "  %6u.%03us (-%u.%03us) %s %2u %s", (unsigned) (entry.ms / 1000),
+             (unsigned) (entry.ms % 1000), (unsigned) (age_ms / 1000), (unsigned) (age_ms % 1000),
+             partition ? "partition" : "zone", (unsigned) entry.index + 1, transition_name(entry.kind));
+  }
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
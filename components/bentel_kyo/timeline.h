@@ -0,0 +1,94 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Ring size in entries, set from the timeline: block by codegen
+#ifndef BENTEL_KYO_TIMELINE_SIZE
+#define BENTEL_KYO_TIMELINE_SIZE 64
+#endif
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const size_t TIMELINE_SIZE = BENTEL_KYO_TIMELINE_SIZE;
+
+enum TransitionKind : uint8_t {
+  TRANSITION_OPEN = 0,
+  TRANSITION_CLOSE,
+  TRANSITION_TAMPER,
+  TRANSITION_TAMPER_END,
+  TRANSITION_ALARM_MEMORY,   // panel latched an alarm for the zone
+  TRANSITION_TAMPER_MEMORY,  // panel latched a tamper for the zone
+  TRANSITION_PULSE,          // alarm memory without the zone ever seen open: opened and closed between polls
+  TRANSITION_TAMPER_PULSE,   // same for a tamper
+  TRANSITION_PARTITION_ALARM,
+  TRANSITION_PARTITION_ALARM_END,
+};
+
+struct KyoTransition {
+  uint32_t ms;    // hub uptime when the frame showing it was decoded
+  uint8_t index;  // 0-based zone, or partition for the partition kinds
+  uint8_t kind;   // TransitionKind
+};
+
+// Zone and partition transitions in the order the hub saw them, in a fixed
+// ring that overwrites the oldest entry. Fed by the bit diff of each changed
+// status frame, so ordering is at poll resolution. A zone whose alarm or
+// tamper memory is latched without the zone having been seen active is
+// recorded as a pulse: the decision waits for the next sensor frame, so a
+// zone that opened between the two frames of a cycle is not mistaken for one.
+class KyoTimeline {
+ public:
+  void on_sensor_frame(uint32_t open_mask, uint32_t tamper_mask, uint8_t partition_alarm, uint32_t now_ms);
+  void on_partition_frame(uint32_t alarm_memory, uint32_t tamper_memory, uint32_t now_ms);
+  void record(uint32_t ms, TransitionKind kind, uint8_t index);
+  void clear();
+
+  // Walks the entries oldest first; *cursor starts at 0
+  bool next(size_t *cursor, KyoTransition *out) const;
+  size_t size() const { return this->count_; }
+  uint32_t recorded() const { return this->recorded_; }
+  uint32_t overwritten() const { return this->overwritten_; }
+  // A pulse is waiting on the next sensor frame
+  bool has_pending() const { return (this->pending_pulse_ | this->pending_tamper_pulse_) != 0; }
+
+  void dump(uint32_t now_ms) const;
+
+ protected:
+  void record_bits_(uint32_t bits, uint32_t ms, TransitionKind kind);
+
+  KyoTransition entries_[TIMELINE_SIZE]{};
+  size_t head_{0};  // oldest entry
+  size_t count_{0};
+  uint32_t recorded_{0};
+  uint32_t overwritten_{0};
+
+  bool sensor_primed_{false};
+  bool partition_primed_{false};
+  uint32_t open_mask_{0};
+  uint32_t tamper_mask_{0};
+  uint8_t partition_alarm_{0};
+  uint32_t alarm_memory_{0};
+  uint32_t tamper_memory_{0};
+  // Active at any sensor frame since the last partition frame
+  uint32_t seen_open_{0};
+  uint32_t seen_tamper_{0};
+  // Memory latched for a zone not seen active, settled by the next sensor frame
+  uint32_t pending_pulse_{0};
+  uint32_t pending_tamper_pulse_{0};
+  uint32_t pending_ms_{0};
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,125 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "trace.h"
+#include "esphome/core/log.h"
+
+#include <cstdio>
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_TRACE = "bentel_kyo.trace";
+
+void KyoTraceRing::record(uint32_t now_us, bool rx, uint8_t op, const uint8_t *data, int len) {
+  // Track wraps even while frozen so timestamps stay monotonic afterwards
+  if (now_us < this->last_us_)
+    this->wrap_us_ += 1ULL << 32;
+  this->last_us_ = now_us;
+  if (this->frozen_)
+    return;
+
+  if (len < 0)
+    len = 0;
+  if (len > 255)
+    len = 255;
+  size_t need = TRACE_HEADER_SIZE + len;
+  if (need > TRACE_BUFFER_SIZE)
+    return;
+  while (TRACE_BUFFER_SIZE - this->used_ < need)
+    this->evict_oldest_();
+
+  uint64_t t = this->wrap_us_ + now_us;
+  size_t pos = (this->head_ + this->used_) % TRACE_BUFFER_SIZE;
+  for (int i = 0; i < 8; i++) {
+    this->buf_[pos] = (uint8_t) (t >> (8 * i));
+    pos = (pos + 1) % TRACE_BUFFER_SIZE;
+  }
+  this->buf_[pos] = (uint8_t) ((op & 0x7F) | (rx ? TRACE_TAG_RX : 0));
+  pos = (pos + 1) % TRACE_BUFFER_SIZE;
+  this->buf_[pos] = (uint8_t) len;
+  pos = (pos + 1) % TRACE_BUFFER_SIZE;
+  for (int i = 0; i < len; i++) {
+    this->buf_[pos] = data[i];
+    pos = (pos + 1) % TRACE_BUFFER_SIZE;
+  }
+  this->used_ += need;
+  this->records_++;
+  this->newest_us_ = t;
+}
+
+void KyoTraceRing::evict_oldest_() {
+  size_t size = TRACE_HEADER_SIZE + this->at_(9);
+  this->head_ = (this->head_ + size) % TRACE_BUFFER_SIZE;
+  this->used_ -= size;
+  this->records_--;
+  this->evicted_++;
+}
+
+void KyoTraceRing::clear() {
+  this->head_ = 0;
+  this->used_ = 0;
+  this->records_ = 0;
+  this->newest_us_ = 0;
+}
+
+bool KyoTraceRing::next(size_t *cursor, TraceRecord *out) const {
+  size_t offset = *cursor;
+  if (offset + TRACE_HEADER_SIZE > this->used_)
+    return false;
+  uint64_t t = 0;
+  for (int i = 0; i < 8; i++)
+    t |= (uint64_t) this->at_(offset + i) << (8 * i);
+  uint8_t tag = this->at_(offset + 8);
+  out->time_us = t;
+  out->rx = (tag & TRACE_TAG_RX) != 0;
+  out->op = tag & 0x7F;
+  out->len = this->at_(offset + 9);
+  for (int i = 0; i < out->len; i++)
+    out->data[i] = this->at_(offset + TRACE_HEADER_SIZE + i);
+  *cursor = offset + TRACE_HEADER_SIZE + out->len;
+  return true;
+}
+
+int KyoTraceRing::format_line(char *buf, size_t size, uint32_t seq, const TraceRecord &rec, int offset) {
+  int pos = snprintf(buf, size, "KYOTRACE %u %u.%06u %s %u", (unsigned) seq, (unsigned) (rec.time_us / 1000000),
+                     (unsigned) (rec.time_us % 1000000), rec.rx ? "RX" : "TX", (unsigned) rec.op);
+  int end = offset + TRACE_LINE_BYTES < rec.len ? offset + TRACE_LINE_BYTES : rec.len;
+  for (int i = offset; i < end && pos > 0 && pos < (int) size; i++)
+    pos += snprintf(buf + pos, size - pos, " %02x", rec.data[i]);
+  return pos;
+}
+
+void KyoTraceRing::dump(uint32_t window_ms) const {
+  uint64_t window_us = (uint64_t) window_ms * 1000;
+  uint64_t cutoff = window_ms > 0 && this->newest_us_ > window_us ? this->newest_us_ - window_us : 0;
+  ESP_LOGI(TAG_TRACE, "KYOTRACE-BEGIN records=%u evicted=%u bytes=%u/%u window=%ums%s", (unsigned) this->records_,
+           (unsigned) this->evicted_, (unsigned) this->used_, (unsigned) TRACE_BUFFER_SIZE, (unsigned) window_ms,
+           this->frozen_ ? " frozen" : "");
+
+  // Static: a full frame does not belong on the loop task's stack
+  static TraceRecord rec;
+  char line[64 + 3 * TRACE_LINE_BYTES];
+  size_t cursor = 0;
+  uint32_t seq = 0;
+  while (this->next(&cursor, &rec)) {
+    if (rec.time_us < cutoff)
+      continue;
+    seq++;
+    int offset = 0;
+    do {
+      format_line(line, sizeof(line), seq, rec, offset);
+      ESP_LOGI(TAG_TRACE, "%s", line);
+      offset += TRACE_LINE_BYTES;
+    } while (offset < rec.len);
+  }
+  ESP_LOGI(TAG_TRACE, "KYOTRACE-END frames=%u", (unsigned) seq);
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,82 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Ring size in bytes, set from the trace: block by codegen
+#ifndef BENTEL_KYO_TRACE_BUFFER_SIZE
+#define BENTEL_KYO_TRACE_BUFFER_SIZE 4096
+#endif
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Raw frame trace. Every frame put on or taken off the bus is stored in a
+// fixed byte ring as [time_us:8][tag:1][len:1][bytes:len]; the oldest records
+// are evicted to make room, so the ring always holds the latest traffic and
+// never allocates. The dump is line based ("KYOTRACE <seq> <s.us> TX|RX <op>
+// <hex>") so tools/bentel-usb-extract.py can read it straight from a log.
+static const size_t TRACE_BUFFER_SIZE = BENTEL_KYO_TRACE_BUFFER_SIZE;
+static const size_t TRACE_HEADER_SIZE = 10;
+static const uint8_t TRACE_TAG_RX = 0x80;  // tag bit: frame came from the panel
+static const int TRACE_LINE_BYTES = 32;    // frame bytes per dump line (logger line limit)
+
+struct TraceRecord {
+  uint64_t time_us{0};
+  bool rx{false};
+  uint8_t op{0};  // MetricOp of the exchange
+  uint8_t len{0};
+  uint8_t data[255];
+};
+
+class KyoTraceRing {
+ public:
+  // now_us is the raw 32-bit micros() value; wraps are folded into 64 bits
+  void record(uint32_t now_us, bool rx, uint8_t op, const uint8_t *data, int len);
+  void clear();
+
+  // A frozen ring keeps its contents and ignores new frames
+  void set_frozen(bool frozen) { this->frozen_ = frozen; }
+  bool is_frozen() const { return this->frozen_; }
+
+  // Walks the records oldest first; *cursor starts at 0
+  bool next(size_t *cursor, TraceRecord *out) const;
+  // Time of the newest record (0 when empty)
+  uint64_t newest_us() const { return this->newest_us_; }
+
+  size_t used_bytes() const { return this->used_; }
+  uint32_t records() const { return this->records_; }
+  uint32_t evicted() const { return this->evicted_; }
+
+  // Logs the records of the last window_ms (all of them when 0) as KYOTRACE lines
+  void dump(uint32_t window_ms) const;
+  // One dump line holding up to TRACE_LINE_BYTES frame bytes from offset
+  static int format_line(char *buf, size_t size, uint32_t seq, const TraceRecord &rec, int offset);
+
+ protected:
+  uint8_t at_(size_t offset) const { return this->buf_[(this->head_ + offset) % TRACE_BUFFER_SIZE]; }
+  void evict_oldest_();
+
+  uint8_t buf_[TRACE_BUFFER_SIZE];
+  size_t head_{0};  // offset of the oldest record
+  size_t used_{0};
+  uint32_t records_{0};
+  uint32_t evicted_{0};
+  uint64_t newest_us_{0};
+  uint64_t wrap_us_{0};  // accumulated micros() wraps
+  uint32_t last_us_{0};
+  bool frozen_{false};
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
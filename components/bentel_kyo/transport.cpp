@@ -0,0 +1,165 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "transport.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_HOST
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_TRANSPORT = "bentel_kyo.transport";
+
+// ========================================
+// Loopback
+// ========================================
+
+uint8_t LoopbackTransport::read() {
+  if (this->head_ == this->tail_)
+    return 0;
+  uint8_t byte = this->buf_[this->tail_];
+  this->tail_ = (this->tail_ + 1) % BUFFER_SIZE;
+  return byte;
+}
+
+void LoopbackTransport::push_(uint8_t byte) {
+  size_t next = (this->head_ + 1) % BUFFER_SIZE;
+  if (next == this->tail_) {
+    this->dropped_++;
+    return;
+  }
+  this->buf_[this->head_] = byte;
+  this->head_ = next;
+}
+
+void LoopbackTransport::write_array(const uint8_t *data, size_t len) {
+  if (this->peer_ == nullptr)
+    return;
+  for (size_t i = 0; i < len; i++)
+    this->peer_->push_(data[i]);
+}
+
+void LoopbackTransport::inject(const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    this->push_(data[i]);
+}
+
+#ifdef USE_HOST
+// ========================================
+// POSIX serial device / pty
+// ========================================
+
+static speed_t baud_to_speed(uint32_t baud_rate) {
+  switch (baud_rate) {
+    case 1200: return B1200;
+    case 2400: return B2400;
+    case 4800: return B4800;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    default: return B9600;
+  }
+}
+
+bool SerialFdTransport::open_device(const char *path, uint32_t baud_rate) {
+  this->close();
+  this->fd_ = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (this->fd_ < 0) {
+    ESP_LOGE(TAG_TRANSPORT, "Cannot open %s: %s", path, strerror(errno));
+    return false;
+  }
+
+  // Raw 8E1, matching the panel's RS-232 settings
+  struct termios tio {};
+  tcgetattr(this->fd_, &tio);
+  cfmakeraw(&tio);
+  tio.c_cflag |= (CLOCAL | CREAD | PARENB);
+  tio.c_cflag &= ~(PARODD | CSTOPB | CSIZE);
+  tio.c_cflag |= CS8;
+  cfsetispeed(&tio, baud_to_speed(baud_rate));
+  cfsetospeed(&tio, baud_to_speed(baud_rate));
+  tcsetattr(this->fd_, TCSANOW, &tio);
+
+  strncpy(this->slave_name_, path, sizeof(this->slave_name_) - 1);
+  ESP_LOGI(TAG_TRANSPORT, "Opened serial device %s at %u baud", path, (unsigned) baud_rate);
+  return true;
+}
+
+bool SerialFdTransport::open_pty() {
+  this->close();
+  this->fd_ = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (this->fd_ < 0 || grantpt(this->fd_) != 0 || unlockpt(this->fd_) != 0) {
+    ESP_LOGE(TAG_TRANSPORT, "Cannot create pty: %s", strerror(errno));
+    this->close();
+    return false;
+  }
+
+  // Keep the line raw so protocol bytes pass through untouched
+  struct termios tio {};
+  tcgetattr(this->fd_, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(this->fd_, TCSANOW, &tio);
+
+  if (ptsname_r(this->fd_, this->slave_name_, sizeof(this->slave_name_)) != 0)
+    this->slave_name_[0] = '\0';
+  ESP_LOGI(TAG_TRANSPORT, "Panel side of pty: %s", this->slave_name_);
+  return true;
+}
+
+void SerialFdTransport::close() {
+  if (this->fd_ >= 0)
+    ::close(this->fd_);
+  this->fd_ = -1;
+  this->slave_name_[0] = '\0';
+}
+
+int SerialFdTransport::available() {
+  if (this->fd_ < 0)
+    return 0;
+  int count = 0;
+  if (ioctl(this->fd_, FIONREAD, &count) != 0)
+    return 0;
+  return count;
+}
+
+uint8_t SerialFdTransport::read() {
+  uint8_t byte = 0;
+  if (this->fd_ >= 0 && ::read(this->fd_, &byte, 1) != 1)
+    byte = 0;
+  return byte;
+}
+
+void SerialFdTransport::write_array(const uint8_t *data, size_t len) {
+  if (this->fd_ < 0)
+    return;
+  while (len > 0) {
+    ssize_t written = ::write(this->fd_, data, len);
+    if (written < 0) {
+      if (errno == EAGAIN || errno == EINTR)
+        continue;
+      ESP_LOGW(TAG_TRANSPORT, "Write failed: %s", strerror(errno));
+      return;
+    }
+    data += written;
+    len -= (size_t) written;
+  }
+}
+#endif  // USE_HOST
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,98 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "esphome/components/uart/uart.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Byte transport used by the protocol engine. The ESPHome UART is the
+// production backend; the loopback and serial/pty backends let the engine run
+// natively on Linux against simulated or recorded panel traffic.
+class KyoTransport {
+ public:
+  virtual ~KyoTransport() = default;
+  virtual int available() = 0;
+  virtual uint8_t read() = 0;
+  virtual void write_array(const uint8_t *data, size_t len) = 0;
+};
+
+// ESPHome UART backend (default)
+class UARTTransport : public KyoTransport {
+ public:
+  explicit UARTTransport(uart::UARTDevice *device) : device_(device) {}
+
+  int available() override { return this->device_->available(); }
+  uint8_t read() override { return this->device_->read(); }
+  void write_array(const uint8_t *data, size_t len) override { this->device_->write_array(data, len); }
+
+ protected:
+  uart::UARTDevice *device_;
+};
+
+// In-memory byte pipe. Two endpoints are joined with connect(); bytes written
+// on one side become readable on the other. inject() feeds the local RX side
+// directly (recorded traffic).
+class LoopbackTransport : public KyoTransport {
+ public:
+  static const size_t BUFFER_SIZE = 512;
+
+  void connect(LoopbackTransport *peer) {
+    this->peer_ = peer;
+    peer->peer_ = this;
+  }
+
+  int available() override { return (int) ((this->head_ - this->tail_) % BUFFER_SIZE); }
+  uint8_t read() override;
+  void write_array(const uint8_t *data, size_t len) override;
+  void inject(const uint8_t *data, size_t len);
+  void clear() { this->tail_ = this->head_; }
+
+  uint32_t get_dropped() const { return this->dropped_; }
+
+ protected:
+  void push_(uint8_t byte);
+
+  uint8_t buf_[BUFFER_SIZE]{};
+  size_t head_{0};
+  size_t tail_{0};
+  uint32_t dropped_{0};  // bytes lost to a full buffer
+  LoopbackTransport *peer_{nullptr};
+};
+
+#ifdef USE_HOST
+// POSIX serial device (raw 8E1) or pseudo-terminal master. A pty lets an
+// external panel simulator or socat bridge attach to slave_name().
+class SerialFdTransport : public KyoTransport {
+ public:
+  ~SerialFdTransport() override { this->close(); }
+
+  bool open_device(const char *path, uint32_t baud_rate = 9600);
+  bool open_pty();
+  void close();
+  bool is_open() const { return this->fd_ >= 0; }
+  const char *slave_name() const { return this->slave_name_; }
+
+  int available() override;
+  uint8_t read() override;
+  void write_array(const uint8_t *data, size_t len) override;
+
+ protected:
+  int fd_{-1};
+  char slave_name_[64]{};
+};
+#endif
+
+}  // namespace bentel_kyo
+}  // namespace esphome
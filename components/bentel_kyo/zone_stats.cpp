@@ -0,0 +1,123 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "zone_stats.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_STATS = "bentel_kyo.stats";
+
+void KyoZoneStats::update(uint32_t open_mask, uint32_t tamper_mask, uint32_t now_ms) {
+  if (!this->primed_) {
+    this->primed_ = true;
+    this->open_mask_ = open_mask;
+    this->tamper_mask_ = tamper_mask;
+    for (uint8_t z = 0; z < ZONE_STATS_ZONES; z++)
+      this->opened_ms_[z] = now_ms;
+    return;
+  }
+
+  uint32_t opened = open_mask & ~this->open_mask_;
+  uint32_t closed = ~open_mask & this->open_mask_;
+  uint32_t tampered = tamper_mask & ~this->tamper_mask_;
+  if ((opened | closed | tampered) == 0) {
+    this->tamper_mask_ = tamper_mask;
+    return;
+  }
+  for (uint8_t z = 0; z < ZONE_STATS_ZONES; z++) {
+    uint32_t bit = 1UL << z;
+    if (opened & bit) {
+      this->counters_.activations[z]++;
+      this->opened_ms_[z] = now_ms;
+    } else if (closed & bit) {
+      uint32_t open_ms = now_ms - this->opened_ms_[z] + this->carry_ms_[z];
+      this->counters_.open_s[z] += open_ms / 1000;
+      this->carry_ms_[z] = open_ms % 1000;
+    }
+    if ((opened | closed) & bit)
+      this->changed_ms_[z] = now_ms;
+    if (tampered & bit)
+      this->counters_.tamper_events[z]++;
+  }
+  this->changed_mask_ |= opened | closed;
+  this->open_mask_ = open_mask;
+  this->tamper_mask_ = tamper_mask;
+  this->dirty_ = true;
+}
+
+void KyoZoneStats::flush(uint32_t now_ms) {
+  for (uint8_t z = 0; z < ZONE_STATS_ZONES; z++) {
+    if (!(this->open_mask_ & (1UL << z)))
+      continue;
+    uint32_t open_ms = now_ms - this->opened_ms_[z] + this->carry_ms_[z];
+    if (open_ms >= 1000)
+      this->dirty_ = true;
+    this->counters_.open_s[z] += open_ms / 1000;
+    this->carry_ms_[z] = open_ms % 1000;
+    this->opened_ms_[z] = now_ms;
+  }
+}
+
+void KyoZoneStats::restore(const KyoZoneCounters &saved) {
+  if (saved.version != ZONE_STATS_VERSION)
+    return;
+  this->counters_ = saved;
+}
+
+void KyoZoneStats::reset(uint32_t now_ms) {
+  this->counters_ = KyoZoneCounters{ZONE_STATS_VERSION, {}, {}, {}};
+  for (uint8_t z = 0; z < ZONE_STATS_ZONES; z++) {
+    this->opened_ms_[z] = now_ms;
+    this->carry_ms_[z] = 0;
+  }
+  this->dirty_ = true;
+}
+
+uint32_t KyoZoneStats::get_open_s(uint8_t zone, uint32_t now_ms) const {
+  uint32_t open_s = this->counters_.open_s[zone];
+  if (this->open_mask_ & (1UL << zone))
+    open_s += (now_ms - this->opened_ms_[zone] + this->carry_ms_[zone]) / 1000;
+  return open_s;
+}
+
+bool KyoZoneStats::get_since_change_ms(uint8_t zone, uint32_t now_ms, uint32_t *since_ms) const {
+  if (!(this->changed_mask_ & (1UL << zone)))
+    return false;
+  *since_ms = now_ms - this->changed_ms_[zone];
+  return true;
+}
+
+bool KyoZoneStats::take_dirty() {
+  bool dirty = this->dirty_;
+  this->dirty_ = false;
+  return dirty;
+}
+
+void KyoZoneStats::dump(uint32_t now_ms) const {
+  ESP_LOGI(TAG_STATS, "Zone activity (zones with any):");
+  for (uint8_t z = 0; z < ZONE_STATS_ZONES; z++) {
+    uint32_t open_s = this->get_open_s(z, now_ms);
+    if (this->counters_.activations[z] == 0 && this->counters_.tamper_events[z] == 0 && open_s == 0)
+      continue;
+    uint32_t since_ms;
+    if (this->get_since_change_ms(z, now_ms, &since_ms)) {
+      ESP_LOGI(TAG_STATS, "  Zone %2u: %u activations, open %us, %u tamper events, last change %us ago",
+               (unsigned) z + 1, (unsigned) this->counters_.activations[z], (unsigned) open_s,
+               (unsigned) this->counters_.tamper_events[z], (unsigned) (since_ms / 1000));
+    } else {
+      ESP_LOGI(TAG_STATS, "  Zone %2u: %u activations, open %us, %u tamper events", (unsigned) z + 1,
+               (unsigned) this->counters_.activations[z], (unsigned) open_s,
+               (unsigned) this->counters_.tamper_events[z]);
+    }
+  }
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
@@ -0,0 +1,67 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const uint8_t ZONE_STATS_ZONES = 32;
+static const uint8_t ZONE_STATS_VERSION = 1;
+static const char *const ZONE_STATS_KEY = "bentel_kyo_stats";
+static const uint32_t ZONE_STATS_SAVE_INTERVAL_MS = 15 * 60 * 1000;  // flash writes at most this often
+
+// Counters kept in preferences. Open time is whole seconds; the remainder of
+// a stretch stays in RAM until the next one adds to it.
+struct KyoZoneCounters {
+  uint8_t version;
+  uint32_t activations[ZONE_STATS_ZONES];    // closed -> open
+  uint32_t open_s[ZONE_STATS_ZONES];         // cumulative time open
+  uint32_t tamper_events[ZONE_STATS_ZONES];  // tamper bit set
+};
+
+// Per-zone activity from the sensor frame's zone and tamper masks, diffed on
+// every changed frame. Fixed arrays only; the first update after boot sets
+// the baseline and counts nothing.
+class KyoZoneStats {
+ public:
+  void update(uint32_t open_mask, uint32_t tamper_mask, uint32_t now_ms);
+  // Fold running open stretches into the counters (before a save)
+  void flush(uint32_t now_ms);
+  void restore(const KyoZoneCounters &saved);
+  void reset(uint32_t now_ms);
+
+  uint32_t get_activations(uint8_t zone) const { return this->counters_.activations[zone]; }
+  uint32_t get_tamper_events(uint8_t zone) const { return this->counters_.tamper_events[zone]; }
+  // Including the stretch the zone is open for right now
+  uint32_t get_open_s(uint8_t zone, uint32_t now_ms) const;
+  // Time since the zone last opened or closed; false if it has not since boot
+  bool get_since_change_ms(uint8_t zone, uint32_t now_ms, uint32_t *since_ms) const;
+
+  const KyoZoneCounters &get_counters() const { return this->counters_; }
+  // Counters changed since the last call
+  bool take_dirty();
+
+  void dump(uint32_t now_ms) const;
+
+ protected:
+  KyoZoneCounters counters_{ZONE_STATS_VERSION, {}, {}, {}};
+  bool primed_{false};
+  bool dirty_{false};
+  uint32_t open_mask_{0};
+  uint32_t tamper_mask_{0};
+  uint32_t changed_mask_{0};  // zones that opened or closed since boot
+  uint32_t opened_ms_[ZONE_STATS_ZONES]{};
+  uint16_t carry_ms_[ZONE_STATS_ZONES]{};  // open time below a second, not yet counted
+  uint32_t changed_ms_[ZONE_STATS_ZONES]{};
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
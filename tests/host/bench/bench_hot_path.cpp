@@ -0,0 +1,283 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Microbenchmarks for the work done on every 500ms poll: response parsing
+// (changed frames and the memcmp cache hit), entity publishing, checksums and
+// event decoding. Host numbers are not ESP32 numbers, but ratios and
+// regressions carry over.
+//
+//   bench_hot_path --benchmark_format=json --benchmark_out=bench.json
+
+#include "alarm_control_panel.h"
+#include "test_kyo.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+class BenchKyo : public TestKyo {
+ public:
+  using BentelKyo::calculate_checksum_;
+  using BentelKyo::calculate_crc_;
+  using BentelKyo::commit_status_;
+  using BentelKyo::decode_event_code_;
+  using BentelKyo::parse_partition_status_;
+  using BentelKyo::parse_sensor_status_;
+  using BentelKyo::publish_binary_sensors_;
+  using BentelKyo::publish_text_sensors_;
+
+  void force_model(AlarmModel model) {
+    this->alarm_model_ = model;
+    this->model_detected_ = true;
+    this->max_zones_ = (model == AlarmModel::KYO_32 || model == AlarmModel::KYO_32G) ? KYO_MAX_ZONES : KYO_MAX_ZONES_8;
+  }
+  static const uint8_t *partition_command(AlarmModel model) {
+    if (model == AlarmModel::KYO_32G)
+      return CMD_GET_PARTITION_KYO32G;
+    return model == AlarmModel::KYO_32 ? CMD_GET_PARTITION_KYO32 : CMD_GET_PARTITION_KYO8;
+  }
+  static const uint8_t *sensor_command() { return CMD_GET_SENSOR_STATUS; }
+};
+
+const AlarmModel MODELS[] = {AlarmModel::KYO_4,  AlarmModel::KYO_8,  AlarmModel::KYO_8G,
+                             AlarmModel::KYO_8W, AlarmModel::KYO_32, AlarmModel::KYO_32G};
+const char *const MODEL_NAMES[] = {"KYO4", "KYO8", "KYO8G", "KYO8W", "KYO32", "KYO32G"};
+
+bool is_kyo32(AlarmModel model) { return model == AlarmModel::KYO_32 || model == AlarmModel::KYO_32G; }
+
+// Echo + data + checksum
+std::vector<uint8_t> make_frame(const uint8_t *cmd, const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> frame(cmd, cmd + 6);
+  uint8_t sum = 0;
+  for (uint8_t b : data) {
+    frame.push_back(b);
+    sum += b;
+  }
+  frame.push_back(sum);
+  return frame;
+}
+
+std::vector<uint8_t> sensor_frame(AlarmModel model, uint8_t zones) {
+  std::vector<uint8_t> data(is_kyo32(model) ? 11 : 5, 0);
+  data[is_kyo32(model) ? 3 : 0] = zones;
+  return make_frame(BenchKyo::sensor_command(), data);
+}
+
+std::vector<uint8_t> partition_frame(AlarmModel model, uint8_t armed) {
+  std::vector<uint8_t> data(is_kyo32(model) ? 19 : 10, 0);
+  data[0] = armed;
+  data[3] = (uint8_t) ~armed;
+  return make_frame(BenchKyo::partition_command(model), data);
+}
+
+// Engine with a realistic mix of entities: zones first, then partitions,
+// outputs and the panel-wide flags, like a typical YAML config
+struct Rig {
+  explicit Rig(AlarmModel model, int binary_sensors = 40, int text_sensors = 0) {
+    kyo.force_model(model);
+    static const BinarySensorType ZONE_TYPES[] = {BinarySensorType::ZONE, BinarySensorType::ZONE_TAMPER,
+                                                  BinarySensorType::ZONE_BYPASS, BinarySensorType::ZONE_ALARM_MEMORY,
+                                                  BinarySensorType::ZONE_TAMPER_MEMORY};
+    for (int i = 0; i < binary_sensors; i++) {
+      BinarySensorType type;
+      uint8_t index;
+      if (i < 5 * KYO_MAX_ZONES) {
+        type = ZONE_TYPES[i / KYO_MAX_ZONES];
+        index = i % KYO_MAX_ZONES;
+      } else {
+        int rest = i - 5 * KYO_MAX_ZONES;
+        type = (BinarySensorType) (BinarySensorType::PARTITION_ALARM + rest % 19);
+        index = rest / 19;
+      }
+      binary.emplace_back(new binary_sensor::BinarySensor());
+      kyo.register_binary_sensor(binary.back().get(), type, index);
+    }
+    for (int i = 0; i < text_sensors; i++) {
+      text.emplace_back(new text_sensor::TextSensor());
+      kyo.register_text_sensor(text.back().get(), (TextSensorType) (i / KYO_MAX_ZONES % (TEXT_STATUS_FLAGS_RAW + 1)),
+                               i % KYO_MAX_ZONES);
+    }
+    for (uint8_t p = 1; p <= KYO_MAX_PARTITIONS; p++) {
+      panels.emplace_back(new BentelKyoAlarmPanel());
+      panels.back()->set_parent(&kyo);
+      panels.back()->set_partition(p);
+      kyo.register_alarm_panel(panels.back().get());
+    }
+    // The first commit clears force_publish_, as in steady-state polling
+    auto partition = partition_frame(model, 0xFF);
+    kyo.parse_partition_status_(partition.data(), partition.size());
+    kyo.commit_status_();
+  }
+
+  BenchKyo kyo;
+  std::vector<std::unique_ptr<binary_sensor::BinarySensor>> binary;
+  std::vector<std::unique_ptr<text_sensor::TextSensor>> text;
+  std::vector<std::unique_ptr<BentelKyoAlarmPanel>> panels;
+};
+
+// ---- Response parsing ----
+
+// Every frame differs from the last: full decode + publish
+void BM_ParseSensorStatus(benchmark::State &state) {
+  AlarmModel model = MODELS[state.range(0)];
+  Rig rig(model);
+  auto a = sensor_frame(model, 0x01), b = sensor_frame(model, 0x02);
+  bool flip = false;
+  for (auto _ : state) {
+    auto &frame = (flip = !flip) ? a : b;
+    benchmark::DoNotOptimize(rig.kyo.parse_sensor_status_(frame.data(), frame.size()));
+    rig.kyo.commit_status_();
+  }
+  state.SetLabel(MODEL_NAMES[state.range(0)]);
+}
+
+// Unchanged frame: only the memcmp against the cache
+void BM_ParseSensorStatusCached(benchmark::State &state) {
+  AlarmModel model = MODELS[state.range(0)];
+  Rig rig(model);
+  auto frame = sensor_frame(model, 0x01);
+  rig.kyo.parse_sensor_status_(frame.data(), frame.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(rig.kyo.parse_sensor_status_(frame.data(), frame.size()));
+  state.SetLabel(MODEL_NAMES[state.range(0)]);
+}
+
+void BM_ParsePartitionStatus(benchmark::State &state) {
+  AlarmModel model = MODELS[state.range(0)];
+  Rig rig(model);
+  auto a = partition_frame(model, 0x00), b = partition_frame(model, 0x01);
+  bool flip = false;
+  for (auto _ : state) {
+    auto &frame = (flip = !flip) ? a : b;
+    benchmark::DoNotOptimize(rig.kyo.parse_partition_status_(frame.data(), frame.size()));
+    rig.kyo.commit_status_();
+  }
+  state.SetLabel(MODEL_NAMES[state.range(0)]);
+}
+
+void BM_ParsePartitionStatusCached(benchmark::State &state) {
+  AlarmModel model = MODELS[state.range(0)];
+  Rig rig(model);
+  auto frame = partition_frame(model, 0x01);
+  rig.kyo.parse_partition_status_(frame.data(), frame.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(rig.kyo.parse_partition_status_(frame.data(), frame.size()));
+  state.SetLabel(MODEL_NAMES[state.range(0)]);
+}
+
+// One steady-state poll: sensor + partition frames, nothing changed
+void BM_PollCycleIdle(benchmark::State &state) {
+  Rig rig(AlarmModel::KYO_32G, state.range(0));
+  auto sensor = sensor_frame(AlarmModel::KYO_32G, 0), partition = partition_frame(AlarmModel::KYO_32G, 0);
+  rig.kyo.parse_sensor_status_(sensor.data(), sensor.size());
+  rig.kyo.parse_partition_status_(partition.data(), partition.size());
+  rig.kyo.commit_status_();
+  for (auto _ : state) {
+    rig.kyo.parse_sensor_status_(sensor.data(), sensor.size());
+    rig.kyo.parse_partition_status_(partition.data(), partition.size());
+    rig.kyo.commit_status_();
+  }
+}
+
+// One poll where a zone opened or closed: both frames decoded, one publish pass
+void BM_PollCycleZoneChange(benchmark::State &state) {
+  Rig rig(AlarmModel::KYO_32G, state.range(0));
+  auto open = sensor_frame(AlarmModel::KYO_32G, 0x01), closed = sensor_frame(AlarmModel::KYO_32G, 0x00);
+  auto partition = partition_frame(AlarmModel::KYO_32G, 0x00);
+  bool flip = false;
+  for (auto _ : state) {
+    auto &sensor = (flip = !flip) ? open : closed;
+    rig.kyo.parse_sensor_status_(sensor.data(), sensor.size());
+    rig.kyo.parse_partition_status_(partition.data(), partition.size());
+    rig.kyo.commit_status_();
+  }
+}
+
+// ---- Publishing ----
+
+void BM_PublishBinarySensors(benchmark::State &state) {
+  Rig rig(AlarmModel::KYO_32G, state.range(0));
+  for (auto _ : state)
+    rig.kyo.publish_binary_sensors_(true);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PublishTextSensors(benchmark::State &state) {
+  Rig rig(AlarmModel::KYO_32G, 0, state.range(0));
+  for (auto _ : state)
+    rig.kyo.publish_text_sensors_();
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// ---- Checksums ----
+
+void BM_CalculateCrc(benchmark::State &state) {
+  uint8_t cmd[11] = {0x0F, 0x00, 0xF0, 0x03, 0x00, 0x02, 0x01, 0x00, 0x00, 0x00, 0xFF};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cmd);
+    benchmark::DoNotOptimize(BenchKyo::calculate_crc_(cmd, 9));
+  }
+}
+
+void BM_CalculateChecksum(benchmark::State &state) {
+  auto frame = partition_frame(AlarmModel::KYO_32G, 0x01);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frame.data());
+    benchmark::DoNotOptimize(BenchKyo::calculate_checksum_(frame.data(), 6, frame.size() - 1));
+  }
+}
+
+// ---- Event decoding ----
+
+void BM_DecodeEventCode(benchmark::State &state) {
+  Rig rig(state.range(0) ? AlarmModel::KYO_32G : AlarmModel::KYO_8, 0);
+  char buf[24];
+  uint16_t code = 0;
+  for (auto _ : state) {
+    uint8_t entity;
+    benchmark::DoNotOptimize(rig.kyo.decode_event_code_(code, &entity, buf, sizeof(buf)));
+    code = (code + 7) & 0x01FF;  // walk the whole table, unknown codes included
+  }
+  state.SetLabel(state.range(0) ? "KYO32" : "KYO8");
+}
+
+void BM_DecodeEventLogChunk(benchmark::State &state) {
+  Rig rig(AlarmModel::KYO_32G, 0);
+  static const uint8_t RECORD[7] = {0x01, 0x30, 0x1B, 0x02, 0x1A, 0x09, 0x37};  // PROTOCOL.md 10.25
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 9; i++)
+    data.insert(data.end(), RECORD, RECORD + 7);
+  data.push_back(0);
+  uint8_t cmd[6] = {0xF0, 0x27, 0x0D, 0x3F, 0x00, 0x00};
+  auto frame = make_frame(cmd, data);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(rig.kyo.decode_event_log_chunk(frame.data(), frame.size(), 0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_ParseSensorStatus)->DenseRange(0, 5);
+BENCHMARK(BM_ParseSensorStatusCached)->DenseRange(0, 5);
+BENCHMARK(BM_ParsePartitionStatus)->DenseRange(0, 5);
+BENCHMARK(BM_ParsePartitionStatusCached)->DenseRange(0, 5);
+BENCHMARK(BM_PollCycleIdle)->Arg(10)->Arg(50)->Arg(200);
+BENCHMARK(BM_PollCycleZoneChange)->Arg(10)->Arg(50)->Arg(200);
+BENCHMARK(BM_PublishBinarySensors)->Arg(10)->Arg(50)->Arg(200);
+BENCHMARK(BM_PublishTextSensors)->Arg(10)->Arg(50)->Arg(200);
+BENCHMARK(BM_CalculateCrc);
+BENCHMARK(BM_CalculateChecksum);
+BENCHMARK(BM_DecodeEventCode)->Arg(0)->Arg(1);
+BENCHMARK(BM_DecodeEventLogChunk);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,307 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Trip-to-publish latency against the simulated panel, in virtual time.
+//
+// Zone, zone tamper and partition alarm bits flip on the panel at random
+// moments (also in the middle of blocking reads); the latency is the virtual
+// time until the matching binary sensor publishes the new state. Scenarios
+// cover several poll intervals and polling while config reads, event log
+// sweeps (each repeated after 30s of normal polling) or commands compete for
+// the bus.
+//
+//   bench_latency [--duration-s N] [--seed S] [--json FILE] [--max-p99-ms T]
+//
+// Exits non-zero if a trip is never published (or p99 exceeds --max-p99-ms).
+
+#include "sim_rig.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+enum Load { LOAD_IDLE, LOAD_CONFIG_READS, LOAD_EVENT_LOG, LOAD_COMMANDS };
+enum TripKind { TRIP_ZONE, TRIP_TAMPER, TRIP_PARTITION_ALARM, TRIP_KIND_COUNT };
+
+const char *const LOAD_NAMES[] = {"idle", "config_reads", "event_log", "commands"};
+const char *const TRIP_NAMES[] = {"zone", "zone_tamper", "partition_alarm"};
+
+struct Scenario {
+  Load load;
+  uint32_t poll_ms;
+};
+
+const Scenario SCENARIOS[] = {
+    {LOAD_IDLE, 250},         {LOAD_IDLE, 500},      {LOAD_IDLE, 1000},
+    {LOAD_CONFIG_READS, 500}, {LOAD_EVENT_LOG, 500}, {LOAD_COMMANDS, 500},
+};
+
+const int WATCHED_ZONES = 6;      // zones 1-6 flip and tamper
+const uint8_t ALARM_ZONE = 8;     // zone 8 (area 1) trips the partition 1 alarm
+const uint32_t MIN_GAP_MS = 150;  // random gap between trips
+const uint32_t MAX_GAP_MS = 2500;
+const uint32_t LOAD_PAUSE_MS = 30000;  // normal polling between config reads / event log sweeps
+const uint32_t DRAIN_MAX_MS = 300000;  // wait for pending trips after the run
+
+struct Watch {
+  binary_sensor::BinarySensor sensor;
+  TripKind kind;
+  bool pending{false};
+  bool expect{false};
+  uint64_t trip_us{0};
+};
+
+struct KindResult {
+  std::vector<double> latencies_ms;
+  uint32_t lost{0};
+};
+
+struct ScenarioResult {
+  Scenario scenario;
+  KindResult kinds[TRIP_KIND_COUNT];
+  uint32_t commands{0};
+};
+
+double percentile(std::vector<double> sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  std::sort(sorted.begin(), sorted.end());
+  size_t rank = (size_t) (p / 100.0 * sorted.size() + 0.999999);
+  return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+ScenarioResult run_scenario(const Scenario &scenario, uint32_t duration_s, uint32_t seed) {
+  ScenarioResult result;
+  result.scenario = scenario;
+
+  SimRig rig(AlarmModel::KYO_32G, seed);
+  rig.scheduler.set_update_interval(scenario.poll_ms);
+  std::mt19937 rng(seed);
+
+  // Zone N sensors, zone N tamper sensors, partition 1 alarm
+  std::vector<Watch> watches(2 * WATCHED_ZONES + 1);
+  for (int i = 0; i < (int) watches.size(); i++) {
+    Watch &w = watches[i];
+    if (i < WATCHED_ZONES) {
+      w.kind = TRIP_ZONE;
+      rig.kyo.register_binary_sensor(&w.sensor, BinarySensorType::ZONE, i);
+    } else if (i < 2 * WATCHED_ZONES) {
+      w.kind = TRIP_TAMPER;
+      rig.kyo.register_binary_sensor(&w.sensor, BinarySensorType::ZONE_TAMPER, i - WATCHED_ZONES);
+    } else {
+      w.kind = TRIP_PARTITION_ALARM;
+      rig.kyo.register_binary_sensor(&w.sensor, BinarySensorType::PARTITION_ALARM, 0);
+    }
+    w.sensor.add_on_state_callback([&rig, &w, &result](bool state) {
+      if (!w.pending || state != w.expect)
+        return;
+      w.pending = false;
+      result.kinds[w.kind].latencies_ms.push_back((rig.clock.now_us() - w.trip_us) / 1000.0);
+    });
+  }
+
+  if (!rig.run_until_config_done()) {
+    fprintf(stderr, "%s/%ums: configuration never completed\n", LOAD_NAMES[scenario.load],
+            (unsigned) scenario.poll_ms);
+    exit(1);
+  }
+  rig.sim.arm(0x01);  // partition 1 armed so zone 8 raises the alarm
+  rig.run_for(2000);
+
+  bool zone_open[WATCHED_ZONES]{};
+  bool zone_tamper[WATCHED_ZONES]{};
+  bool alarm_on = false;
+  auto gap_us = [&]() { return (uint64_t) (MIN_GAP_MS + rng() % (MAX_GAP_MS - MIN_GAP_MS)) * 1000; };
+
+  // Trips fire from the clock listener, so they also land while update() is
+  // blocked inside a configuration read or a command
+  uint64_t end_us = rig.clock.now_us() + (uint64_t) duration_s * 1000000;
+  uint64_t next_trip_us = rig.clock.now_us() + gap_us();
+  bool tripping = true;
+  rig.clock.add_listener([&]() {
+    uint64_t now = rig.clock.now_us();
+    if (!tripping || now < next_trip_us)
+      return;
+    next_trip_us = now + gap_us();
+
+    int index = rng() % watches.size();
+    Watch &w = watches[index];
+    if (w.pending)
+      return;  // previous change on this entity not published yet
+    switch (w.kind) {
+      case TRIP_ZONE:
+        zone_open[index] = !zone_open[index];
+        rig.sim.set_zone(index + 1, zone_open[index]);
+        w.expect = zone_open[index];
+        break;
+      case TRIP_TAMPER: {
+        int zone = index - WATCHED_ZONES;
+        zone_tamper[zone] = !zone_tamper[zone];
+        rig.sim.set_zone_tamper(zone + 1, zone_tamper[zone]);
+        w.expect = zone_tamper[zone];
+        break;
+      }
+      default:
+        alarm_on = !alarm_on;
+        if (alarm_on) {
+          rig.sim.trigger_alarm(ALARM_ZONE);
+        } else {
+          rig.sim.reset_alarms();
+          rig.sim.set_zone(ALARM_ZONE, false);
+        }
+        w.expect = alarm_on;
+        break;
+    }
+    w.pending = true;
+    w.trip_us = now;
+  });
+
+  if (scenario.load == LOAD_CONFIG_READS)
+    rig.kyo.reread_config();
+  else if (scenario.load == LOAD_EVENT_LOG)
+    rig.kyo.read_event_log();
+
+  uint64_t next_command_us = rig.clock.now_us() + 1000000;
+  uint64_t load_restart_us = 0;
+  while (rig.clock.now_us() < end_us) {
+    uint64_t target_us = std::min(end_us, next_trip_us);
+    if (scenario.load == LOAD_COMMANDS)
+      target_us = std::min(target_us, next_command_us);
+    if (load_restart_us != 0)
+      target_us = std::min(target_us, load_restart_us);
+    rig.scheduler.run_until(target_us / 1000 + (target_us % 1000 ? 1 : 0));
+
+    // Repeat the background load after LOAD_PAUSE_MS of normal polling
+    bool load_busy = (scenario.load == LOAD_CONFIG_READS && !rig.kyo.config_done()) ||
+                     (scenario.load == LOAD_EVENT_LOG && rig.kyo.event_log_pending());
+    if (load_busy) {
+      load_restart_us = 0;
+    } else if (load_restart_us == 0) {
+      load_restart_us = rig.clock.now_us() + LOAD_PAUSE_MS * 1000;
+    } else if (rig.clock.now_us() >= load_restart_us) {
+      if (scenario.load == LOAD_CONFIG_READS)
+        rig.kyo.reread_config();
+      else if (scenario.load == LOAD_EVENT_LOG)
+        rig.kyo.read_event_log();
+      load_restart_us = 0;
+    }
+
+    // Commands from Home Assistant run on the main loop between updates
+    if (scenario.load == LOAD_COMMANDS && rig.clock.now_us() >= next_command_us) {
+      switch (rng() % 4) {
+        case 0: rig.kyo.arm_partition(2, 1); break;
+        case 1: rig.kyo.disarm_partition(2); break;
+        case 2: rig.kyo.activate_output(1 + rng() % 4); break;
+        default: rig.kyo.deactivate_output(1 + rng() % 4); break;
+      }
+      result.commands++;
+      next_command_us = rig.clock.now_us() + 500000 + rng() % 2500000;
+    }
+  }
+
+  // Let a running load finish and the last trips publish, then count what
+  // never arrived
+  tripping = false;
+  auto settled = [&]() {
+    if (!rig.kyo.config_done() || rig.kyo.event_log_pending())
+      return false;
+    for (auto &w : watches) {
+      if (w.pending)
+        return false;
+    }
+    return true;
+  };
+  uint64_t drain_end_us = rig.clock.now_us() + (uint64_t) DRAIN_MAX_MS * 1000;
+  while (!settled() && rig.clock.now_us() < drain_end_us)
+    rig.run_for(1000);
+  for (auto &w : watches) {
+    if (w.pending)
+      result.kinds[w.kind].lost++;
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  uint32_t duration_s = 600;
+  uint32_t seed = 1;
+  const char *json_path = nullptr;
+  double max_p99_ms = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--duration-s") == 0 && i + 1 < argc)
+      duration_s = (uint32_t) atol(argv[++i]);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = (uint32_t) atol(argv[++i]);
+    else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+      json_path = argv[++i];
+    else if (strcmp(argv[i], "--max-p99-ms") == 0 && i + 1 < argc)
+      max_p99_ms = atof(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [--duration-s N] [--seed S] [--json FILE] [--max-p99-ms T]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<ScenarioResult> results;
+  for (auto &scenario : SCENARIOS)
+    results.push_back(run_scenario(scenario, duration_s, seed));
+
+  int status = 0;
+  printf("trip-to-publish latency, KYO32G, %us virtual per scenario, seed %u (ms)\n", (unsigned) duration_s,
+         (unsigned) seed);
+  printf("%-13s %5s  %-16s %6s %8s %8s %8s %8s %5s\n", "load", "poll", "trip", "n", "p50", "p95", "p99", "max",
+         "lost");
+  for (auto &r : results) {
+    for (int k = 0; k < TRIP_KIND_COUNT; k++) {
+      auto &lat = r.kinds[k].latencies_ms;
+      double p99 = percentile(lat, 99);
+      printf("%-13s %5u  %-16s %6zu %8.1f %8.1f %8.1f %8.1f %5u\n", LOAD_NAMES[r.scenario.load],
+             (unsigned) r.scenario.poll_ms, TRIP_NAMES[k], lat.size(), percentile(lat, 50), percentile(lat, 95), p99,
+             percentile(lat, 100), (unsigned) r.kinds[k].lost);
+      if (r.kinds[k].lost > 0 || (max_p99_ms > 0 && p99 > max_p99_ms))
+        status = 1;
+    }
+  }
+
+  if (json_path != nullptr) {
+    FILE *f = fopen(json_path, "w");
+    if (f == nullptr) {
+      perror(json_path);
+      return 1;
+    }
+    fprintf(f, "{\n  \"model\": \"KYO32G\",\n  \"duration_s\": %u,\n  \"seed\": %u,\n  \"scenarios\": [\n",
+            (unsigned) duration_s, (unsigned) seed);
+    for (size_t i = 0; i < results.size(); i++) {
+      auto &r = results[i];
+      fprintf(f, "    {\"load\": \"%s\", \"poll_ms\": %u, \"commands\": %u, \"trips\": {", LOAD_NAMES[r.scenario.load],
+              (unsigned) r.scenario.poll_ms, (unsigned) r.commands);
+      for (int k = 0; k < TRIP_KIND_COUNT; k++) {
+        auto &lat = r.kinds[k].latencies_ms;
+        fprintf(f, "%s\"%s\": {\"n\": %zu, \"p50_ms\": %.1f, \"p95_ms\": %.1f, \"p99_ms\": %.1f, \"max_ms\": %.1f, "
+                   "\"lost\": %u}",
+                k ? ", " : "", TRIP_NAMES[k], lat.size(), percentile(lat, 50), percentile(lat, 95),
+                percentile(lat, 99), percentile(lat, 100), (unsigned) r.kinds[k].lost);
+      }
+      fprintf(f, "}}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+  }
+  return status;
+}
@@ -0,0 +1,276 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Two hubs on one main loop, each with its own simulated panel, in virtual
+// time. Zone bits flip at random moments on either panel; the latency is the
+// virtual time until that panel's binary sensor publishes. Loads put one or
+// both hubs through config reads or event log sweeps (repeated after 30s of
+// normal polling), once with the shared blocking budget the codegen sets up
+// and once with each hub rationing only itself.
+//
+//   bench_multi_hub [--duration-s N] [--seed S] [--max-p99-ms T]
+//
+// Exits non-zero if a trip is never published (or a shared-budget p99
+// exceeds --max-p99-ms).
+
+#include "kyo_panel_sim.h"
+#include "kyo_scheduler.h"
+#include "test_kyo.h"
+#include "virtual_clock.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+enum Load { LOAD_IDLE, LOAD_CONFIG_READS, LOAD_EVENT_LOG };
+
+const char *const LOAD_NAMES[] = {"idle", "config_reads", "event_log"};
+const char *const HUB_NAMES[] = {"panel_a", "panel_b"};
+
+struct Scenario {
+  Load load[2];
+};
+
+const Scenario SCENARIOS[] = {
+    {{LOAD_IDLE, LOAD_IDLE}},
+    {{LOAD_CONFIG_READS, LOAD_IDLE}},
+    {{LOAD_CONFIG_READS, LOAD_CONFIG_READS}},
+    {{LOAD_EVENT_LOG, LOAD_EVENT_LOG}},
+    {{LOAD_CONFIG_READS, LOAD_EVENT_LOG}},
+};
+
+const uint32_t POLL_MS = 500;
+const int WATCHED_ZONES = 6;
+const uint32_t MIN_GAP_MS = 150;  // random gap between trips, either panel
+const uint32_t MAX_GAP_MS = 2500;
+const uint32_t LOAD_PAUSE_MS = 30000;
+const uint32_t DRAIN_MAX_MS = 300000;
+
+struct Watch {
+  binary_sensor::BinarySensor sensor;
+  bool open{false};
+  bool pending{false};
+  uint64_t trip_us{0};
+};
+
+struct Hub {
+  explicit Hub(uint32_t seed) : sim(AlarmModel::KYO_32G, seed) {}
+
+  bool load_busy(Load load) const {
+    return (load == LOAD_CONFIG_READS && !this->kyo.config_done()) ||
+           (load == LOAD_EVENT_LOG && this->kyo.event_log_pending());
+  }
+  void start_load(Load load) {
+    if (load == LOAD_CONFIG_READS)
+      this->kyo.reread_config();
+    else if (load == LOAD_EVENT_LOG)
+      this->kyo.read_event_log();
+  }
+
+  KyoPanelSim sim;
+  LoopbackTransport link;
+  TestKyo kyo;
+  Watch watches[WATCHED_ZONES];
+  uint64_t load_restart_us{0};
+};
+
+struct HubResult {
+  std::vector<double> latencies_ms;
+  uint32_t lost{0};
+  uint32_t blocking_steps{0};
+  uint32_t deferrals{0};
+};
+
+struct ScenarioResult {
+  Scenario scenario;
+  bool shared;
+  HubResult hubs[2];
+};
+
+double percentile(std::vector<double> sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  std::sort(sorted.begin(), sorted.end());
+  size_t rank = (size_t) (p / 100.0 * sorted.size() + 0.999999);
+  return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+ScenarioResult run_scenario(const Scenario &scenario, bool shared, uint32_t duration_s, uint32_t seed) {
+  ScenarioResult result;
+  result.scenario = scenario;
+  result.shared = shared;
+
+  global_preferences->clear();
+  VirtualClock clock;
+  KyoLoopBudget budget;
+  std::unique_ptr<Hub> hubs[2] = {std::unique_ptr<Hub>(new Hub(seed)), std::unique_ptr<Hub>(new Hub(seed + 1))};
+  KyoScheduler scheduler(&clock, &hubs[0]->kyo, POLL_MS);
+  scheduler.add_component(&hubs[1]->kyo, POLL_MS);
+
+  for (int h = 0; h < 2; h++) {
+    Hub &hub = *hubs[h];
+    hub.link.connect(&hub.sim.port());
+    hub.kyo.set_transport(&hub.link);
+    hub.kyo.set_clock(&clock);
+    hub.kyo.set_instance_id(HUB_NAMES[h]);
+    if (shared)
+      hub.kyo.set_loop_budget(&budget);
+    hub.sim.set_clock(&clock);
+    clock.add_listener([&hub]() { hub.sim.poll(); });
+    scheduler.add_busy_check(
+        [&hub]() { return !hub.kyo.serial_idle() || !hub.sim.is_idle() || hub.link.available() > 0; });
+    scheduler.add_wakeup([&hub]() { return hub.kyo.is_recovering() ? hub.kyo.next_probe_ms() : 0; });
+    for (int z = 0; z < WATCHED_ZONES; z++) {
+      Watch &w = hub.watches[z];
+      hub.kyo.register_binary_sensor(&w.sensor, BinarySensorType::ZONE, z);
+      HubResult &out = result.hubs[h];
+      w.sensor.add_on_state_callback([&clock, &w, &out](bool state) {
+        if (!w.pending || state != w.open)
+          return;
+        w.pending = false;
+        out.latencies_ms.push_back((clock.now_us() - w.trip_us) / 1000.0);
+      });
+    }
+    hub.kyo.setup();
+  }
+
+  if (!scheduler.run_until([&]() { return hubs[0]->kyo.config_done() && hubs[1]->kyo.config_done(); }, 600000)) {
+    fprintf(stderr, "%s/%s: configuration never completed\n", LOAD_NAMES[scenario.load[0]],
+            LOAD_NAMES[scenario.load[1]]);
+    exit(1);
+  }
+  scheduler.run_for(2000);
+
+  std::mt19937 rng(seed);
+  auto gap_us = [&]() { return (uint64_t) (MIN_GAP_MS + rng() % (MAX_GAP_MS - MIN_GAP_MS)) * 1000; };
+  uint64_t end_us = clock.now_us() + (uint64_t) duration_s * 1000000;
+  uint64_t next_trip_us = clock.now_us() + gap_us();
+  bool tripping = true;
+  clock.add_listener([&]() {
+    uint64_t now = clock.now_us();
+    if (!tripping || now < next_trip_us)
+      return;
+    next_trip_us = now + gap_us();
+    Hub &hub = *hubs[rng() % 2];
+    int zone = rng() % WATCHED_ZONES;
+    Watch &w = hub.watches[zone];
+    if (w.pending)
+      return;
+    w.open = !w.open;
+    hub.sim.set_zone(zone + 1, w.open);
+    w.pending = true;
+    w.trip_us = now;
+  });
+
+  for (int h = 0; h < 2; h++)
+    hubs[h]->start_load(scenario.load[h]);
+
+  while (clock.now_us() < end_us) {
+    uint64_t target_us = std::min(end_us, next_trip_us);
+    for (auto &hub : hubs) {
+      if (hub->load_restart_us != 0)
+        target_us = std::min(target_us, hub->load_restart_us);
+    }
+    scheduler.run_until(target_us / 1000 + (target_us % 1000 ? 1 : 0));
+
+    for (int h = 0; h < 2; h++) {
+      Hub &hub = *hubs[h];
+      Load load = scenario.load[h];
+      if (load == LOAD_IDLE)
+        continue;
+      if (hub.load_busy(load)) {
+        hub.load_restart_us = 0;
+      } else if (hub.load_restart_us == 0) {
+        hub.load_restart_us = clock.now_us() + LOAD_PAUSE_MS * 1000;
+      } else if (clock.now_us() >= hub.load_restart_us) {
+        hub.start_load(load);
+        hub.load_restart_us = 0;
+      }
+    }
+  }
+
+  tripping = false;
+  auto settled = [&]() {
+    for (int h = 0; h < 2; h++) {
+      if (hubs[h]->load_busy(scenario.load[h]))
+        return false;
+      for (auto &w : hubs[h]->watches) {
+        if (w.pending)
+          return false;
+      }
+    }
+    return true;
+  };
+  uint64_t drain_end_us = clock.now_us() + (uint64_t) DRAIN_MAX_MS * 1000;
+  while (!settled() && clock.now_us() < drain_end_us)
+    scheduler.run_for(1000);
+
+  for (int h = 0; h < 2; h++) {
+    for (auto &w : hubs[h]->watches) {
+      if (w.pending)
+        result.hubs[h].lost++;
+    }
+    const KyoLoopBudget &hub_budget = hubs[h]->kyo.get_loop_budget();
+    result.hubs[h].blocking_steps = hub_budget.get_grants(&hubs[h]->kyo);
+    result.hubs[h].deferrals = hub_budget.get_deferrals(&hubs[h]->kyo);
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  uint32_t duration_s = 600;
+  uint32_t seed = 1;
+  double max_p99_ms = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--duration-s") == 0 && i + 1 < argc)
+      duration_s = (uint32_t) atol(argv[++i]);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = (uint32_t) atol(argv[++i]);
+    else if (strcmp(argv[i], "--max-p99-ms") == 0 && i + 1 < argc)
+      max_p99_ms = atof(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [--duration-s N] [--seed S] [--max-p99-ms T]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int status = 0;
+  printf("zone trip-to-publish latency, two KYO32G hubs polled every %ums, %us virtual per scenario, seed %u (ms)\n",
+         (unsigned) POLL_MS, (unsigned) duration_s, (unsigned) seed);
+  printf("%-8s %-13s %-13s %-8s %6s %8s %8s %8s %8s %5s %6s %6s\n", "budget", "load_a", "load_b", "hub", "n", "p50",
+         "p95", "p99", "max", "lost", "steps", "defer");
+  for (bool shared : {true, false}) {
+    for (auto &scenario : SCENARIOS) {
+      ScenarioResult r = run_scenario(scenario, shared, duration_s, seed);
+      for (int h = 0; h < 2; h++) {
+        auto &out = r.hubs[h];
+        double p99 = percentile(out.latencies_ms, 99);
+        printf("%-8s %-13s %-13s %-8s %6zu %8.1f %8.1f %8.1f %8.1f %5u %6u %6u\n", shared ? "shared" : "per-hub",
+               LOAD_NAMES[scenario.load[0]], LOAD_NAMES[scenario.load[1]], HUB_NAMES[h], out.latencies_ms.size(),
+               percentile(out.latencies_ms, 50), percentile(out.latencies_ms, 95), p99,
+               percentile(out.latencies_ms, 100), (unsigned) out.lost, (unsigned) out.blocking_steps,
+               (unsigned) out.deferrals);
+        if (out.lost > 0 || (shared && max_p99_ms > 0 && p99 > max_p99_ms))
+          status = 1;
+      }
+    }
+  }
+  return status;
+}
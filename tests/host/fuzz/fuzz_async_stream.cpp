@@ -0,0 +1,51 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// The non-blocking path end to end: byte 0 selects the pending operation
+// (detect/sensor/partition) and model, the rest arrives on the wire one byte
+// per loop() with gaps encoded in the input, so echo/length handling,
+// dispatch, chaining and failure backoff all see arbitrary traffic.
+
+#include "fuzz_kyo.h"
+
+using namespace esphome::bentel_kyo;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < 1 || size > 1024)
+    return 0;
+  FuzzRig rig;
+  LoopbackTransport wire;
+  rig.kyo.set_transport(&wire);
+  rig.kyo.force_model(fuzz_model(data[0] >> 2));
+  rig.begin_input();
+
+  uint8_t op = (data[0] & 0x03) % (METRIC_OP_PARTITION + 1);  // version, sensor or partition
+  rig.kyo.begin_exchange(FuzzKyo::poll_command(op), 6, op, 80);
+
+  for (size_t i = 1; i < size; i++) {
+    // 0xFA escapes a gap: FA nn = wait nn ms before the next byte, FA FA = literal 0xFA
+    if (data[i] == 0xFA && i + 1 < size && data[i + 1] != 0xFA) {
+      rig.clock.advance_us((uint64_t) data[++i] * 1000);
+      continue;
+    }
+    if (data[i] == 0xFA)
+      i++;
+    if (i >= size)
+      break;
+    rig.clock.advance_us(BYTE_TIME_US);
+    wire.inject(&data[i], 1);
+    rig.kyo.loop();
+    if (rig.kyo.serial_idle())
+      rig.kyo.begin_exchange(FuzzKyo::poll_command(op), 6, op, 80);
+  }
+  for (int tick = 0; tick < 200; tick++) {
+    rig.clock.advance_us(1000);
+    rig.kyo.loop();
+  }
+  return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Blocking configuration reads through send_message_(): zone config, names,
+// ESNs, timers, panel mode, status flags and the event log. Byte 0 selects
+// the model; the rest is a script of panel answers, one [len][bytes] chunk
+// per command (len 0xFF = a line that never stops sending).
+
+#include "fuzz_kyo.h"
+
+using namespace esphome::bentel_kyo;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < 1 || size > 4096)
+    return 0;
+  FuzzRig rig;
+  rig.kyo.force_model(fuzz_model(data[0]));
+  auto script = fuzz_frame(data + 1, size - 1);
+  rig.link.set_script(script.data(), script.size());
+
+  FuzzKyo &kyo = rig.kyo;
+  rig.begin_input();
+  kyo.read_zone_config_();
+  kyo.read_zone_names_();
+  for (int i = 0; i <= KYO_MAX_ZONES && !kyo.read_zone_esn_next_(); i++) {
+  }
+  kyo.read_output_names_();
+  kyo.read_partition_config_();
+  rig.begin_input();
+  for (int i = 0; i <= KYO_MAX_KEYFOBS && !kyo.read_keyfob_esn_next_(); i++) {
+  }
+  kyo.read_keyfob_names_();
+  kyo.read_partition_names_();
+  kyo.read_code_names_();
+  kyo.read_panel_mode_();
+  kyo.read_status_flags_();
+  rig.begin_input();
+  for (int i = 0; i <= 28 && !kyo.read_event_log_next_(); i++) {
+  }
+  kyo.publish_text_sensors_();
+  return 0;
+}
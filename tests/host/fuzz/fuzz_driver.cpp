@@ -0,0 +1,165 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Stand-in for libFuzzer's main() when the compiler has no -fsanitize=fuzzer
+// (GCC). Runs every corpus file, then a fixed number of seeded mutations of
+// them (bit flips, byte overwrites, inserts, deletes, truncation, splices),
+// so the sanitizer build still covers malformed traffic deterministically.
+//
+//   fuzz_target [-runs=N] [-seed=S] [-max_ms=T] corpus_dir_or_file...
+//
+// Exits non-zero if an input takes longer than max_ms of wall time;
+// sanitizer findings abort the process as usual.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+namespace {
+
+using Input = std::vector<uint8_t>;
+
+void load_path(const std::string &path, std::vector<Input> *corpus) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    fprintf(stderr, "fuzz: cannot stat %s\n", path.c_str());
+    exit(2);
+  }
+  if (S_ISDIR(st.st_mode)) {
+    DIR *dir = opendir(path.c_str());
+    std::vector<std::string> names;
+    while (struct dirent *entry = readdir(dir)) {
+      if (entry->d_name[0] != '.')
+        names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());  // stable order for reproducible runs
+    for (auto &name : names)
+      load_path(path + "/" + name, corpus);
+    return;
+  }
+  std::ifstream in(path, std::ios::binary);
+  corpus->emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+Input mutate(const std::vector<Input> &corpus, std::mt19937 &rng) {
+  Input input = corpus[rng() % corpus.size()];
+  int rounds = 1 + rng() % 4;
+  for (int r = 0; r < rounds; r++) {
+    size_t size = input.size();
+    switch (rng() % 7) {
+      case 0:  // flip a bit
+        if (size > 0)
+          input[rng() % size] ^= 1 << (rng() % 8);
+        break;
+      case 1:  // overwrite a byte (often with an interesting value)
+        if (size > 0) {
+          static const uint8_t INTERESTING[] = {0x00, 0x01, 0x0F, 0x7F, 0x80, 0xF0, 0xFE, 0xFF};
+          input[rng() % size] = (rng() & 1) ? INTERESTING[rng() % sizeof(INTERESTING)] : (uint8_t) rng();
+        }
+        break;
+      case 2:  // insert random bytes
+        input.insert(input.begin() + (size ? rng() % (size + 1) : 0), 1 + rng() % 8, (uint8_t) rng());
+        break;
+      case 3:  // delete a run
+        if (size > 1) {
+          size_t pos = rng() % size;
+          size_t len = std::min<size_t>(1 + rng() % 8, size - pos);
+          input.erase(input.begin() + pos, input.begin() + pos + len);
+        }
+        break;
+      case 4:  // truncate
+        if (size > 0)
+          input.resize(rng() % size);
+        break;
+      case 5: {  // splice with another input
+        const Input &other = corpus[rng() % corpus.size()];
+        if (!other.empty()) {
+          size_t pos = size ? rng() % size : 0;
+          input.resize(pos);
+          input.insert(input.end(), other.begin() + rng() % other.size(), other.end());
+        }
+        break;
+      }
+      case 6:  // duplicate a block
+        if (size > 0) {
+          size_t pos = rng() % size;
+          size_t len = std::min<size_t>(1 + rng() % 32, size - pos);
+          Input block(input.begin() + pos, input.begin() + pos + len);
+          input.insert(input.begin() + pos, block.begin(), block.end());
+        }
+        break;
+    }
+  }
+  return input;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  long runs = 20000;
+  unsigned seed = 1;
+  double max_ms = 250;
+  std::vector<Input> corpus;
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-runs=", 6) == 0)
+      runs = atol(argv[i] + 6);
+    else if (strncmp(argv[i], "-seed=", 6) == 0)
+      seed = (unsigned) atol(argv[i] + 6);
+    else if (strncmp(argv[i], "-max_ms=", 8) == 0)
+      max_ms = atof(argv[i] + 8);
+    else
+      load_path(argv[i], &corpus);
+  }
+  if (corpus.empty())
+    corpus.emplace_back();
+
+  std::mt19937 rng(seed);
+  double slowest_ms = 0;
+  long executed = 0;
+  auto run_one = [&](const Input &input) {
+    // Exactly-sized heap copy so ASan sees the real input bounds
+    std::unique_ptr<uint8_t[]> copy(new uint8_t[input.size() ? input.size() : 1]);
+    if (!input.empty())
+      memcpy(copy.get(), input.data(), input.size());
+    auto start = std::chrono::steady_clock::now();
+    LLVMFuzzerTestOneInput(copy.get(), input.size());
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    slowest_ms = std::max(slowest_ms, ms);
+    executed++;
+    if (ms > max_ms) {
+      fprintf(stderr, "fuzz: input of %zu bytes took %.1f ms (limit %.1f ms)\n", input.size(), ms, max_ms);
+      for (uint8_t b : input)
+        fprintf(stderr, "%02X ", b);
+      fprintf(stderr, "\n");
+      exit(1);
+    }
+  };
+
+  for (auto &input : corpus)
+    run_one(input);
+  for (long i = 0; i < runs; i++)
+    run_one(mutate(corpus, rng));
+
+  printf("fuzz: %ld inputs (%zu seeds, seed=%u), slowest %.2f ms\n", executed, corpus.size(), seed, slowest_ms);
+  return 0;
+}
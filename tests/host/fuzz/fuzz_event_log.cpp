@@ -0,0 +1,34 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Event log decoding: byte 0 selects the model (event code table), byte 1
+// the chunk index, the rest is a 0x0D27 chunk response. Every 16-bit pair in
+// the input is also run through decode_event_code_() on its own.
+
+#include "fuzz_kyo.h"
+
+using namespace esphome::bentel_kyo;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < 2 || size > 256)
+    return 0;
+  FuzzRig rig;
+  rig.begin_input();
+  rig.kyo.force_model(fuzz_model(data[0]));
+  auto frame = fuzz_frame(data + 2, size - 2);
+  rig.kyo.decode_event_log_chunk(frame.data(), (int) frame.size(), data[1] % 28);
+
+  char buf[24];
+  for (size_t i = 0; i + 1 < frame.size(); i += 2) {
+    uint8_t entity = 0;
+    const char *name = rig.kyo.decode_event_code_((frame[i] << 8) | frame[i + 1], &entity, buf, sizeof(buf));
+    if (name == nullptr)
+      abort();
+  }
+  return 0;
+}
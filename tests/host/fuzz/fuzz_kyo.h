@@ -0,0 +1,184 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Shared rig for the parser fuzz targets.
+//
+// Inputs are copied into exactly-sized heap buffers so AddressSanitizer flags
+// any read past the received frame. Every target runs on a VirtualClock whose
+// listener aborts once an input has consumed more panel time than the engine
+// could legitimately spend on it, so a wedge shows up as a crash instead of a
+// hung fuzzer.
+
+#pragma once
+
+#include "alarm_control_panel.h"
+#include "test_kyo.h"
+#include "virtual_clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Feeds scripted panel answers: each write_array() releases the next chunk of
+// the script. A chunk is [len][len bytes]; len 0xFF makes the panel babble
+// (every read returns another byte, forever).
+class ScriptTransport : public KyoTransport {
+ public:
+  void set_script(const uint8_t *data, size_t size) {
+    this->script_ = data;
+    this->size_ = size;
+    this->pos_ = 0;
+    this->pending_.clear();
+    this->pending_pos_ = 0;
+    this->babble_ = false;
+  }
+
+  int available() override {
+    if (this->babble_)
+      return 1;
+    return (int) (this->pending_.size() - this->pending_pos_);
+  }
+  uint8_t read() override {
+    if (this->babble_)
+      return (uint8_t) this->babble_count_++;
+    if (this->pending_pos_ >= this->pending_.size())
+      return 0;
+    return this->pending_[this->pending_pos_++];
+  }
+  void write_array(const uint8_t *data, size_t len) override {
+    this->pending_.clear();
+    this->pending_pos_ = 0;
+    if (this->pos_ >= this->size_)
+      return;
+    uint8_t chunk = this->script_[this->pos_++];
+    if (chunk == 0xFF) {
+      this->babble_ = true;
+      return;
+    }
+    size_t n = std::min<size_t>(chunk, this->size_ - this->pos_);
+    this->pending_.assign(this->script_ + this->pos_, this->script_ + this->pos_ + n);
+    this->pos_ += n;
+  }
+  void stop_babble() { this->babble_ = false; }
+
+ protected:
+  const uint8_t *script_{nullptr};
+  size_t size_{0};
+  size_t pos_{0};
+  std::vector<uint8_t> pending_;
+  size_t pending_pos_{0};
+  bool babble_{false};
+  uint32_t babble_count_{0};
+};
+
+class FuzzKyo : public TestKyo {
+ public:
+  using BentelKyo::decode_event_code_;
+  using BentelKyo::detect_alarm_model_;
+  using BentelKyo::parse_partition_status_;
+  using BentelKyo::parse_sensor_status_;
+  using BentelKyo::publish_text_sensors_;
+  using BentelKyo::read_code_names_;
+  using BentelKyo::read_event_log_next_;
+  using BentelKyo::read_keyfob_esn_next_;
+  using BentelKyo::read_keyfob_names_;
+  using BentelKyo::read_output_names_;
+  using BentelKyo::read_panel_mode_;
+  using BentelKyo::read_partition_config_;
+  using BentelKyo::read_partition_names_;
+  using BentelKyo::read_status_flags_;
+  using BentelKyo::read_zone_config_;
+  using BentelKyo::read_zone_esn_next_;
+  using BentelKyo::read_zone_names_;
+
+  // Command that starts async operation op (version, sensor or partition MetricOp)
+  static const uint8_t *poll_command(uint8_t op) {
+    if (op == METRIC_OP_VERSION)
+      return CMD_GET_VERSION;
+    return op == METRIC_OP_SENSOR ? CMD_GET_SENSOR_STATUS : CMD_GET_PARTITION_KYO32G;
+  }
+
+  // Pretend detection already happened (UNKNOWN leaves it undetected)
+  void force_model(AlarmModel model) {
+    this->alarm_model_ = model;
+    this->model_detected_ = model != AlarmModel::UNKNOWN;
+    bool kyo8 = model == AlarmModel::KYO_4 || model == AlarmModel::KYO_8 || model == AlarmModel::KYO_8G ||
+                model == AlarmModel::KYO_8W;
+    this->max_zones_ = kyo8 ? KYO_MAX_ZONES_8 : KYO_MAX_ZONES;
+  }
+};
+
+// Engine plus one entity of every kind, on virtual time
+class FuzzRig {
+ public:
+  // Upper bound of panel time a single input may consume
+  static const uint64_t MAX_VIRTUAL_MS = 600000;
+
+  // 2ms steps: still finer than the 10ms inter-byte silence, and timeouts on
+  // garbage answers cost a quarter of the iterations
+  FuzzRig() : clock(2000) {
+    this->clock.add_listener([this]() {
+      if (this->clock.now_us() - this->start_us_ > MAX_VIRTUAL_MS * 1000) {
+        fprintf(stderr, "fuzz: input consumed more than %llu ms of panel time (engine wedged)\n",
+                (unsigned long long) MAX_VIRTUAL_MS);
+        abort();
+      }
+    });
+    this->kyo.set_clock(&this->clock);
+    this->kyo.set_transport(&this->link);
+
+    for (uint8_t type = BinarySensorType::ZONE; type <= BinarySensorType::TROUBLE_ACTIVE; type++) {
+      for (uint8_t index : {(uint8_t) 0, (uint8_t) 7, (uint8_t) 31}) {
+        this->binary_sensors_.emplace_back(new binary_sensor::BinarySensor());
+        this->kyo.register_binary_sensor(this->binary_sensors_.back().get(), (BinarySensorType) type, index);
+      }
+    }
+    for (uint8_t type = TEXT_ZONE_TYPE; type <= TEXT_STATUS_FLAGS_RAW; type++) {
+      for (uint8_t index : {(uint8_t) 0, (uint8_t) 15, (uint8_t) 31}) {
+        this->text_sensors_.emplace_back(new text_sensor::TextSensor());
+        this->kyo.register_text_sensor(this->text_sensors_.back().get(), (TextSensorType) type, index);
+      }
+    }
+    this->kyo.set_firmware_version_text_sensor(&this->firmware_sensor_);
+    this->kyo.set_alarm_model_text_sensor(&this->model_sensor_);
+    for (uint8_t p = 1; p <= KYO_MAX_PARTITIONS; p++) {
+      this->panels_.emplace_back(new BentelKyoAlarmPanel());
+      this->panels_.back()->set_parent(&this->kyo);
+      this->panels_.back()->set_partition(p);
+      this->kyo.register_alarm_panel(this->panels_.back().get());
+    }
+    this->clock.advance_to_ms(1000);
+  }
+
+  // Mark the start of an input (resets the wedge budget)
+  void begin_input() { this->start_us_ = this->clock.now_us(); }
+
+  VirtualClock clock;
+  ScriptTransport link;
+  FuzzKyo kyo;
+
+ protected:
+  uint64_t start_us_{0};
+  text_sensor::TextSensor firmware_sensor_;
+  text_sensor::TextSensor model_sensor_;
+  std::vector<std::unique_ptr<binary_sensor::BinarySensor>> binary_sensors_;
+  std::vector<std::unique_ptr<text_sensor::TextSensor>> text_sensors_;
+  std::vector<std::unique_ptr<BentelKyoAlarmPanel>> panels_;
+};
+
+inline AlarmModel fuzz_model(uint8_t selector) { return (AlarmModel) (selector % 7); }
+
+// Exactly-sized copy so ASan catches reads past the end
+inline std::vector<uint8_t> fuzz_frame(const uint8_t *data, size_t size) { return std::vector<uint8_t>(data, data + size); }
+
+}  // namespace bentel_kyo
+}  // namespace esphome
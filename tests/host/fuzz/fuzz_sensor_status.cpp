@@ -0,0 +1,27 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// parse_sensor_status_(): byte 0 selects the detected model (or none, which
+// exercises length-based inference); the rest is the response frame. Each
+// frame is parsed twice so the change cache path runs too.
+
+#include "fuzz_kyo.h"
+
+using namespace esphome::bentel_kyo;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < 1 || size > 255)
+    return 0;
+  FuzzRig rig;
+  rig.begin_input();
+  rig.kyo.force_model(fuzz_model(data[0]));
+  auto frame = fuzz_frame(data + 1, size - 1);
+  rig.kyo.parse_sensor_status_(frame.data(), (int) frame.size());
+  rig.kyo.parse_sensor_status_(frame.data(), (int) frame.size());
+  return 0;
+}
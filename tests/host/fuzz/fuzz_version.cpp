@@ -0,0 +1,24 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// detect_alarm_model_(): input is a raw version response (echo + 12-char
+// firmware string + checksum) of any length.
+
+#include "fuzz_kyo.h"
+
+using namespace esphome::bentel_kyo;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size > 254)
+    return 0;  // the receive buffers hold at most 254 bytes
+  FuzzRig rig;
+  rig.begin_input();
+  auto frame = fuzz_frame(data, size);
+  rig.kyo.detect_alarm_model_(frame.data(), (int) frame.size());
+  return 0;
+}
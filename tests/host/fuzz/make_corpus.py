@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Regenerate the fuzz seed corpus from the frame examples in docs/PROTOCOL.md.
+
+Each target directory under corpus/ gets a handful of well-formed inputs in
+the layout its LLVMFuzzerTestOneInput() expects (see the comment at the top of
+each fuzz_*.cpp). Run from anywhere: python3 tests/host/fuzz/make_corpus.py
+"""
+
+import os
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# AlarmModel selector byte (fuzz_model(): value % 7)
+UNKNOWN, KYO_4, KYO_8, KYO_8G, KYO_8W, KYO_32, KYO_32G = range(7)
+
+
+def read_cmd(address, length):
+    cmd = [0xF0, address & 0xFF, address >> 8, length, 0x00]
+    return cmd + [sum(cmd) & 0xFF]
+
+
+def response(address, data):
+    """Echo + data + additive checksum (PROTOCOL.md section 2.2)."""
+    return bytes(read_cmd(address, len(data) - 1) + list(data) + [sum(data) & 0xFF])
+
+
+def write(target, name, payload):
+    path = os.path.join(HERE, "corpus", target)
+    os.makedirs(path, exist_ok=True)
+    with open(os.path.join(path, name), "wb") as f:
+        f.write(payload)
+
+
+def name_block(*names):
+    return b"".join(n.ljust(16).encode() for n in names)
+
+
+# 4.1 software version
+for name, fw in [("kyo32", "KYO32   1.05"), ("kyo32g", "KYO32G  2.13"), ("kyo8w", "KYO8W   2.00"),
+                 ("kyo4", "KYO4    2.00"), ("unknown", "XYZ     0.00")]:
+    write("fuzz_version", name, response(0x0000, fw.encode()))
+
+# 12.1 sensor status (zone 2 active), plus KYO8 layout and an all-flags frame
+SENSOR_32 = response(0xF004, bytes([0, 0, 0, 0x02, 0, 0, 0, 0, 0, 0, 0]))
+SENSOR_8 = response(0xF004, bytes([0x02, 0, 0, 0, 0]))
+write("fuzz_sensor_status", "kyo32_zone2", bytes([KYO_32]) + SENSOR_32)
+write("fuzz_sensor_status", "undetected_kyo32", bytes([UNKNOWN]) + SENSOR_32)
+write("fuzz_sensor_status", "kyo8_zone2", bytes([KYO_8]) + SENSOR_8)
+write("fuzz_sensor_status", "undetected_kyo8", bytes([UNKNOWN]) + SENSOR_8)
+write("fuzz_sensor_status", "kyo32g_all_flags", bytes([KYO_32G]) + response(0xF004, bytes([0xFF] * 11)))
+
+# 5.2 partition status: P1 armed total, siren, zone 5 alarm memory
+PART_32 = bytes([0x01, 0, 0, 0xFE, 0x20, 0x01, 0x03] + [0] * 4 + [0, 0, 0, 0x10] + [0] * 4)
+write("fuzz_partition_status", "kyo32g_armed_siren", bytes([KYO_32G]) + response(0x1502, PART_32))
+write("fuzz_partition_status", "kyo32_disarmed", bytes([KYO_32]) + response(0x14EC, bytes([0, 0, 0, 0xFF] + [0] * 15)))
+write("fuzz_partition_status", "kyo8_armed_siren", bytes([KYO_8]) + response(0x0E68, bytes([0x01, 0, 0, 0x0E, 0x41, 0, 0x10, 0, 0, 0])))
+write("fuzz_partition_status", "kyo8w_outputs", bytes([KYO_8W]) + response(0x0E68, bytes([0, 0x02, 0, 0x0D, 0x40, 0, 0xFF, 0, 0, 0])))
+
+# 10.25 event log example records
+EVENTS = bytes.fromhex(
+    "0130 1B021A0937 0131 1B021A0937 0132 1B021A0937 0008 1B021A0937 0000 1B021A0937"
+    " 01BC 1B021A0938 0141 1B021A0938 0142 1B021A0938 0148 1B021A0938".replace(" ", "")) + b"\x00"
+write("fuzz_event_log", "kyo32_chunk0", bytes([KYO_32, 0]) + response(0x0D27, EVENTS))
+write("fuzz_event_log", "kyo8_chunk27", bytes([KYO_8, 27]) + response(0x0D27 + 27 * 0x40, EVENTS))
+write("fuzz_event_log", "empty_chunk", bytes([KYO_32G, 3]) + response(0x0D27 + 3 * 0x40, bytes(64)))
+
+
+# Blocking reads: [len][frame] per command, in fuzz_config_reads.cpp order
+def chunk(frame):
+    return bytes([len(frame)]) + frame
+
+
+ZONE_CFG = bytes([0x00, 0x01, 0x01, 0x0F, 0x02, 0x01, 0x01, 0x0F, 0x02, 0x01, 0x02, 0x0F, 0x00, 0x01, 0x02, 0x0F] +
+                 [0x01, 0x01, 0x02, 0x0F] * 2 + [0x00, 0x01, 0x04, 0x0F] + [0x00, 0x00, 0x01, 0x0F] * 9)
+script = chunk(response(0x009F, ZONE_CFG)) + chunk(response(0x00DF, bytes([0x18, 0x00, 0x01, 0x0F] * 16)))
+script += chunk(response(0x2E00, name_block("Front door", "Garage", "Kitchen", "Hall")))
+script += chunk(response(0x2E40, name_block("Zone 5", "Zone 6", "Zone 7", "Zone 8")))
+script += chunk(response(0xC045, bytes([0x12, 0x34, 0x56])))
+script += chunk(response(0xC048, bytes(3)))
+write("fuzz_config_reads", "kyo8_partial", bytes([KYO_8]) + script)
+write("fuzz_config_reads", "kyo32g_partial", bytes([KYO_32G]) + script)
+write("fuzz_config_reads", "babble_first", bytes([KYO_32, 0xFF]))
+write("fuzz_config_reads", "short_answers", bytes([KYO_32]) + b"\x03\xf0\x9f\x00" * 8)
+
+# Async stream: byte 0 = model << 2 | op, then wire bytes; FA nn = nn ms gap
+write("fuzz_async_stream", "sensor_kyo32", bytes([KYO_32 << 2 | 1]) + SENSOR_32)
+write("fuzz_async_stream", "version_then_gap", bytes([UNKNOWN << 2 | 0]) + response(0x0000, b"KYO32G  2.13") + b"\xfa\x20")
+write("fuzz_async_stream", "partition_kyo8_split", bytes([KYO_8 << 2 | 2]) + response(0x0E68, bytes(10))[:9] + b"\xfa\x30" +
+      response(0x0E68, bytes(10))[9:])
@@ -0,0 +1,41 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Minimal assertion helpers for the native host tests.
+
+#pragma once
+
+#include <cstdio>
+
+static int host_test_failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      host_test_failures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { \
+    long long va_ = (long long) (a), vb_ = (long long) (b); \
+    if (va_ != vb_) { \
+      fprintf(stderr, "%s:%d: CHECK_EQ failed: %s (%lld) != %s (%lld)\n", __FILE__, __LINE__, #a, va_, #b, vb_); \
+      host_test_failures++; \
+    } \
+  } while (0)
+
+#define RUN_TEST(fn) \
+  do { \
+    int before_ = host_test_failures; \
+    fn(); \
+    printf("%s %s\n", host_test_failures == before_ ? "PASS" : "FAIL", #fn); \
+  } while (0)
+
+#define HOST_TEST_RESULT() (host_test_failures == 0 ? 0 : 1)
@@ -0,0 +1,416 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "kyo_panel_sim.h"
+#include "esphome/core/log.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace bentel_kyo {
+
+static const char *const TAG_SIM = "kyo_sim";
+
+// Event log base codes (docs/PROTOCOL.md section 10.25)
+static const uint16_t EVT_ALARM_PARTITION = 0x0000;
+static const uint16_t EVT_ALARM_ZONE = 0x0008;
+static const uint16_t EVT_ARM_PARTITION = 0x0130;
+static const uint16_t EVT_DISARM_PARTITION = 0x0138;
+static const uint16_t EVT_RESET_MEMORY = 0x0150;
+
+KyoPanelSim::KyoPanelSim(AlarmModel model, uint32_t seed) : model_(model), rng_(seed) {
+  switch (model) {
+    case AlarmModel::KYO_4: this->set_firmware("KYO4    2.00"); break;
+    case AlarmModel::KYO_8: this->set_firmware("KYO8    2.00"); break;
+    case AlarmModel::KYO_8G: this->set_firmware("KYO8G   2.00"); break;
+    case AlarmModel::KYO_8W: this->set_firmware("KYO8W   2.00"); break;
+    case AlarmModel::KYO_32: this->set_firmware("KYO32   1.05"); break;
+    default: this->set_firmware("KYO32G  2.13"); break;
+  }
+
+  int zones = this->is_kyo32_() ? KYO_MAX_ZONES : (model == AlarmModel::KYO_4 ? 4 : KYO_MAX_ZONES_8);
+  char name[17];
+  for (int z = 1; z <= KYO_MAX_ZONES; z++) {
+    bool enrolled = z <= zones;
+    this->set_zone_config(z, enrolled ? 0x00 : 0x18, enrolled, 0x01);
+    snprintf(name, sizeof(name), "Zone %d", z);
+    this->set_name(REG_ZONE_NAMES, z - 1, name);
+    if (enrolled)
+      this->set_zone_esn(z, 0x100000 + z);
+  }
+  for (int i = 1; i <= KYO_MAX_PARTITIONS; i++) {
+    snprintf(name, sizeof(name), "Area %d", i);
+    this->set_name(REG_PARTITION_NAMES, i - 1, name);
+    // Entry/exit delay and siren timer per partition
+    this->mem_[REG_TIMERS + (i - 1) * 2] = 30;
+    this->mem_[REG_TIMERS + (i - 1) * 2 + 1] = 30;
+    this->mem_[REG_TIMERS + 16 + (i - 1)] = 3;
+  }
+  for (int i = 1; i <= KYO_MAX_OUTPUTS; i++) {
+    snprintf(name, sizeof(name), "Output %d", i);
+    this->set_name(REG_OUTPUT_NAMES, i - 1, name);
+  }
+  for (int i = 1; i <= KYO_MAX_KEYFOBS; i++) {
+    snprintf(name, sizeof(name), "Key %d", i);
+    this->set_name(REG_KEYFOB_NAMES, i - 1, name);
+  }
+  for (int i = 1; i <= KYO_MAX_CODES; i++) {
+    snprintf(name, sizeof(name), "Code %d", i);
+    this->set_name(REG_CODE_NAMES, i - 1, name);
+  }
+
+  // Idle panel mode and no troubles (all status flag bytes 0xFF)
+  this->mem_[REG_PANEL_MODE] = 0x11;
+  this->mem_[REG_PANEL_MODE + 1] = 0x10;
+  memset(&this->mem_[REG_STATUS_FLAGS], 0xFF, 6);
+}
+
+bool KyoPanelSim::is_kyo32_() const {
+  return this->model_ == AlarmModel::KYO_32 || this->model_ == AlarmModel::KYO_32G;
+}
+
+uint16_t KyoPanelSim::partition_address_() const {
+  if (this->model_ == AlarmModel::KYO_32G)
+    return 0x1502;
+  if (this->model_ == AlarmModel::KYO_32)
+    return 0x14EC;
+  return 0x0E68;
+}
+
+// ========================================
+// State setters
+// ========================================
+
+void KyoPanelSim::set_firmware(const char *firmware) {
+  memset(&this->mem_[REG_VERSION], ' ', 12);
+  memcpy(&this->mem_[REG_VERSION], firmware, strnlen(firmware, 12));
+}
+
+void KyoPanelSim::set_zone(uint8_t zone, bool active) {
+  uint32_t bit = 1UL << (zone - 1);
+  this->zones_ = active ? (this->zones_ | bit) : (this->zones_ & ~bit);
+}
+
+void KyoPanelSim::set_zone_tamper(uint8_t zone, bool active) {
+  uint32_t bit = 1UL << (zone - 1);
+  this->zone_tamper_ = active ? (this->zone_tamper_ | bit) : (this->zone_tamper_ & ~bit);
+  if (active)
+    this->tamper_memory_ |= bit;
+}
+
+void KyoPanelSim::trigger_alarm(uint8_t zone) {
+  this->set_zone(zone, true);
+  uint8_t area = this->mem_[REG_ZONE_CONFIG + (zone - 1) * 4 + 2];
+  uint8_t affected = area & (this->armed_total_ | this->armed_partial_ | this->armed_partial_d0_);
+  if (affected == 0)
+    return;  // zone opened in a disarmed area: no alarm
+
+  this->alarm_memory_ |= 1UL << (zone - 1);
+  this->partition_alarm_ |= affected;
+  this->siren_ = true;
+  this->log_event(EVT_ALARM_ZONE + zone - 1);
+  for (int p = 0; p < KYO_MAX_PARTITIONS; p++) {
+    if (affected & (1 << p))
+      this->log_event(EVT_ALARM_PARTITION + p);
+  }
+}
+
+void KyoPanelSim::reset_alarms() {
+  this->alarm_memory_ = 0;
+  this->tamper_memory_ = this->zone_tamper_;
+  this->partition_alarm_ = 0;
+  this->siren_ = false;
+  for (int p = 0; p < this->partition_count_(); p++)
+    this->log_event(EVT_RESET_MEMORY + p);
+}
+
+void KyoPanelSim::write_memory(uint16_t address, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    this->mem_[(uint16_t) (address + i)] = data[i];
+}
+
+void KyoPanelSim::set_name(uint16_t base, uint8_t index, const char *name) {
+  uint8_t slot[16];
+  memset(slot, ' ', sizeof(slot));
+  memcpy(slot, name, strnlen(name, sizeof(slot)));
+  this->write_memory(base + index * 16, slot, sizeof(slot));
+}
+
+void KyoPanelSim::set_zone_config(uint8_t zone, uint8_t type, bool enrolled, uint8_t area_mask) {
+  const uint8_t record[4] = {type, (uint8_t) (enrolled ? 0x01 : 0x00), area_mask, 0x0F};
+  this->write_memory(REG_ZONE_CONFIG + (zone - 1) * 4, record, sizeof(record));
+}
+
+void KyoPanelSim::set_zone_esn(uint8_t zone, uint32_t esn) {
+  const uint8_t bytes[3] = {(uint8_t) (esn >> 16), (uint8_t) (esn >> 8), (uint8_t) esn};
+  this->write_memory(REG_ZONE_ESN + (zone - 1) * 3, bytes, sizeof(bytes));
+}
+
+void KyoPanelSim::set_keyfob_esn(uint8_t keyfob, uint32_t esn) {
+  const uint8_t bytes[3] = {(uint8_t) (esn >> 16), (uint8_t) (esn >> 8), (uint8_t) esn};
+  this->write_memory(REG_KEYFOB_ESN + (keyfob - 1) * 3, bytes, sizeof(bytes));
+}
+
+void KyoPanelSim::log_event(uint16_t code) {
+  const uint8_t record[7] = {(uint8_t) (code >> 8), (uint8_t) code, this->datetime_[0], this->datetime_[1],
+                             this->datetime_[2], this->datetime_[3], this->datetime_[4]};
+  this->write_memory(REG_EVENT_LOG + this->event_head_ * 7, record, sizeof(record));
+  this->event_head_ = (this->event_head_ + 1) % EVENT_LOG_SLOTS;
+  if (this->event_count_ < EVENT_LOG_SLOTS)
+    this->event_count_++;
+}
+
+// ========================================
+// Serial line
+// ========================================
+
+void KyoPanelSim::poll() {
+  // Collect request bytes (requests are served one at a time)
+  while (this->port_.available() > 0) {
+    uint8_t byte = this->port_.read();
+    if (this->rx_len_ < sizeof(this->rx_buf_))
+      this->rx_buf_[this->rx_len_++] = byte;
+  }
+
+  if (this->tx_len_ == 0)
+    this->take_request_();
+
+  // Pace queued response bytes out at the wire byte time
+  uint32_t now = this->clock_->micros();
+  while (this->tx_pos_ < this->tx_len_ && (int32_t) (now - this->tx_next_us_) >= 0) {
+    this->port_.write_array(&this->tx_buf_[this->tx_pos_++], 1);
+    this->stats_.bytes_sent++;
+    this->last_tx_us_ = this->tx_next_us_;
+    this->tx_next_us_ += this->byte_time_us_;
+  }
+  if (this->tx_len_ > 0 && this->tx_pos_ >= this->tx_len_) {
+    this->tx_len_ = 0;
+    this->tx_pos_ = 0;
+  }
+}
+
+void KyoPanelSim::take_request_() {
+  while (this->rx_len_ >= 6 && this->tx_len_ == 0) {
+    const uint8_t *req = this->rx_buf_;
+    uint8_t header_chk = (req[0] + req[1] + req[2] + req[3] + req[4]) & 0xFF;
+    bool known = req[0] == 0xF0 || req[0] == 0x0F || req[0] == 0x3C;
+    if (!known || header_chk != req[5]) {
+      // Garbage on the line: resync one byte at a time
+      this->stats_.bad_requests++;
+      memmove(this->rx_buf_, this->rx_buf_ + 1, --this->rx_len_);
+      continue;
+    }
+
+    size_t frame_len = 6;
+    if (req[0] == 0x0F) {
+      frame_len = 6 + (req[3] + 1) + 1;  // header + LEN+1 data bytes + data checksum
+      if (this->rx_len_ < frame_len)
+        return;  // wait for the rest of the write
+    }
+
+    if (req[0] == 0xF0) {
+      this->handle_read_(req);
+    } else if (req[0] == 0x0F) {
+      this->handle_write_(req, frame_len);
+    } else {
+      this->queue_response_(req, frame_len, this->turnaround_ms_);  // session barrier: echo only
+    }
+
+    this->rx_len_ -= frame_len;
+    memmove(this->rx_buf_, this->rx_buf_ + frame_len, this->rx_len_);
+  }
+}
+
+void KyoPanelSim::handle_read_(const uint8_t *req) {
+  uint16_t address = req[1] | (req[2] << 8);
+  uint8_t frame[6 + 256 + 1];
+  memcpy(frame, req, 6);
+  uint8_t *data = frame + 6;
+  size_t data_len;
+
+  if (address == REG_SENSOR_STATUS) {
+    data_len = this->build_sensor_status_(data);
+  } else if (address == this->partition_address_()) {
+    data_len = this->build_partition_status_(data);
+  } else {
+    data_len = req[3] + 1;
+    for (size_t i = 0; i < data_len; i++)
+      data[i] = this->mem_[(uint16_t) (address + i)];
+  }
+
+  uint8_t sum = 0;
+  for (size_t i = 0; i < data_len; i++)
+    sum += data[i];
+  data[data_len] = sum;
+
+  bool eeprom = (address & 0xFF00) == 0xC000;
+  this->stats_.reads++;
+  if (eeprom)
+    this->stats_.eeprom_reads++;
+  ESP_LOGV(TAG_SIM, "Read 0x%04X len=%u", address, (unsigned) data_len);
+  this->queue_response_(frame, 6 + data_len + 1, eeprom ? this->eeprom_latency_ms_ : this->turnaround_ms_);
+}
+
+void KyoPanelSim::handle_write_(const uint8_t *req, size_t len) {
+  uint16_t address = req[1] | (req[2] << 8);
+  const uint8_t *data = req + 6;
+  size_t data_len = req[3] + 1;
+  this->stats_.writes++;
+
+  switch (address) {
+    case 0xF000: {  // arm / disarm: TOTAL PARTIAL PARTIAL_D0 CRC
+      uint8_t sum = 0;
+      for (int i = 0; i < 9; i++)
+        sum += req[i];
+      if (data_len >= 4 && (uint8_t) (0x203 - sum) == data[3]) {
+        this->apply_arm_(data[0], data[1], data[2]);
+      } else {
+        ESP_LOGW(TAG_SIM, "Arm command with bad CRC ignored");
+        this->stats_.bad_requests++;
+      }
+      break;
+    }
+    case 0xF001: {  // include / exclude zone: EXCL[4] INCL[4], bytes ordered zones 25-32 first
+      for (int b = 0; b < 4; b++) {
+        uint32_t shift = (3 - b) * 8;
+        this->bypassed_ |= (uint32_t) data[b] << shift;
+        this->bypassed_ &= ~((uint32_t) data[4 + b] << shift);
+      }
+      break;
+    }
+    case 0xF003:  // date/time: DAY MONTH YEAR HOURS MINUTES SECONDS
+      memcpy(this->datetime_, data, 6);
+      break;
+    case 0xF005:  // reset alarms
+      this->reset_alarms();
+      break;
+    case 0xF006:  // outputs: ACTIVATE_MASK DEACTIVATE_MASK
+      this->outputs_ |= data[0];
+      this->outputs_ &= ~data[1];
+      break;
+    default: {  // raw configuration download
+      uint8_t sum = 0;
+      for (size_t i = 0; i < data_len; i++)
+        sum += data[i];
+      if (sum == req[len - 1]) {
+        this->write_memory(address, data, data_len);
+      } else {
+        ESP_LOGW(TAG_SIM, "Raw write to 0x%04X with bad data checksum ignored", address);
+        this->stats_.bad_requests++;
+      }
+      break;
+    }
+  }
+
+  // Writes are acknowledged by echoing the frame
+  this->queue_response_(req, len, this->turnaround_ms_);
+}
+
+void KyoPanelSim::apply_arm_(uint8_t total, uint8_t partial, uint8_t partial_d0) {
+  uint8_t was_armed = this->armed_total_ | this->armed_partial_ | this->armed_partial_d0_;
+  uint8_t now_armed = (total | partial | partial_d0) & this->partition_mask_();
+  for (int p = 0; p < this->partition_count_(); p++) {
+    uint8_t bit = 1 << p;
+    if ((now_armed & bit) && !(was_armed & bit))
+      this->log_event(EVT_ARM_PARTITION + p);
+    else if (!(now_armed & bit) && (was_armed & bit))
+      this->log_event(EVT_DISARM_PARTITION + p);
+  }
+
+  this->armed_total_ = total & this->partition_mask_();
+  this->armed_partial_ = partial & this->partition_mask_();
+  this->armed_partial_d0_ = partial_d0 & this->partition_mask_();
+
+  // Disarming silences the partitions in alarm
+  this->partition_alarm_ &= now_armed;
+  if (this->partition_alarm_ == 0)
+    this->siren_ = false;
+}
+
+void KyoPanelSim::queue_response_(const uint8_t *frame, size_t len, uint32_t latency_ms) {
+  if (this->roll_(this->faults_.drop_rate)) {
+    this->stats_.dropped++;
+    return;
+  }
+
+  memcpy(this->tx_buf_, frame, len);
+  if (this->roll_(this->faults_.truncate_rate) && len > 1) {
+    len = 1 + this->rng_() % (len - 1);
+    this->stats_.truncated++;
+  } else if (this->roll_(this->faults_.corrupt_rate)) {
+    this->tx_buf_[len - 1] ^= 0x5A;
+    this->stats_.corrupted++;
+  }
+
+  latency_ms += this->faults_.extra_delay_ms;
+  if (this->faults_.jitter_ms > 0)
+    latency_ms += this->rng_() % (this->faults_.jitter_ms + 1);
+
+  this->tx_len_ = len;
+  this->tx_pos_ = 0;
+  this->tx_next_us_ = this->clock_->micros() + latency_ms * 1000 + this->byte_time_us_;
+}
+
+// ========================================
+// Live status frames
+// ========================================
+
+size_t KyoPanelSim::build_sensor_status_(uint8_t *data) const {
+  if (!this->is_kyo32_()) {
+    data[0] = this->zones_ & 0xFF;
+    data[1] = this->zone_tamper_ & 0xFF;
+    data[2] = this->warnings_;
+    data[3] = this->partition_alarm_;
+    data[4] = this->tamper_flags_;
+    return RESP_SENSOR_KYO8 - 7;
+  }
+
+  for (int b = 0; b < 4; b++) {
+    uint32_t shift = (3 - b) * 8;  // zones 25-32 first
+    data[b] = (this->zones_ >> shift) & 0xFF;
+    data[4 + b] = (this->zone_tamper_ >> shift) & 0xFF;
+  }
+  data[8] = this->warnings_;
+  data[9] = this->partition_alarm_;
+  data[10] = this->tamper_flags_;
+  return RESP_SENSOR_KYO32 - 7;
+}
+
+size_t KyoPanelSim::build_partition_status_(uint8_t *data) const {
+  data[0] = this->armed_total_;
+  data[1] = this->armed_partial_;
+  data[2] = this->armed_partial_d0_;
+  data[3] = ~(this->armed_total_ | this->armed_partial_ | this->armed_partial_d0_) & this->partition_mask_();
+  if (!this->is_kyo32_()) {
+    // KYO4/8 family: siren on bit 6, outputs 1-5 on bits 0-4 (not on KYO8W)
+    data[4] = this->siren_ ? 0x40 : 0x00;
+    if (this->model_ != AlarmModel::KYO_8W)
+      data[4] |= this->outputs_ & 0x1F;
+    data[5] = this->bypassed_ & 0xFF;
+    data[6] = this->alarm_memory_ & 0xFF;
+    data[7] = this->tamper_memory_ & 0xFF;
+    data[8] = 0x00;
+    data[9] = 0x00;
+    return RESP_PARTITION_KYO8 - 7;
+  }
+
+  data[4] = this->siren_ ? 0x20 : 0x00;
+  data[5] = 0x00;
+  data[6] = this->model_ == AlarmModel::KYO_32G ? this->outputs_ : 0xFF;  // no readback on non-G
+  for (int b = 0; b < 4; b++) {
+    uint32_t shift = (3 - b) * 8;
+    data[7 + b] = (this->bypassed_ >> shift) & 0xFF;
+    data[11 + b] = (this->alarm_memory_ >> shift) & 0xFF;
+    data[15 + b] = (this->tamper_memory_ >> shift) & 0xFF;
+  }
+  return RESP_PARTITION_KYO32 - 7;
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
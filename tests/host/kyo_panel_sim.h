@@ -0,0 +1,179 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Simulated Bentel KYO panel for the native host build.
+//
+// Implements the register map from docs/PROTOCOL.md: live sensor and partition
+// status for every supported model, the configuration/name registers, the slow
+// 0xC0xx EEPROM region and the event log ring. Requests arrive on port(), which
+// is connected to the engine's LoopbackTransport; responses are paced out at
+// the 9600 baud 8E1 byte time after a configurable turnaround.
+
+#pragma once
+
+#include "bentel_kyo.h"
+#include "clock.h"
+#include "transport.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace esphome {
+namespace bentel_kyo {
+
+// Fault injection. Rates are probabilities per response (0.0 - 1.0).
+struct KyoSimFaults {
+  float drop_rate{0.0f};         // no answer at all
+  float corrupt_rate{0.0f};      // wrong trailing checksum
+  float truncate_rate{0.0f};     // response cut short mid-frame
+  uint32_t extra_delay_ms{0};    // added to every turnaround
+  uint32_t jitter_ms{0};         // random 0..jitter added to every turnaround
+};
+
+struct KyoSimStats {
+  uint32_t reads{0};
+  uint32_t eeprom_reads{0};
+  uint32_t writes{0};
+  uint32_t bad_requests{0};  // header checksum mismatch, resynced
+  uint32_t dropped{0};
+  uint32_t corrupted{0};
+  uint32_t truncated{0};
+  uint32_t bytes_sent{0};
+};
+
+class KyoPanelSim {
+ public:
+  // Register addresses (docs/PROTOCOL.md section 10.27)
+  static const uint16_t REG_VERSION = 0x0000;
+  static const uint16_t REG_ZONE_CONFIG = 0x009F;
+  static const uint16_t REG_TIMERS = 0x016F;
+  static const uint16_t REG_PANEL_MODE = 0x01E6;
+  static const uint16_t REG_EVENT_LOG = 0x0D27;
+  static const uint16_t REG_STATUS_FLAGS = 0x1503;
+  static const uint16_t REG_PARTITION_NAMES = 0x2BA0;
+  static const uint16_t REG_ZONE_NAMES = 0x2E00;
+  static const uint16_t REG_CODE_NAMES = 0x3000;
+  static const uint16_t REG_KEYFOB_NAMES = 0x3180;
+  static const uint16_t REG_OUTPUT_NAMES = 0x3280;
+  static const uint16_t REG_ZONE_ESN = 0xC045;
+  static const uint16_t REG_KEYFOB_ESN = 0xC0B1;
+  static const uint16_t REG_SENSOR_STATUS = 0xF004;
+
+  static const int EVENT_LOG_SLOTS = 256;
+
+  explicit KyoPanelSim(AlarmModel model = AlarmModel::KYO_32G, uint32_t seed = 1);
+
+  // Panel side of the serial line; connect the engine's transport to it
+  LoopbackTransport &port() { return this->port_; }
+
+  // Serve pending requests and emit due response bytes. Call from the harness
+  // loop (and from the yield hook while the engine busy-waits).
+  void poll();
+
+  // ---- Panel state ----
+  AlarmModel get_model() const { return this->model_; }
+  void set_firmware(const char *firmware);
+  void set_zone(uint8_t zone, bool active);
+  void set_zone_tamper(uint8_t zone, bool active);
+  void set_warnings(uint8_t flags) { this->warnings_ = flags; }
+  void set_tamper_flags(uint8_t flags) { this->tamper_flags_ = flags; }
+  // Zone alarm: sets alarm memory, partition alarm for the zone's areas and
+  // the siren, and logs the event
+  void trigger_alarm(uint8_t zone);
+  // Keypad-side arm/disarm and alarm reset (same effect as the serial writes)
+  void arm(uint8_t total, uint8_t partial = 0, uint8_t partial_d0 = 0) { this->apply_arm_(total, partial, partial_d0); }
+  void reset_alarms();
+  uint8_t get_armed_total() const { return this->armed_total_; }
+  uint8_t get_armed_partial() const { return this->armed_partial_; }
+  uint8_t get_armed_partial_d0() const { return this->armed_partial_d0_; }
+  uint8_t get_outputs() const { return this->outputs_; }
+  uint32_t get_bypassed() const { return this->bypassed_; }
+  bool is_siren_active() const { return this->siren_; }
+
+  // ---- Configuration registers ----
+  void write_memory(uint16_t address, const uint8_t *data, size_t len);
+  uint8_t read_memory(uint16_t address) const { return this->mem_[address]; }
+  void set_name(uint16_t base, uint8_t index, const char *name);  // 16-byte space-padded slot
+  void set_zone_config(uint8_t zone, uint8_t type, bool enrolled, uint8_t area_mask);
+  void set_zone_esn(uint8_t zone, uint32_t esn);
+  void set_keyfob_esn(uint8_t keyfob, uint32_t esn);
+  // Append a record to the event log ring (time is the panel clock)
+  void log_event(uint16_t code);
+  int get_event_count() const { return this->event_count_; }
+
+  // ---- Timing and faults ----
+  void set_clock(KyoClock *clock) { this->clock_ = clock; }
+  void set_turnaround_ms(uint32_t ms) { this->turnaround_ms_ = ms; }
+  void set_eeprom_latency_ms(uint32_t ms) { this->eeprom_latency_ms_ = ms; }
+  void set_byte_time_us(uint32_t us) { this->byte_time_us_ = us; }
+  KyoSimFaults &faults() { return this->faults_; }
+  const KyoSimStats &get_stats() const { return this->stats_; }
+  // Clock micros() timestamp of the last byte put on the wire
+  uint32_t get_last_tx_us() const { return this->last_tx_us_; }
+  bool is_idle() const { return this->tx_len_ == 0 && this->rx_len_ == 0; }
+
+ protected:
+  bool is_kyo32_() const;
+  uint16_t partition_address_() const;
+  uint8_t partition_count_() const { return this->is_kyo32_() ? 8 : 4; }
+  uint8_t partition_mask_() const { return this->is_kyo32_() ? 0xFF : 0x0F; }
+
+  void take_request_();
+  void handle_read_(const uint8_t *req);
+  void handle_write_(const uint8_t *req, size_t len);
+  void queue_response_(const uint8_t *frame, size_t len, uint32_t latency_ms);
+  size_t build_sensor_status_(uint8_t *data) const;
+  size_t build_partition_status_(uint8_t *data) const;
+  void apply_arm_(uint8_t total, uint8_t partial, uint8_t partial_d0);
+  bool roll_(float rate) { return rate > 0.0f && this->dist_(this->rng_) < rate; }
+
+  LoopbackTransport port_;
+  AlarmModel model_;
+  uint8_t mem_[0x10000]{};
+
+  // Live state
+  uint32_t zones_{0};
+  uint32_t zone_tamper_{0};
+  uint32_t bypassed_{0};
+  uint32_t alarm_memory_{0};
+  uint32_t tamper_memory_{0};
+  uint8_t warnings_{0};
+  uint8_t tamper_flags_{0};
+  uint8_t partition_alarm_{0};
+  uint8_t armed_total_{0};
+  uint8_t armed_partial_{0};
+  uint8_t armed_partial_d0_{0};
+  uint8_t outputs_{0};
+  bool siren_{false};
+  uint8_t datetime_[6]{1, 1, 26, 0, 0, 0};  // day, month, year-2000, hour, minute, second
+  int event_head_{0};
+  int event_count_{0};
+
+  // Request assembly / response pacing
+  uint8_t rx_buf_[64]{};
+  size_t rx_len_{0};
+  uint8_t tx_buf_[300]{};
+  size_t tx_len_{0};
+  size_t tx_pos_{0};
+  uint32_t tx_next_us_{0};
+  uint32_t last_tx_us_{0};
+
+  SystemClock system_clock_;
+  KyoClock *clock_{&this->system_clock_};
+  uint32_t turnaround_ms_{15};
+  uint32_t eeprom_latency_ms_{1000};
+  uint32_t byte_time_us_{BYTE_TIME_US};
+  KyoSimFaults faults_;
+  KyoSimStats stats_;
+  std::mt19937 rng_;
+  std::uniform_real_distribution<float> dist_{0.0f, 1.0f};
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
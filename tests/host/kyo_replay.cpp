@@ -0,0 +1,527 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+#include "kyo_replay.h"
+#include "alarm_control_panel.h"
+#include "test_kyo.h"
+#include "virtual_clock.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace esphome {
+namespace bentel_kyo {
+
+// ========================================
+// JSON Lines reader (just what the extractor emits)
+// ========================================
+
+namespace {
+
+struct JsonValue {
+  enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } type{NUL};
+  bool boolean{false};
+  double number{0};
+  std::string str;
+  std::vector<JsonValue> items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+
+  const JsonValue *get(const char *key) const {
+    for (auto &member : this->members) {
+      if (member.first == key)
+        return &member.second;
+    }
+    return nullptr;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string &text) : s_(text) {}
+
+  bool parse(JsonValue *out) {
+    if (!this->value_(out, 0))
+      return false;
+    this->skip_ws_();
+    return this->pos_ == this->s_.size();
+  }
+
+ protected:
+  void skip_ws_() {
+    while (this->pos_ < this->s_.size() && strchr(" \t\r\n", this->s_[this->pos_]) != nullptr)
+      this->pos_++;
+  }
+  bool consume_(char c) {
+    this->skip_ws_();
+    if (this->pos_ < this->s_.size() && this->s_[this->pos_] == c) {
+      this->pos_++;
+      return true;
+    }
+    return false;
+  }
+  bool literal_(const char *word) {
+    size_t len = strlen(word);
+    if (this->s_.compare(this->pos_, len, word) != 0)
+      return false;
+    this->pos_ += len;
+    return true;
+  }
+
+  bool string_(std::string *out) {
+    if (!this->consume_('"'))
+      return false;
+    while (this->pos_ < this->s_.size()) {
+      char c = this->s_[this->pos_++];
+      if (c == '"')
+        return true;
+      if (c == '\\') {
+        if (this->pos_ >= this->s_.size())
+          return false;
+        char e = this->s_[this->pos_++];
+        switch (e) {
+          case 'n': out->push_back('\n'); break;
+          case 't': out->push_back('\t'); break;
+          case 'r': out->push_back('\r'); break;
+          case 'b': out->push_back('\b'); break;
+          case 'f': out->push_back('\f'); break;
+          case 'u':
+            // Non-ASCII escapes never occur in hex fields; keep a placeholder
+            if (this->pos_ + 4 > this->s_.size())
+              return false;
+            this->pos_ += 4;
+            out->push_back('?');
+            break;
+          default: out->push_back(e); break;
+        }
+      } else {
+        out->push_back(c);
+      }
+    }
+    return false;
+  }
+
+  bool value_(JsonValue *out, int depth) {
+    if (depth > 32)
+      return false;
+    this->skip_ws_();
+    if (this->pos_ >= this->s_.size())
+      return false;
+    char c = this->s_[this->pos_];
+    if (c == '"') {
+      out->type = JsonValue::STRING;
+      return this->string_(&out->str);
+    }
+    if (c == '{') {
+      out->type = JsonValue::OBJECT;
+      this->pos_++;
+      if (this->consume_('}'))
+        return true;
+      do {
+        std::pair<std::string, JsonValue> member;
+        if (!this->string_(&member.first) || !this->consume_(':') || !this->value_(&member.second, depth + 1))
+          return false;
+        out->members.push_back(std::move(member));
+      } while (this->consume_(','));
+      return this->consume_('}');
+    }
+    if (c == '[') {
+      out->type = JsonValue::ARRAY;
+      this->pos_++;
+      if (this->consume_(']'))
+        return true;
+      do {
+        JsonValue item;
+        if (!this->value_(&item, depth + 1))
+          return false;
+        out->items.push_back(std::move(item));
+      } while (this->consume_(','));
+      return this->consume_(']');
+    }
+    if (this->literal_("true")) {
+      out->type = JsonValue::BOOL;
+      out->boolean = true;
+      return true;
+    }
+    if (this->literal_("false")) {
+      out->type = JsonValue::BOOL;
+      return true;
+    }
+    if (this->literal_("null"))
+      return true;
+
+    const char *start = this->s_.c_str() + this->pos_;
+    char *end = nullptr;
+    out->number = strtod(start, &end);
+    if (end == start)
+      return false;
+    out->type = JsonValue::NUMBER;
+    this->pos_ += end - start;
+    return true;
+  }
+
+  const std::string &s_;
+  size_t pos_{0};
+};
+
+bool parse_hex_byte(const std::string &text, uint8_t *out) {
+  if (text.size() != 2)
+    return false;
+  char *end = nullptr;
+  long value = strtol(text.c_str(), &end, 16);
+  if (*end != '\0')
+    return false;
+  *out = (uint8_t) value;
+  return true;
+}
+
+bool parse_hex_bytes(const std::string &text, std::vector<uint8_t> *out) {
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t next = text.find(' ', pos);
+    if (next == std::string::npos)
+      next = text.size();
+    if (next > pos) {
+      uint8_t byte;
+      if (!parse_hex_byte(text.substr(pos, next - pos), &byte))
+        return false;
+      out->push_back(byte);
+    }
+    pos = next + 1;
+  }
+  return true;
+}
+
+// "DD.MM.YYYY HH:MM:SS.mmm" -> ms (days counted from 1970 so midnight wraps work)
+bool parse_timestamp(const std::string &text, uint64_t *out) {
+  int day, month, year, hour, minute, second;
+  char frac[8] = "";
+  if (sscanf(text.c_str(), "%d.%d.%d %d:%d:%d.%7[0-9]", &day, &month, &year, &hour, &minute, &second, frac) < 6)
+    return false;
+  // Days from civil (Howard Hinnant)
+  int y = year - (month <= 2);
+  int era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned) (y - era * 400);
+  unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int64_t days = (int64_t) era * 146097 + (int64_t) doe - 719468;
+
+  uint32_t ms = 0;
+  for (int i = 0; i < 3; i++)
+    ms = ms * 10 + (frac[i] >= '0' && frac[i] <= '9' ? frac[i] - '0' : 0);
+  *out = (uint64_t) (((days * 24 + hour) * 60 + minute) * 60 + second) * 1000 + ms;
+  return true;
+}
+
+}  // namespace
+
+bool load_capture(const std::string &path, std::vector<CaptureRecord> *records, std::string *error) {
+  std::ifstream in(path);
+  if (!in) {
+    *error = "cannot open " + path;
+    return false;
+  }
+
+  std::string line;
+  uint32_t line_no = 0;
+  while (std::getline(in, line)) {
+    line_no++;
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+
+    JsonValue obj;
+    JsonParser parser(line);
+    if (!parser.parse(&obj) || obj.type != JsonValue::OBJECT) {
+      *error = path + ":" + std::to_string(line_no) + ": malformed JSON";
+      return false;
+    }
+
+    CaptureRecord rec;
+    rec.line = line_no;
+    const JsonValue *ts = obj.get("ts");
+    if (ts != nullptr && ts->type == JsonValue::STRING && !ts->str.empty() && !parse_timestamp(ts->str, &rec.ts_ms)) {
+      *error = path + ":" + std::to_string(line_no) + ": bad timestamp '" + ts->str + "'";
+      return false;
+    }
+    const JsonValue *type = obj.get("type");
+    rec.is_cmd = type != nullptr && type->str == "cmd";
+    const JsonValue *chk = obj.get("chk_valid");
+    if (chk != nullptr && chk->type == JsonValue::BOOL)
+      rec.chk_valid = chk->boolean ? 1 : 0;
+
+    const JsonValue *cmd = obj.get("cmd");
+    if (cmd != nullptr && cmd->type == JsonValue::STRING && !parse_hex_bytes(cmd->str, &rec.cmd)) {
+      *error = path + ":" + std::to_string(line_no) + ": bad cmd hex";
+      return false;
+    }
+    const JsonValue *data = obj.get(rec.is_cmd ? "resp_data" : "data");
+    if (data != nullptr && data->type == JsonValue::ARRAY) {
+      for (auto &item : data->items) {
+        uint8_t byte;
+        if (item.type != JsonValue::STRING || !parse_hex_byte(item.str, &byte)) {
+          *error = path + ":" + std::to_string(line_no) + ": bad response hex";
+          return false;
+        }
+        rec.resp_data.push_back(byte);
+      }
+    }
+    records->push_back(std::move(rec));
+  }
+  return true;
+}
+
+// ========================================
+// Replay
+// ========================================
+
+namespace {
+
+const char *const ACP_STATE_NAMES[] = {"DISARMED", "ARMED_HOME", "ARMED_AWAY", "ARMED_NIGHT", "ARMED_VACATION",
+                                       "ARMED_CUSTOM_BYPASS", "PENDING", "ARMING", "DISARMING", "TRIGGERED"};
+
+struct WatchedSensor {
+  BinarySensorType type;
+  uint8_t count;
+  const char *label;
+};
+
+const WatchedSensor WATCHED[] = {
+    {BinarySensorType::ZONE, KYO_MAX_ZONES, "zone"},
+    {BinarySensorType::ZONE_TAMPER, KYO_MAX_ZONES, "zone tamper"},
+    {BinarySensorType::ZONE_BYPASS, KYO_MAX_ZONES, "zone bypass"},
+    {BinarySensorType::ZONE_ALARM_MEMORY, KYO_MAX_ZONES, "zone alarm memory"},
+    {BinarySensorType::ZONE_TAMPER_MEMORY, KYO_MAX_ZONES, "zone tamper memory"},
+    {BinarySensorType::PARTITION_ALARM, KYO_MAX_PARTITIONS, "partition alarm"},
+    {BinarySensorType::OUTPUT_STATE, KYO_MAX_OUTPUTS, "output"},
+    {BinarySensorType::WARNING_MAINS_FAILURE, 1, "mains failure"},
+    {BinarySensorType::WARNING_BPI_MISSING, 1, "BPI missing"},
+    {BinarySensorType::WARNING_FUSE_FAULT, 1, "fuse fault"},
+    {BinarySensorType::WARNING_LOW_BATTERY, 1, "low battery"},
+    {BinarySensorType::WARNING_PHONE_LINE_FAULT, 1, "phone line fault"},
+    {BinarySensorType::WARNING_DEFAULT_CODES, 1, "default codes"},
+    {BinarySensorType::WARNING_WIRELESS_FAULT, 1, "wireless fault"},
+    {BinarySensorType::TAMPER_ZONE, 1, "zone tamper flag"},
+    {BinarySensorType::TAMPER_FALSE_KEY, 1, "false key"},
+    {BinarySensorType::TAMPER_BPI, 1, "BPI tamper"},
+    {BinarySensorType::TAMPER_SYSTEM, 1, "system tamper"},
+    {BinarySensorType::TAMPER_RF_JAM, 1, "RF jam"},
+    {BinarySensorType::TAMPER_WIRELESS, 1, "wireless tamper"},
+    {BinarySensorType::SIREN, 1, "siren"},
+};
+
+bool classify(const std::vector<uint8_t> &cmd, ReplayFrameKind *kind, uint8_t *op) {
+  if (cmd.size() != 6 || cmd[0] != 0xF0)
+    return false;
+  uint16_t address = cmd[1] | (cmd[2] << 8);
+  switch (address) {
+    case 0x0000: *kind = REPLAY_VERSION; *op = METRIC_OP_VERSION; return true;
+    case 0xF004: *kind = REPLAY_SENSOR; *op = METRIC_OP_SENSOR; return true;
+    case 0x1502:
+    case 0x14EC:
+    case 0x0E68: *kind = REPLAY_PARTITION; *op = METRIC_OP_PARTITION; return true;
+  }
+  if (address >= 0x0D27 && address < 0x0D27 + 28 * 0x40 && (address - 0x0D27) % 0x40 == 0 && cmd[3] == 0x3F) {
+    *kind = REPLAY_EVENT_LOG;
+    *op = METRIC_OP_VERSION;
+    return true;
+  }
+  return false;
+}
+
+const char *model_name(AlarmModel model) {
+  switch (model) {
+    case AlarmModel::KYO_4: return "KYO4";
+    case AlarmModel::KYO_8: return "KYO8";
+    case AlarmModel::KYO_8G: return "KYO8G";
+    case AlarmModel::KYO_8W: return "KYO8W";
+    case AlarmModel::KYO_32: return "KYO32";
+    case AlarmModel::KYO_32G: return "KYO32G";
+    default: return "unknown";
+  }
+}
+
+}  // namespace
+
+ReplayReport replay_capture(const std::string &path, const std::vector<CaptureRecord> &records,
+                            const ReplayOptions &options) {
+  using WallClock = std::chrono::steady_clock;
+
+  ReplayReport report;
+  report.path = path;
+  report.records = records.size();
+
+  VirtualClock clock;
+  LoopbackTransport link;  // no peer: engine TX goes nowhere, RX is injected
+  TestKyo kyo;
+  kyo.set_clock(&clock);
+  kyo.set_transport(&link);
+  kyo.set_restore_state(false);  // a capture starts from a cold boot
+  clock.advance_to_ms(1000);
+
+  uint64_t base_ms = 0;
+  for (auto &rec : records) {
+    if (rec.ts_ms != 0) {
+      base_ms = rec.ts_ms;
+      break;
+    }
+  }
+  auto rel_ms = [&]() -> uint64_t { return clock.now_us() / 1000 - 1000; };
+
+  // Observe every binary sensor and one alarm panel per partition
+  std::vector<std::unique_ptr<binary_sensor::BinarySensor>> sensors;
+  for (auto &watched : WATCHED) {
+    for (uint8_t i = 0; i < watched.count; i++) {
+      sensors.emplace_back(new binary_sensor::BinarySensor());
+      auto *sensor = sensors.back().get();
+      kyo.register_binary_sensor(sensor, watched.type, i);
+      std::string label = watched.count > 1 ? std::string(watched.label) + " " + std::to_string(i + 1) : watched.label;
+      sensor->add_on_state_callback([&report, &rel_ms, sensor, label](bool state) {
+        report.state_changes++;
+        if (sensor->publish_calls > 1 || state)
+          report.transitions.push_back({rel_ms(), label + (state ? " ON" : " OFF")});
+      });
+    }
+  }
+  std::vector<std::unique_ptr<BentelKyoAlarmPanel>> panels;
+  for (uint8_t p = 1; p <= KYO_MAX_PARTITIONS; p++) {
+    panels.emplace_back(new BentelKyoAlarmPanel());
+    auto *panel = panels.back().get();
+    panel->set_parent(&kyo);
+    panel->set_partition(p);
+    kyo.register_alarm_panel(panel);
+    panel->add_on_state_callback([&report, &rel_ms, panel, p]() {
+      report.state_changes++;
+      report.transitions.push_back({rel_ms(), "partition " + std::to_string(p) + " " +
+                                                  ACP_STATE_NAMES[panel->get_state()]});
+    });
+  }
+  kyo.setup();
+
+  // Feed one async response through loop() and time the call that parses it
+  auto feed = [&](const std::vector<uint8_t> &cmd, const std::vector<uint8_t> &resp, uint8_t op, ReplayFrameKind kind,
+                  int chk_valid) {
+    ReplayFrameStats &stats = report.kinds[kind];
+    uint8_t failures_before = kyo.consecutive_failures();
+    kyo.begin_exchange(cmd.data(), cmd.size(), op, 1000);
+
+    std::vector<uint8_t> frame(cmd);
+    frame.insert(frame.end(), resp.begin(), resp.end());
+    for (uint8_t byte : frame) {
+      clock.advance_us(BYTE_TIME_US);
+      link.inject(&byte, 1);
+      kyo.loop();
+    }
+
+    double parse_us = 0;
+    for (int tick = 0; tick < 4000 && !kyo.serial_idle() && kyo.serial_rx_index() != 0; tick++) {
+      clock.yield();
+      auto start = WallClock::now();
+      kyo.loop();
+      parse_us = std::chrono::duration<double, std::micro>(WallClock::now() - start).count();
+    }
+
+    stats.frames++;
+    stats.total_us += parse_us;
+    if (parse_us > stats.max_us)
+      stats.max_us = parse_us;
+    if (kyo.consecutive_failures() > failures_before) {
+      stats.failures++;
+      if (chk_valid == 1)
+        report.clean_failures++;
+    }
+    report.replayed++;
+  };
+
+  if (!options.firmware.empty()) {
+    static const uint8_t CMD_VERSION[6] = {0xF0, 0x00, 0x00, 0x0B, 0x00, 0xFB};
+    std::vector<uint8_t> resp(12, ' ');
+    memcpy(resp.data(), options.firmware.data(), std::min<size_t>(12, options.firmware.size()));
+    uint8_t sum = 0;
+    for (uint8_t b : resp)
+      sum += b;
+    resp.push_back(sum);
+    feed(std::vector<uint8_t>(CMD_VERSION, CMD_VERSION + 6), resp, METRIC_OP_VERSION, REPLAY_VERSION, 1);
+  }
+
+  for (auto &rec : records) {
+    if (!rec.is_cmd)
+      continue;
+    if (rec.chk_valid == 0)
+      report.bad_checksum++;
+
+    ReplayFrameKind kind;
+    uint8_t op;
+    if (!classify(rec.cmd, &kind, &op)) {
+      report.skipped++;
+      continue;
+    }
+
+    // Replay at the recorded time (records never go backwards in virtual time)
+    if (rec.ts_ms >= base_ms)
+      clock.advance_to_ms(1000 + rec.ts_ms - base_ms);
+
+    if (kind == REPLAY_EVENT_LOG) {
+      std::vector<uint8_t> frame(rec.cmd);
+      frame.insert(frame.end(), rec.resp_data.begin(), rec.resp_data.end());
+      int chunk = ((rec.cmd[1] | (rec.cmd[2] << 8)) - 0x0D27) / 0x40;
+      auto start = WallClock::now();
+      report.events_decoded += kyo.decode_event_log_chunk(frame.data(), frame.size(), chunk);
+      double us = std::chrono::duration<double, std::micro>(WallClock::now() - start).count();
+      ReplayFrameStats &stats = report.kinds[REPLAY_EVENT_LOG];
+      stats.frames++;
+      stats.total_us += us;
+      if (us > stats.max_us)
+        stats.max_us = us;
+      report.replayed++;
+      continue;
+    }
+
+    feed(rec.cmd, rec.resp_data, op, kind, rec.chk_valid);
+  }
+
+  for (auto &sensor : sensors)
+    report.publish_calls += sensor->publish_calls;
+  for (auto &panel : panels)
+    report.publish_calls += panel->publish_calls;
+  report.model = model_name(kyo.alarm_model());
+  if (kyo.model_detected())
+    report.model += std::string(" ('") + kyo.firmware() + "')";
+  return report;
+}
+
+void print_replay_report(const ReplayReport &report, FILE *out) {
+  static const char *const KIND_NAMES[REPLAY_KIND_COUNT] = {"version", "sensor", "partition", "event log"};
+
+  fprintf(out, "capture: %s\n", report.path.c_str());
+  fprintf(out, "  model: %s\n", report.model.c_str());
+  fprintf(out, "  records: %u (replayed %u, skipped %u, bad checksum %u)\n", (unsigned) report.records,
+          (unsigned) report.replayed, (unsigned) report.skipped, (unsigned) report.bad_checksum);
+  fprintf(out, "  %-10s %7s %6s %12s %12s\n", "frame", "count", "fail", "parse avg us", "parse max us");
+  for (int k = 0; k < REPLAY_KIND_COUNT; k++) {
+    const ReplayFrameStats &stats = report.kinds[k];
+    if (stats.frames == 0)
+      continue;
+    fprintf(out, "  %-10s %7u %6u %12.2f %12.2f\n", KIND_NAMES[k], (unsigned) stats.frames, (unsigned) stats.failures,
+            stats.total_us / stats.frames, stats.max_us);
+  }
+  fprintf(out, "  publishes: %u (%u state changes)\n", (unsigned) report.publish_calls,
+          (unsigned) report.state_changes);
+  if (report.events_decoded > 0)
+    fprintf(out, "  event log records decoded: %u\n", (unsigned) report.events_decoded);
+  fprintf(out, "  transitions: %u\n", (unsigned) report.transitions.size());
+  for (auto &t : report.transitions) {
+    uint64_t ms = t.ts_ms;
+    fprintf(out, "    %02u:%02u:%02u.%03u  %s\n", (unsigned) (ms / 3600000), (unsigned) (ms / 60000 % 60),
+            (unsigned) (ms / 1000 % 60), (unsigned) (ms % 1000), t.what.c_str());
+  }
+}
+
+}  // namespace bentel_kyo
+}  // namespace esphome
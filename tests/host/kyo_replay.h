@@ -0,0 +1,83 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Replays captures exported with `tools/bentel-usb-extract.py --json` through
+// the engine. Each recorded response (echo + data + checksum) is fed into the
+// async serial path byte by byte at the 9600 8E1 byte time, starting at the
+// capture timestamp in virtual time; event log chunks go to the event log
+// decoder. The report lists state transitions, publish counts and the parse
+// time per frame.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace bentel_kyo {
+
+struct CaptureRecord {
+  uint32_t line{0};
+  uint64_t ts_ms{0};      // capture timestamp, ms since the epoch of its date
+  bool is_cmd{false};     // false for unsolicited panel traffic
+  std::vector<uint8_t> cmd;
+  std::vector<uint8_t> resp_data;  // after the echo, including the checksum
+  int chk_valid{-1};      // 1 / 0, -1 when the extractor reported null
+};
+
+// Parses the JSON Lines output. Returns false (with error set) on malformed input.
+bool load_capture(const std::string &path, std::vector<CaptureRecord> *records, std::string *error);
+
+enum ReplayFrameKind : uint8_t {
+  REPLAY_VERSION = 0,
+  REPLAY_SENSOR,
+  REPLAY_PARTITION,
+  REPLAY_EVENT_LOG,
+  REPLAY_KIND_COUNT,
+};
+
+struct ReplayFrameStats {
+  uint32_t frames{0};
+  uint32_t failures{0};  // rejected by the parser
+  double total_us{0};
+  double max_us{0};
+};
+
+struct ReplayTransition {
+  uint64_t ts_ms;  // relative to the first record
+  std::string what;
+};
+
+struct ReplayReport {
+  std::string path;
+  std::string model;
+  uint32_t records{0};
+  uint32_t replayed{0};
+  uint32_t skipped{0};        // commands the engine does not parse
+  uint32_t bad_checksum{0};   // flagged invalid by the extractor
+  uint32_t clean_failures{0}; // parser rejected a frame the extractor marked valid
+  ReplayFrameStats kinds[REPLAY_KIND_COUNT];
+  uint32_t publish_calls{0};
+  uint32_t state_changes{0};
+  uint32_t events_decoded{0};
+  std::vector<ReplayTransition> transitions;
+};
+
+struct ReplayOptions {
+  std::string firmware;  // replay a version answer first (captures without one)
+};
+
+ReplayReport replay_capture(const std::string &path, const std::vector<CaptureRecord> &records,
+                            const ReplayOptions &options);
+
+void print_replay_report(const ReplayReport &report, FILE *out);
+
+}  // namespace bentel_kyo
+}  // namespace esphome
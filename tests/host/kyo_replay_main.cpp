@@ -0,0 +1,63 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// kyo_replay [--firmware STR] [--check] capture.jsonl...
+//
+// Replays bentel-usb-extract.py --json output through the engine and prints a
+// report per capture. With --check the exit status is non-zero when a frame
+// the extractor marked valid is rejected by the parser.
+
+#include "kyo_replay.h"
+
+#include <cstring>
+
+using namespace esphome::bentel_kyo;
+
+int main(int argc, char **argv) {
+  ReplayOptions options;
+  bool check = false;
+  int files = 0;
+  int status = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--check") == 0) {
+      check = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--firmware") == 0 && i + 1 < argc) {
+      options.firmware = argv[++i];
+      continue;
+    }
+    if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [--firmware STR] [--check] capture.jsonl...\n", argv[0]);
+      return 2;
+    }
+
+    files++;
+    std::vector<CaptureRecord> records;
+    std::string error;
+    if (!load_capture(argv[i], &records, &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      status = 1;
+      continue;
+    }
+    ReplayReport report = replay_capture(argv[i], records, options);
+    print_replay_report(report, stdout);
+    if (check && (report.replayed == 0 || report.clean_failures > 0)) {
+      fprintf(stderr, "%s: %u valid frame(s) rejected, %u replayed\n", argv[i], (unsigned) report.clean_failures,
+              (unsigned) report.replayed);
+      status = 1;
+    }
+  }
+
+  if (files == 0) {
+    fprintf(stderr, "usage: %s [--firmware STR] [--check] capture.jsonl...\n", argv[0]);
+    return 2;
+  }
+  return status;
+}
@@ -0,0 +1,163 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Stand-in for the ESPHome main loop in virtual time: calls update() on the
+// polling interval and loop() on every iteration unless the component has
+// disabled it. Iterations are loop_interval apart, or one clock step apart
+// while a HighFrequencyLoopRequester is started. When the engine has no
+// exchange in flight and every peripheral is idle, time jumps straight to the
+// next update() (or an earlier wakeup loop() asked for) instead of ticking
+// through the gap.
+
+#pragma once
+
+#include "bentel_kyo.h"
+#include "virtual_clock.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace bentel_kyo {
+
+class KyoScheduler {
+ public:
+  KyoScheduler(VirtualClock *clock, PollingComponent *component, uint32_t update_interval_ms = 500) : clock_(clock) {
+    this->add_component(component, update_interval_ms);
+  }
+
+  // Another component on the same main loop (a second hub), in call order
+  void add_component(PollingComponent *component, uint32_t update_interval_ms = 500) {
+    this->entries_.push_back({component, update_interval_ms, 0});
+  }
+
+  // Returns true while the component or a peripheral still has work in flight
+  void add_busy_check(std::function<bool()> &&check) { this->busy_checks_.push_back(std::move(check)); }
+  // Returns the next millis() at which loop() has timed work, or 0 for none
+  void add_wakeup(std::function<uint32_t()> &&wakeup) { this->wakeups_.push_back(std::move(wakeup)); }
+  // For the first component; add_component() takes the others'
+  void set_update_interval(uint32_t ms) { this->entries_.front().update_interval_ms = ms; }
+  // App loop_interval (16ms in ESPHome), 0 to always step like high frequency
+  void set_loop_interval(uint32_t ms) { this->loop_interval_ms_ = ms; }
+  // false: call loop() every iteration and ignore high frequency requests, as
+  // for a component that uses neither
+  void set_loop_control(bool enabled) { this->loop_control_ = enabled; }
+
+  void run_for(uint32_t ms) { this->run_until(this->clock_->now_us() / 1000 + ms); }
+
+  void run_until(uint64_t end_ms) {
+    while (this->clock_->now_us() / 1000 < end_ms) {
+      uint64_t start_us = this->clock_->now_us();
+      uint64_t now_ms = start_us / 1000;
+      // Each component's update() and loop() run in turn, like App.loop();
+      // time spent blocking in one delays the next
+      for (auto &entry : this->entries_) {
+        if (this->clock_->now_us() / 1000 >= entry.next_update_ms) {
+          entry.next_update_ms = this->clock_->now_us() / 1000 + entry.update_interval_ms;
+          entry.component->update();
+          this->updates_++;
+        }
+        if (this->loop_enabled_(entry)) {
+          entry.component->loop();
+          this->loops_++;
+        }
+      }
+
+      if (this->is_busy_()) {
+        bool high_frequency = this->loop_control_ && HighFrequencyLoopRequester::is_high_frequency();
+        uint64_t next_us = start_us + (uint64_t) this->loop_interval_ms_ * 1000;
+        if (high_frequency || this->clock_->now_us() >= next_us) {
+          this->clock_->yield();
+        } else {
+          this->clock_->advance_us(next_us - this->clock_->now_us());
+        }
+      } else {
+        uint64_t target = end_ms;
+        for (auto &entry : this->entries_) {
+          if (entry.next_update_ms < target)
+            target = entry.next_update_ms;
+        }
+        uint64_t wake = this->next_wakeup_ms_(now_ms);
+        if (wake > now_ms && wake < target)
+          target = wake;
+        // An enabled loop() still runs every interval, with or without work
+        uint64_t next_loop_ms = now_ms + (this->loop_interval_ms_ > 0 ? this->loop_interval_ms_ : 1);
+        if (this->any_loop_enabled_() && next_loop_ms < target)
+          target = next_loop_ms;
+        this->clock_->advance_to_ms(target);
+      }
+    }
+  }
+
+  // Run until pred() holds or max_ms of virtual time passes
+  bool run_until(const std::function<bool()> &pred, uint32_t max_ms) {
+    uint64_t end_ms = this->clock_->now_us() / 1000 + max_ms;
+    while (!pred() && this->clock_->now_us() / 1000 < end_ms)
+      this->run_for(10);
+    return pred();
+  }
+
+  uint32_t get_updates() const { return this->updates_; }
+  uint64_t get_loops() const { return this->loops_; }
+
+ protected:
+  struct Entry {
+    PollingComponent *component;
+    uint32_t update_interval_ms;
+    uint64_t next_update_ms;
+  };
+
+  bool loop_enabled_(const Entry &entry) const {
+    return !this->loop_control_ ||
+           (entry.component->get_component_state() & COMPONENT_STATE_MASK) != COMPONENT_STATE_LOOP_DONE;
+  }
+
+  bool any_loop_enabled_() const {
+    for (auto &entry : this->entries_) {
+      if (this->loop_enabled_(entry))
+        return true;
+    }
+    return false;
+  }
+
+  bool is_busy_() const {
+    for (auto &check : this->busy_checks_) {
+      if (check())
+        return true;
+    }
+    return false;
+  }
+
+  // Wakeups are 32-bit millis() values; place them relative to the 64-bit now
+  uint64_t next_wakeup_ms_(uint64_t now_ms) const {
+    uint64_t next = UINT64_MAX;
+    for (auto &wakeup : this->wakeups_) {
+      uint32_t at = wakeup();
+      if (at == 0)
+        continue;
+      int32_t delta = (int32_t) (at - (uint32_t) now_ms);
+      uint64_t abs = delta > 0 ? now_ms + delta : now_ms + 1;
+      if (abs < next)
+        next = abs;
+    }
+    return next;
+  }
+
+  VirtualClock *clock_;
+  std::vector<Entry> entries_;
+  uint32_t updates_{0};
+  uint64_t loops_{0};
+  uint32_t loop_interval_ms_{16};
+  bool loop_control_{true};
+  std::vector<std::function<bool()>> busy_checks_;
+  std::vector<std::function<uint32_t()>> wakeups_;
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
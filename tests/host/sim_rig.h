@@ -0,0 +1,54 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Engine + simulated panel on a loopback pair, running in virtual time.
+
+#pragma once
+
+#include "kyo_panel_sim.h"
+#include "kyo_scheduler.h"
+#include "test_kyo.h"
+#include "virtual_clock.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+struct SimRig {
+  // setup=false leaves kyo.setup() to the test, for entities that must be
+  // registered before it (as ESPHome codegen does)
+  explicit SimRig(AlarmModel model = AlarmModel::KYO_32G, uint32_t seed = 1, bool setup = true)
+      : sim(model, seed), scheduler(&this->clock, &this->kyo) {
+    global_preferences->clear();  // a fresh device: nothing saved from another rig
+    this->link.connect(&this->sim.port());
+    this->kyo.set_transport(&this->link);
+    this->kyo.set_clock(&this->clock);
+    this->sim.set_clock(&this->clock);
+    this->clock.add_listener([this]() { this->sim.poll(); });
+    this->scheduler.add_busy_check([this]() {
+      return !this->kyo.serial_idle() || !this->sim.is_idle() || this->link.available() > 0;
+    });
+    this->scheduler.add_wakeup([this]() { return this->kyo.is_recovering() ? this->kyo.next_probe_ms() : 0; });
+    if (setup)
+      this->kyo.setup();
+  }
+
+  void run_for(uint32_t ms) { this->scheduler.run_for(ms); }
+  bool run_until_config_done(uint32_t max_ms = 300000) {
+    return this->scheduler.run_until([this]() { return this->kyo.config_done(); }, max_ms);
+  }
+  uint32_t now_ms() { return this->clock.millis(); }
+
+  VirtualClock clock;
+  KyoPanelSim sim;
+  LoopbackTransport link;
+  TestKyo kyo;
+  KyoScheduler scheduler;
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
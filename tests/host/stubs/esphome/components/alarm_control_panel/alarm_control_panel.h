@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace alarm_control_panel {
+
+enum AlarmControlPanelState : uint8_t {
+  ACP_STATE_DISARMED = 0,
+  ACP_STATE_ARMED_HOME = 1,
+  ACP_STATE_ARMED_AWAY = 2,
+  ACP_STATE_ARMED_NIGHT = 3,
+  ACP_STATE_ARMED_VACATION = 4,
+  ACP_STATE_ARMED_CUSTOM_BYPASS = 5,
+  ACP_STATE_PENDING = 6,
+  ACP_STATE_ARMING = 7,
+  ACP_STATE_DISARMING = 8,
+  ACP_STATE_TRIGGERED = 9,
+};
+
+enum AlarmControlPanelFeature : uint8_t {
+  ACP_FEAT_ARM_HOME = 1 << 0,
+  ACP_FEAT_ARM_AWAY = 1 << 1,
+  ACP_FEAT_ARM_NIGHT = 1 << 2,
+  ACP_FEAT_TRIGGER = 1 << 3,
+  ACP_FEAT_ARM_CUSTOM_BYPASS = 1 << 4,
+  ACP_FEAT_ARM_VACATION = 1 << 5,
+};
+
+class AlarmControlPanelCall {
+ public:
+  AlarmControlPanelCall &set_state(AlarmControlPanelState state) {
+    this->state_ = state;
+    return *this;
+  }
+  AlarmControlPanelCall &set_code(const std::string &code) {
+    this->code_ = code;
+    return *this;
+  }
+  const optional<AlarmControlPanelState> &get_state() const { return this->state_; }
+  const optional<std::string> &get_code() const { return this->code_; }
+
+ protected:
+  optional<AlarmControlPanelState> state_;
+  optional<std::string> code_;
+};
+
+class AlarmControlPanel {
+ public:
+  virtual ~AlarmControlPanel() = default;
+
+  void publish_state(AlarmControlPanelState state) {
+    this->publish_calls++;
+    if (state == this->current_state_)
+      return;
+    this->current_state_ = state;
+    for (auto &callback : this->callbacks_)
+      callback();
+  }
+  AlarmControlPanelState get_state() const { return this->current_state_; }
+  void add_on_state_callback(std::function<void()> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+  void make_call(const AlarmControlPanelCall &call) { this->control(call); }
+
+  virtual uint32_t get_supported_features() const = 0;
+  virtual bool get_requires_code() const = 0;
+  virtual bool get_requires_code_to_arm() const = 0;
+
+  uint32_t publish_calls{0};
+
+ protected:
+  virtual void control(const AlarmControlPanelCall &call) = 0;
+
+  AlarmControlPanelState current_state_{ACP_STATE_DISARMED};
+  std::vector<std::function<void()>> callbacks_;
+};
+
+}  // namespace alarm_control_panel
+}  // namespace esphome
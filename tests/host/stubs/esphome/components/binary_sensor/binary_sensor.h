@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace binary_sensor {
+
+// Host stand-in with ESPHome's de-duplication semantics: callbacks only run on
+// the first publish and on state changes. publish_calls counts every call.
+class BinarySensor {
+ public:
+  void publish_state(bool new_state) {
+    this->publish_calls++;
+    if (this->has_state_ && this->state == new_state)
+      return;
+    this->has_state_ = true;
+    this->state = new_state;
+    for (auto &callback : this->callbacks_)
+      callback(new_state);
+  }
+  void publish_initial_state(bool new_state) {
+    this->has_state_ = false;
+    this->publish_state(new_state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(bool)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+
+  void set_name(const std::string &name) { this->name_ = name; }
+  const std::string &get_name() const { return this->name_; }
+  void set_disabled_by_default(bool disabled) {}
+
+  bool state{false};
+  uint32_t publish_calls{0};
+
+ protected:
+  bool has_state_{false};
+  std::string name_;
+  std::vector<std::function<void(bool)>> callbacks_;
+};
+
+}  // namespace binary_sensor
+}  // namespace esphome
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float new_state) {
+    this->publish_calls++;
+    this->state = new_state;
+    this->has_state_ = true;
+    for (auto &callback : this->callbacks_)
+      callback(new_state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+  void set_disabled_by_default(bool disabled) {}
+
+  float state{0.0f};
+  uint32_t publish_calls{0};
+
+ protected:
+  bool has_state_{false};
+  std::vector<std::function<void(float)>> callbacks_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor {
+ public:
+  void publish_state(const std::string &new_state) {
+    this->publish_calls++;
+    this->state = new_state;
+    this->has_state_ = true;
+    for (auto &callback : this->callbacks_)
+      callback(new_state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(std::string)> &&callback) {
+    this->callbacks_.push_back(std::move(callback));
+  }
+  void set_disabled_by_default(bool disabled) {}
+
+  std::string state;
+  uint32_t publish_calls{0};
+
+ protected:
+  bool has_state_{false};
+  std::vector<std::function<void(std::string)>> callbacks_;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace uart {
+
+// Host stand-in: no hardware behind it, the engine talks to a KyoTransport.
+class UARTDevice {
+ public:
+  UARTDevice() = default;
+
+  int available() { return 0; }
+  uint8_t read() { return 0; }
+  void write_array(const uint8_t *data, size_t len) {}
+};
+
+}  // namespace uart
+}  // namespace esphome
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+namespace setup_priority {
+static const float BUS = 1000.0f;
+static const float IO = 900.0f;
+static const float HARDWARE = 800.0f;
+static const float DATA = 600.0f;
+static const float PROCESSOR = 400.0f;
+static const float WIFI = 250.0f;
+static const float AFTER_WIFI = 200.0f;
+static const float AFTER_CONNECTION = 100.0f;
+static const float LATE = -100.0f;
+}  // namespace setup_priority
+
+static const uint8_t COMPONENT_STATE_MASK = 0x07;
+static const uint8_t COMPONENT_STATE_LOOP = 0x02;
+static const uint8_t COMPONENT_STATE_LOOP_DONE = 0x04;
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+
+  void mark_failed() { this->failed_ = true; }
+  bool is_failed() const { return this->failed_; }
+
+  // The main loop skips loop() of a component in LOOP_DONE
+  void disable_loop() { this->component_state_ = COMPONENT_STATE_LOOP_DONE; }
+  void enable_loop() { this->component_state_ = COMPONENT_STATE_LOOP; }
+  uint8_t get_component_state() const { return this->component_state_; }
+
+ protected:
+  bool failed_{false};
+  uint8_t component_state_{COMPONENT_STATE_LOOP};
+};
+
+class PollingComponent : public Component {
+ public:
+  PollingComponent() = default;
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+  virtual void update() = 0;
+  virtual void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  virtual uint32_t get_update_interval() const { return this->update_interval_; }
+
+ protected:
+  uint32_t update_interval_{500};
+};
+
+}  // namespace esphome
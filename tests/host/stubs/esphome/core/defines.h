@@ -0,0 +1,3 @@
+#pragma once
+// Host build: feature defines are passed on the compiler command line
+// (see tests/host/CMakeLists.txt) instead of being generated by codegen.
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+void yield();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// Host only: runs on every yield()/delay(), so simulated peripherals keep
+// serving bytes while the engine busy-waits inside a blocking exchange.
+void host_set_yield_hook(std::function<void()> hook);
+
+}  // namespace esphome
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+template<typename T> std::string to_string(T value) { return std::to_string(value); }
+
+uint32_t random_uint32();
+uint32_t fnv1_hash(const std::string &str);
+
+// Main loop runs without its loop_interval sleep while any requester is started
+class HighFrequencyLoopRequester {
+ public:
+  ~HighFrequencyLoopRequester() { this->stop(); }  // host only: rigs come and go within one process
+  void start() {
+    if (this->started_)
+      return;
+    num_requests++;
+    this->started_ = true;
+  }
+  void stop() {
+    if (!this->started_)
+      return;
+    num_requests--;
+    this->started_ = false;
+  }
+  static bool is_high_frequency() { return num_requests > 0; }
+
+ protected:
+  bool started_{false};
+  static uint8_t num_requests;
+};
+
+}  // namespace esphome
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+#include <cstdio>
+
+namespace esphome {
+
+enum HostLogLevel : int {
+  HOST_LOG_NONE = 0,
+  HOST_LOG_ERROR,
+  HOST_LOG_WARN,
+  HOST_LOG_INFO,
+  HOST_LOG_CONFIG,
+  HOST_LOG_DEBUG,
+  HOST_LOG_VERBOSE,
+};
+
+// Messages above this level are discarded (default: warnings and errors)
+extern int host_log_level;
+
+void host_log(int level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+// Where log lines go (stderr when null)
+void host_set_log_file(FILE *file);
+
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::host_log(::esphome::HOST_LOG_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host_log(::esphome::HOST_LOG_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host_log(::esphome::HOST_LOG_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host_log(::esphome::HOST_LOG_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host_log(::esphome::HOST_LOG_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host_log(::esphome::HOST_LOG_VERBOSE, tag, __VA_ARGS__)
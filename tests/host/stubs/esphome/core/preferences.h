@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace esphome {
+
+// In-memory stand-in for ESPHome's flash/RTC preferences. Slots survive
+// across component instances (a simulated reboot) until host_clear_preferences().
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  ESPPreferenceObject(std::vector<uint8_t> *slot, size_t length) : slot_(slot), length_(length) {}
+
+  template<typename T> bool save(const T *src) {
+    if (this->slot_ == nullptr || sizeof(T) != this->length_)
+      return false;
+    this->slot_->assign(reinterpret_cast<const uint8_t *>(src), reinterpret_cast<const uint8_t *>(src) + sizeof(T));
+    this->saves++;
+    return true;
+  }
+  template<typename T> bool load(T *dest) {
+    if (this->slot_ == nullptr || this->slot_->size() != sizeof(T))
+      return false;
+    memcpy(dest, this->slot_->data(), sizeof(T));
+    return true;
+  }
+
+  uint32_t saves{0};
+
+ protected:
+  std::vector<uint8_t> *slot_{nullptr};
+  size_t length_{0};
+};
+
+class ESPPreferences {
+ public:
+  ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) {
+    (void) in_flash;
+    return ESPPreferenceObject(&this->slots_[type], length);
+  }
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash) {
+    return this->make_preference(sizeof(T), type, in_flash);
+  }
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type) {
+    return this->make_preference(sizeof(T), type, false);
+  }
+  bool sync() { return true; }
+  void clear() { this->slots_.clear(); }
+
+ protected:
+  std::map<uint32_t, std::vector<uint8_t>> slots_;
+};
+
+extern ESPPreferences *global_preferences;
+
+}  // namespace esphome
@@ -0,0 +1,87 @@
+/*
+ * Host implementations of the ESPHome HAL/logging functions used by the
+ * bentel_kyo component.
+ */
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+namespace esphome {
+
+static const auto HOST_EPOCH = std::chrono::steady_clock::now();
+
+int host_log_level = HOST_LOG_WARN;
+
+static FILE *log_file = nullptr;
+
+void host_set_log_file(FILE *file) { log_file = file; }
+
+static std::function<void()> yield_hook;
+
+void host_set_yield_hook(std::function<void()> hook) { yield_hook = std::move(hook); }
+
+uint32_t millis() {
+  return (uint32_t) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - HOST_EPOCH)
+      .count();
+}
+
+uint32_t micros() {
+  return (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - HOST_EPOCH)
+      .count();
+}
+
+void yield() {
+  if (yield_hook)
+    yield_hook();
+  std::this_thread::yield();
+}
+
+void delay(uint32_t ms) {
+  uint32_t start = millis();
+  while (millis() - start < ms)
+    yield();
+}
+
+void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+uint32_t random_uint32() {
+  static std::mt19937 rng(0x4B594F);  // fixed seed: host runs are reproducible
+  return rng();
+}
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= (uint8_t) c;
+  }
+  return hash;
+}
+
+uint8_t HighFrequencyLoopRequester::num_requests = 0;
+
+static ESPPreferences host_preferences;
+ESPPreferences *global_preferences = &host_preferences;
+
+void host_log(int level, const char *tag, const char *format, ...) {
+  if (level > host_log_level)
+    return;
+  static const char LEVEL_CHARS[] = "-EWICDV";
+  FILE *out = log_file != nullptr ? log_file : stderr;
+  fprintf(out, "[%c][%s] ", LEVEL_CHARS[level], tag);
+  va_list args;
+  va_start(args, format);
+  vfprintf(out, format, args);
+  va_end(args);
+  fputc('\n', out);
+}
+
+}  // namespace esphome
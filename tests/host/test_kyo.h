@@ -0,0 +1,57 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// BentelKyo with read access to its parsed state, shared by the host tests.
+
+#pragma once
+
+#include "bentel_kyo.h"
+
+namespace esphome {
+namespace bentel_kyo {
+
+class TestKyo : public BentelKyo {
+ public:
+  bool model_detected() const { return this->model_detected_; }
+  AlarmModel alarm_model() const { return this->alarm_model_; }
+  const char *firmware() const { return this->firmware_version_; }
+  bool communication_ok() const { return this->communication_ok_; }
+  bool serial_idle() const { return this->serial_state_ == SerialState::IDLE; }
+  bool config_done() const { return this->config_read_step_ >= 13; }
+  bool zone_state(int zone) const { return this->zone_state_[zone - 1]; }
+  bool zone_bypass(int zone) const { return this->zone_bypass_[zone - 1]; }
+  bool zone_alarm_memory(int zone) const { return this->zone_alarm_memory_[zone - 1]; }
+  bool partition_armed_total(int partition) const { return this->partition_armed_total_[partition - 1]; }
+  bool partition_alarm(int partition) const { return this->partition_alarm_[partition - 1]; }
+  bool siren_active() const { return this->siren_active_; }
+  bool output_state(int output) const { return this->output_state_[output - 1]; }
+  const std::string &zone_name(int zone) const { return this->zone_name_[zone - 1]; }
+  const std::string &zone_esn(int zone) const { return this->zone_esn_[zone - 1]; }
+  uint8_t zone_area_mask(int zone) const { return this->zone_area_mask_[zone - 1]; }
+  uint8_t partition_entry_delay(int partition) const { return this->partition_entry_delay_[partition - 1]; }
+  bool event_log_pending() const { return this->event_log_read_pending_; }
+  int event_log_entries() const { return this->event_log_entries_logged_; }
+  int serial_rx_index() const { return this->serial_rx_index_; }
+  uint8_t consecutive_failures() const { return this->consecutive_failures_; }
+  uint32_t next_probe_ms() const { return this->next_probe_ms_; }
+  bool model_restored() const { return this->model_restored_; }
+  const KyoSavedState &saved_state() const { return this->saved_state_; }
+  uint32_t state_saves() const { return this->state_pref_.saves; }
+
+  // Start an async exchange as if update() had sent cmd (op: a MetricOp)
+  void begin_exchange(const uint8_t *cmd, int cmd_len, uint8_t op, uint32_t timeout_ms) {
+    this->send_command_async_(cmd, cmd_len, op, timeout_ms);
+  }
+  void read_zone_names() { this->read_zone_names_(); }
+  int decode_event_log_chunk(const uint8_t *rx, int count, int chunk) {
+    return this->decode_event_log_chunk_(rx, count, chunk);
+  }
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
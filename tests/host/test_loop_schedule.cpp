@@ -0,0 +1,138 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Event-driven loop(): off while idle, high frequency while an exchange is in
+// flight, on while probing a lost panel. Measured against the same engine on a
+// main loop that calls loop() every 16ms regardless.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include <cstdio>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+struct PollStats {
+  uint32_t exchanges;
+  uint64_t busy_us;     // command sent to poll cycle done, summed
+  uint64_t idle_loops;  // loop() calls with nothing in flight
+};
+
+// A minute of status polling on a quiet panel
+PollStats quiet_minute(bool loop_control) {
+  SimRig rig(AlarmModel::KYO_32G);
+  rig.scheduler.set_loop_control(loop_control);
+  CHECK(rig.run_until_config_done());
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 1000));
+
+  // Listeners run after each clock advance, so a change seen now happened at
+  // the previous advance
+  PollStats stats{};
+  bool idle = true;
+  uint64_t prev_us = rig.clock.now_us(), start_us = 0;
+  uint64_t idle_since_loops = rig.scheduler.get_loops();
+  bool active = true;
+  rig.clock.add_listener([&]() {
+    bool now_idle = rig.kyo.serial_idle();
+    if (active && idle && !now_idle) {
+      // (less the loop() that ran after update() sent the poll)
+      start_us = prev_us;
+      stats.idle_loops += rig.scheduler.get_loops() - idle_since_loops - 1;
+    }
+    if (active && !idle && now_idle) {
+      stats.exchanges++;
+      stats.busy_us += prev_us - start_us;
+      idle_since_loops = rig.scheduler.get_loops();
+    }
+    idle = now_idle;
+    prev_us = rig.clock.now_us();
+  });
+  rig.run_for(60000);
+  active = false;
+  CHECK(rig.kyo.communication_ok());
+  CHECK_EQ(rig.kyo.get_metrics().timeouts[1], 0);
+  return stats;
+}
+
+void test_loop_only_while_in_flight() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(1000);
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 1000));
+
+  // Between polls: loop() is off and nothing asks for high frequency
+  CHECK(rig.kyo.serial_idle());
+  CHECK_EQ(rig.kyo.get_component_state(), COMPONENT_STATE_LOOP_DONE);
+  CHECK(!HighFrequencyLoopRequester::is_high_frequency());
+
+  // update() sends the sensor poll: both come back on until it is answered
+  rig.scheduler.run_until([&]() { return !rig.kyo.serial_idle(); }, 1000);
+  CHECK_EQ(rig.kyo.get_component_state(), COMPONENT_STATE_LOOP);
+  CHECK(HighFrequencyLoopRequester::is_high_frequency());
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.get_component_state() == COMPONENT_STATE_LOOP_DONE; }, 1000));
+  CHECK(!HighFrequencyLoopRequester::is_high_frequency());
+
+  // Pausing polling mid-exchange turns both off
+  rig.scheduler.run_until([&]() { return !rig.kyo.serial_idle(); }, 1000);
+  rig.kyo.set_polling_enabled(false);
+  CHECK_EQ(rig.kyo.get_component_state(), COMPONENT_STATE_LOOP_DONE);
+  CHECK(!HighFrequencyLoopRequester::is_high_frequency());
+  rig.run_for(5000);
+  CHECK(rig.kyo.serial_idle());
+  rig.kyo.set_polling_enabled(true);
+  rig.run_for(1000);
+  CHECK(rig.kyo.communication_ok());
+}
+
+void test_loop_on_while_probing() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(5000);
+  CHECK(rig.kyo.is_recovering());
+
+  // Waiting for the next probe: loop() runs, at the normal interval
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 5000));
+  CHECK_EQ(rig.kyo.get_component_state(), COMPONENT_STATE_LOOP);
+  CHECK(!HighFrequencyLoopRequester::is_high_frequency());
+
+  rig.sim.faults().drop_rate = 0.0f;
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.communication_ok(); }, 10000));
+  rig.run_for(1000);
+  CHECK_EQ(rig.kyo.get_component_state(), COMPONENT_STATE_LOOP_DONE);
+}
+
+void test_time_saved() {
+  PollStats always = quiet_minute(false);
+  PollStats scheduled = quiet_minute(true);
+  double always_ms = always.busy_us / 1000.0 / always.exchanges;
+  double scheduled_ms = scheduled.busy_us / 1000.0 / scheduled.exchanges;
+  printf("idle loop() calls per minute: %llu every iteration, %llu event-driven\n",
+         (unsigned long long) always.idle_loops, (unsigned long long) scheduled.idle_loops);
+  printf("poll cycle (sensor + partition): %.1fms every iteration, %.1fms event-driven\n", always_ms, scheduled_ms);
+
+  // One poll cycle per update() either way
+  CHECK(always.exchanges >= 110 && scheduled.exchanges >= 110);
+  // Every 16ms between polls, against none at all
+  CHECK(always.idle_loops >= 2500);
+  CHECK_EQ(scheduled.idle_loops, 0);
+  // Frame ends are seen within a clock step instead of a loop interval later
+  CHECK(scheduled_ms + 20 < always_ms);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_loop_only_while_in_flight);
+  RUN_TEST(test_loop_on_while_probing);
+  RUN_TEST(test_time_saved);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Runtime metrics against the simulated panel: counters on a clean bus, error
+// attribution per operation under injected faults, and the published sensors.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include <cmath>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+uint32_t total(const uint32_t *counters) {
+  uint32_t sum = 0;
+  for (int i = 0; i < METRIC_OP_COUNT; i++)
+    sum += counters[i];
+  return sum;
+}
+
+void test_clean_bus_counters() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  KyoMetrics before = rig.kyo.get_metrics();
+  rig.run_for(60000);
+  const KyoMetrics &m = rig.kyo.get_metrics();
+
+  // 500ms update interval: one sensor+partition cycle per update
+  uint32_t polls = m.polls - before.polls;
+  CHECK(polls >= 110 && polls <= 120);
+  CHECK_EQ(total(m.timeouts), 0);
+  CHECK_EQ(total(m.length_errors), 0);
+  CHECK_EQ(total(m.checksum_errors), 0);
+
+  // 18-byte sensor frame at 9600 8E1 plus turnaround
+  CHECK(m.rtt_samples > 2 * polls);
+  CHECK(m.rtt_min_ms >= 20 && m.rtt_max_ms <= 80);
+  CHECK(m.rtt_avg_ms >= m.rtt_min_ms && m.rtt_avg_ms <= m.rtt_max_ms);
+
+  // Idle panel: every frame matches the cache (a poll preempted by the periodic
+  // blocking re-read is never parsed)
+  uint32_t lookups = m.cache_lookups - before.cache_lookups;
+  CHECK(lookups >= 2 * polls - 4 && lookups <= 2 * polls);
+  CHECK(m.cache_hits - before.cache_hits >= lookups - 4);
+
+  CHECK((m.bytes_tx - before.bytes_tx) >= polls * 12);
+  CHECK((m.bytes_rx - before.bytes_rx) >= (polls - 2) * (RESP_SENSOR_KYO32 + RESP_PARTITION_KYO32));
+  CHECK(m.blocked_ms > before.blocked_ms);  // periodic panel mode / status flags re-read
+}
+
+void test_errors_attributed_per_op() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  rig.sim.faults().corrupt_rate = 0.2f;
+  rig.sim.faults().truncate_rate = 0.2f;
+  rig.run_for(20000);
+  rig.sim.faults() = KyoSimFaults{};
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(3000);
+  rig.sim.faults() = KyoSimFaults{};
+
+  const KyoMetrics &m = rig.kyo.get_metrics();
+  CHECK(m.checksum_errors[METRIC_OP_SENSOR] + m.checksum_errors[METRIC_OP_PARTITION] > 0);
+  CHECK(m.length_errors[METRIC_OP_SENSOR] + m.length_errors[METRIC_OP_PARTITION] > 0);
+  CHECK(m.timeouts[METRIC_OP_SENSOR] > 0);
+  CHECK_EQ(m.timeouts[METRIC_OP_VERSION], 0);
+  CHECK_EQ(m.checksum_errors[METRIC_OP_VERSION], 0);
+
+  // A blocking register read that never gets an answer
+  rig.sim.faults().drop_rate = 1.0f;
+  uint32_t blocking_before = m.timeouts[METRIC_OP_BLOCKING];
+  rig.kyo.activate_output(1);
+  CHECK_EQ(m.timeouts[METRIC_OP_BLOCKING], blocking_before + 1);
+}
+
+void test_sensors_published_per_window() {
+  SimRig rig(AlarmModel::KYO_32G);
+  sensor::Sensor polls, rtt, hit_rate, checksum_all, checksum_sensor, blocked;
+  rig.kyo.register_metric_sensor(&polls, METRIC_POLLS_PER_MINUTE);
+  rig.kyo.register_metric_sensor(&rtt, METRIC_POLL_RTT_AVG);
+  rig.kyo.register_metric_sensor(&hit_rate, METRIC_CACHE_HIT_RATE);
+  rig.kyo.register_metric_sensor(&checksum_all, METRIC_CHECKSUM_ERRORS);
+  rig.kyo.register_metric_sensor(&checksum_sensor, METRIC_CHECKSUM_ERRORS, METRIC_OP_SENSOR);
+  rig.kyo.register_metric_sensor(&blocked, METRIC_BLOCKED_TIME);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2 * METRICS_PUBLISH_INTERVAL_MS);
+
+  CHECK(polls.publish_calls >= 2);
+  CHECK(polls.state >= 110 && polls.state <= 121);
+  CHECK(!std::isnan(rtt.state) && rtt.state > 0);
+  CHECK(hit_rate.state > 90.0f);
+  CHECK_EQ(checksum_all.state, 0.0f);
+  CHECK(blocked.state > 0.0f && blocked.state < 10.0f);
+
+  rig.sim.faults().corrupt_rate = 0.3f;
+  rig.run_for(METRICS_PUBLISH_INTERVAL_MS);
+  const KyoMetrics &m = rig.kyo.get_metrics();
+  CHECK(checksum_sensor.state > 0.0f);
+  CHECK(checksum_all.state >= checksum_sensor.state);
+  CHECK(checksum_sensor.state <= m.checksum_errors[METRIC_OP_SENSOR]);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_clean_bus_counters);
+  RUN_TEST(test_errors_attributed_per_op);
+  RUN_TEST(test_sensors_published_per_window);
+  return HOST_TEST_RESULT();
+}
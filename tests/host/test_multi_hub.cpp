@@ -0,0 +1,167 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Two hubs on one main loop: the shared blocking budget on its own, then two
+// engines with their own panels keeping state and saved state apart while
+// both run configuration reads.
+
+#include "host_test.h"
+#include "kyo_panel_sim.h"
+#include "kyo_scheduler.h"
+#include "test_kyo.h"
+#include "virtual_clock.h"
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+struct Hub {
+  Hub(VirtualClock *clock, KyoLoopBudget *budget, const char *id, uint32_t seed) : sim(AlarmModel::KYO_32G, seed) {
+    this->link.connect(&this->sim.port());
+    this->kyo.set_transport(&this->link);
+    this->kyo.set_clock(clock);
+    this->kyo.set_instance_id(id);
+    this->kyo.set_loop_budget(budget);
+    this->sim.set_clock(clock);
+    clock->add_listener([this]() { this->sim.poll(); });
+  }
+  bool busy() { return !this->kyo.serial_idle() || !this->sim.is_idle() || this->link.available() > 0; }
+
+  KyoPanelSim sim;
+  LoopbackTransport link;
+  TestKyo kyo;
+};
+
+struct TwoHubRig {
+  TwoHubRig() : a(&clock, &budget, "panel_a", 1), b(&clock, &budget, "panel_b", 2), scheduler(&clock, &a.kyo) {
+    global_preferences->clear();
+    this->scheduler.add_component(&this->b.kyo);
+    this->scheduler.add_busy_check([this]() { return this->a.busy() || this->b.busy(); });
+    this->a.kyo.setup();
+    this->b.kyo.setup();
+  }
+
+  VirtualClock clock;
+  KyoLoopBudget budget;
+  Hub a;
+  Hub b;
+  KyoScheduler scheduler;
+};
+
+void test_budget_waits_for_every_hub() {
+  KyoLoopBudget budget;
+  int a = 0, b = 0;
+  budget.add_hub(&a);
+  budget.add_hub(&b);
+  budget.add_hub(&a);
+  CHECK_EQ(budget.get_hub_count(), 2);
+
+  // Nobody has polled yet
+  CHECK(!budget.try_acquire(&a, 1000));
+  budget.poll_done(&a);
+  CHECK(!budget.try_acquire(&a, 1000));
+  budget.poll_done(&b);
+  CHECK(budget.try_acquire(&a, 1000));
+  // One holder at a time
+  CHECK(!budget.try_acquire(&b, 1100));
+  budget.release(&a, 1200);
+
+  // Both must poll again before the next step, whoever asks
+  budget.poll_done(&a);
+  CHECK(!budget.try_acquire(&b, 1300));
+  budget.poll_done(&b);
+  CHECK(budget.try_acquire(&b, 1300));
+  budget.release(&b, 1400);
+  CHECK_EQ(budget.get_grants(&a), 1u);
+  CHECK_EQ(budget.get_grants(&b), 1u);
+  CHECK_EQ(budget.get_deferrals(&a), 2u);
+  CHECK_EQ(budget.get_deferrals(&b), 2u);
+}
+
+void test_budget_credit() {
+  KyoLoopBudget budget;
+  int a = 0;
+  budget.add_hub(&a);
+  budget.poll_done(&a);
+
+  // A step longer than the burst leaves the bucket in debt
+  CHECK(budget.try_acquire(&a, 0));
+  budget.release(&a, 3000);
+  CHECK(budget.get_credit_ms() < 0);
+  budget.poll_done(&a);
+  CHECK(!budget.try_acquire(&a, 3000));
+
+  // Paid back at the duty share of the time that follows
+  uint32_t debt = (uint32_t) -budget.get_credit_ms();
+  uint32_t repaid_ms = 3000 + debt * 100 / LOOP_BUDGET_DUTY_PERCENT;
+  CHECK(!budget.try_acquire(&a, repaid_ms - 10));
+  CHECK(budget.try_acquire(&a, repaid_ms + 10));
+  budget.release(&a, repaid_ms + 10);
+
+  // A hub past the limit blocks unbudgeted
+  KyoLoopBudget full;
+  int hubs[LOOP_BUDGET_MAX_HUBS + 1];
+  for (auto &hub : hubs)
+    full.add_hub(&hub);
+  CHECK_EQ(full.get_hub_count(), LOOP_BUDGET_MAX_HUBS);
+  CHECK(full.try_acquire(&hubs[LOOP_BUDGET_MAX_HUBS], 0));
+}
+
+void test_hubs_keep_their_own_state() {
+  TwoHubRig rig;
+  rig.a.sim.arm(0x01);
+  rig.b.sim.set_zone(3, true);
+  CHECK(rig.scheduler.run_until([&]() { return rig.a.kyo.config_done() && rig.b.kyo.config_done(); }, 300000));
+  rig.scheduler.run_for(2000);
+
+  CHECK(rig.a.kyo.communication_ok() && rig.b.kyo.communication_ok());
+  CHECK(rig.a.kyo.partition_armed_total(1));
+  CHECK(!rig.b.kyo.partition_armed_total(1));
+  CHECK(!rig.a.kyo.zone_state(3));
+  CHECK(rig.b.kyo.zone_state(3));
+  // Both configuration phases went through the one budget
+  CHECK(rig.budget.get_grants(&rig.a.kyo) >= 12);
+  CHECK(rig.budget.get_grants(&rig.b.kyo) >= 12);
+
+  // Each hub saved under its own key
+  KyoSavedState saved_a{}, saved_b{};
+  CHECK(global_preferences->make_preference<KyoSavedState>(fnv1_hash(std::string(SAVED_STATE_KEY) + ".panel_a"), true)
+            .load(&saved_a));
+  CHECK(global_preferences->make_preference<KyoSavedState>(fnv1_hash(std::string(SAVED_STATE_KEY) + ".panel_b"), true)
+            .load(&saved_b));
+  CHECK_EQ(saved_a.partition[6], 0x01);
+  CHECK_EQ(saved_b.partition[6], 0x00);
+}
+
+void test_config_reads_leave_polls_between() {
+  TwoHubRig rig;
+  CHECK(rig.scheduler.run_until([&]() { return rig.a.kyo.config_done() && rig.b.kyo.config_done(); }, 300000));
+  rig.scheduler.run_for(2000);
+
+  // While both re-read their configuration, each panel's zone change still
+  // shows up within a few polls
+  rig.a.kyo.reread_config();
+  rig.b.kyo.reread_config();
+  rig.scheduler.run_for(1000);
+  rig.a.sim.set_zone(5, true);
+  rig.b.sim.set_zone(6, true);
+  CHECK(rig.scheduler.run_until([&]() { return rig.a.kyo.zone_state(5) && rig.b.kyo.zone_state(6); }, 3000));
+  CHECK(!rig.a.kyo.config_done() || !rig.b.kyo.config_done());
+  CHECK(rig.scheduler.run_until([&]() { return rig.a.kyo.config_done() && rig.b.kyo.config_done(); }, 300000));
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_budget_waits_for_every_hub);
+  RUN_TEST(test_budget_credit);
+  RUN_TEST(test_hubs_keep_their_own_state);
+  RUN_TEST(test_config_reads_leave_polls_between);
+  return HOST_TEST_RESULT();
+}
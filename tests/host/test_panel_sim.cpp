@@ -0,0 +1,373 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// The engine against the simulated panel: every model through detection,
+// configuration and polling, write commands, the event log, fault recovery,
+// one publish pass per poll cycle with a fast path for alarms, publish
+// filters, packed state masks, and a throughput/latency run at realistic wire
+// timing.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include "alarm_control_panel.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+void test_all_models_detect_configure_and_poll() {
+  const AlarmModel models[] = {AlarmModel::KYO_4,  AlarmModel::KYO_8,  AlarmModel::KYO_8G,
+                               AlarmModel::KYO_8W, AlarmModel::KYO_32, AlarmModel::KYO_32G};
+  for (AlarmModel model : models) {
+    SimRig rig(model);
+    rig.sim.set_name(KyoPanelSim::REG_ZONE_NAMES, 0, "Front door");
+    CHECK(rig.run_until_config_done());
+    CHECK(rig.kyo.model_detected());
+    CHECK(rig.kyo.alarm_model() == model);
+    CHECK(rig.kyo.communication_ok());
+    CHECK(rig.kyo.zone_name(1) == "Front door");
+    CHECK(rig.kyo.zone_name(2) == "Zone 2");
+    CHECK(rig.kyo.zone_esn(1) == "100001");
+    CHECK_EQ(rig.kyo.partition_entry_delay(1), 30);
+
+    int zone = (model == AlarmModel::KYO_32 || model == AlarmModel::KYO_32G) ? 27 : 3;
+    rig.sim.set_zone(zone, true);
+    rig.run_for(1200);
+    CHECK(rig.kyo.zone_state(zone));
+    rig.sim.set_zone(zone, false);
+    rig.run_for(1200);
+    CHECK(!rig.kyo.zone_state(zone));
+  }
+}
+
+void test_write_commands() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  rig.kyo.arm_partition(1, 1);
+  CHECK_EQ(rig.sim.get_armed_total(), 0x01);
+  rig.run_for(1200);
+  CHECK(rig.kyo.partition_armed_total(1));
+
+  rig.sim.trigger_alarm(1);
+  rig.run_for(1200);
+  CHECK(rig.kyo.partition_alarm(1));
+  CHECK(rig.kyo.siren_active());
+  CHECK(rig.kyo.zone_alarm_memory(1));
+
+  rig.kyo.disarm_partition(1);
+  rig.kyo.reset_alarms();
+  rig.run_for(1200);
+  CHECK(!rig.kyo.partition_armed_total(1));
+  CHECK(!rig.kyo.siren_active());
+  CHECK(!rig.kyo.zone_alarm_memory(1));
+
+  rig.kyo.activate_output(2);
+  CHECK_EQ(rig.sim.get_outputs(), 0x02);
+  rig.kyo.exclude_zone(5);
+  CHECK_EQ(rig.sim.get_bypassed(), 1UL << 4);
+  rig.run_for(1200);
+  CHECK(rig.kyo.output_state(2));
+  CHECK(rig.kyo.zone_bypass(5));
+
+  rig.kyo.include_zone(5);
+  rig.run_for(1200);
+  CHECK(!rig.kyo.zone_bypass(5));
+
+  // arm + alarm + disarm + reset logged on the panel
+  CHECK(rig.sim.get_event_count() >= 4);
+}
+
+void test_register_read_rejects_bad_checksum() {
+  SimRig rig(AlarmModel::KYO_32G);
+  rig.sim.set_name(KyoPanelSim::REG_ZONE_NAMES, 0, "Front door");
+  CHECK(rig.run_until_config_done());
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 1000));
+
+  // A register answer that fails its checksum is not decoded
+  rig.sim.set_name(KyoPanelSim::REG_ZONE_NAMES, 0, "Back door");
+  uint32_t errors = rig.kyo.get_metrics().checksum_errors[METRIC_OP_BLOCKING];
+  rig.sim.faults().corrupt_rate = 1.0f;
+  rig.kyo.read_zone_names();
+  rig.sim.faults().corrupt_rate = 0.0f;
+  CHECK(rig.kyo.zone_name(1) == "Front door");
+  CHECK_EQ(rig.kyo.get_metrics().checksum_errors[METRIC_OP_BLOCKING], errors + 1);
+
+  rig.kyo.read_zone_names();
+  CHECK(rig.kyo.zone_name(1) == "Back door");
+}
+
+void test_event_log_sweep() {
+  SimRig rig(AlarmModel::KYO_32);
+  CHECK(rig.run_until_config_done());
+  for (int i = 0; i < 20; i++)
+    rig.sim.log_event(0x0130 + (i % 3));
+
+  uint32_t reads_before = rig.sim.get_stats().reads;
+  rig.kyo.read_event_log();
+  CHECK(rig.scheduler.run_until([&]() { return !rig.kyo.event_log_pending(); }, 60000));
+  CHECK_EQ(rig.kyo.event_log_entries(), 20);
+  CHECK(rig.sim.get_stats().reads - reads_before >= 28);
+}
+
+void test_recovers_from_faults() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  rig.sim.faults().drop_rate = 0.2f;
+  rig.sim.faults().corrupt_rate = 0.1f;
+  rig.sim.faults().truncate_rate = 0.1f;
+  rig.sim.faults().jitter_ms = 20;
+  rig.sim.set_zone(4, true);
+  rig.run_for(3000);
+  CHECK(rig.sim.get_stats().dropped > 0);
+  CHECK(rig.sim.get_stats().corrupted + rig.sim.get_stats().truncated > 0);
+  CHECK(rig.kyo.zone_state(4));
+
+  // Panel goes silent, then comes back
+  rig.sim.faults() = KyoSimFaults{};
+  // (three silent polls: up to one update interval to the first, plus the
+  // backed-off timeout of the third)
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(2000);
+  CHECK(!rig.kyo.communication_ok());
+  rig.sim.faults().drop_rate = 0.0f;
+  rig.run_for(5000);
+  CHECK(rig.kyo.communication_ok());
+}
+
+// Both frames of a poll cycle are decoded before anything publishes, and only
+// entities whose state changed publish
+void test_one_publish_pass_per_cycle() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  binary_sensor::BinarySensor zone3, zone4, comm;
+  BentelKyoAlarmPanel panel;
+  panel.set_parent(&rig.kyo);
+  panel.set_partition(1);
+  rig.kyo.register_alarm_panel(&panel);
+  rig.kyo.register_binary_sensor(&zone3, BinarySensorType::ZONE, 2);
+  rig.kyo.register_binary_sensor(&zone4, BinarySensorType::ZONE, 3);
+  rig.kyo.register_binary_sensor(&comm, BinarySensorType::COMMUNICATION, 0);
+  rig.sim.set_zone(4, true);
+  rig.run_for(1200);
+  CHECK(zone4.state);
+  CHECK(comm.state);
+
+  // A quiet panel publishes nothing, the link status included
+  uint32_t publishes = rig.kyo.get_metrics().publishes;
+  rig.run_for(3000);
+  CHECK_EQ(rig.kyo.get_metrics().publishes, publishes);
+  CHECK_EQ(comm.publish_calls, 1);
+  uint32_t panel_publishes = panel.publish_calls;
+
+  // Zone 3 opens as partition 1 arms: the zone publishes with the partition
+  // already decoded, and the panel with the zone already published
+  bool armed_seen_by_zone = false, zone_seen_by_panel = false;
+  zone3.add_on_state_callback([&](bool state) { armed_seen_by_zone = rig.kyo.partition_armed_total(1); });
+  panel.add_on_state_callback([&]() { zone_seen_by_panel = zone3.state; });
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 1000));
+  rig.sim.arm(0x01);
+  rig.sim.set_zone(3, true);
+  rig.run_for(1000);
+  CHECK(zone3.state);
+  CHECK_EQ(panel.get_state(), alarm_control_panel::ACP_STATE_ARMED_AWAY);
+  CHECK(armed_seen_by_zone);
+  CHECK(zone_seen_by_panel);
+  // Zone 3 and the panel; zone 4 is unchanged and stays quiet
+  CHECK_EQ(rig.kyo.get_metrics().publishes - publishes, 2);
+  CHECK_EQ(panel.publish_calls - panel_publishes, 1);
+  CHECK_EQ(zone4.publish_calls, 1);
+
+  // Zone 4 closes: the panel is refreshed but has nothing new to publish
+  publishes = rig.kyo.get_metrics().publishes;
+  rig.sim.set_zone(4, false);
+  rig.run_for(1000);
+  CHECK(!zone4.state);
+  CHECK_EQ(rig.kyo.get_metrics().publishes - publishes, 1);
+  CHECK_EQ(panel.publish_calls - panel_publishes, 1);
+  CHECK_EQ(comm.publish_calls, 1);
+}
+
+// A partition alarm or tamper publishes from the sensor frame, before the
+// partition half of the cycle (which carries the siren bit) is parsed
+void test_alarm_fast_path() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  binary_sensor::BinarySensor alarm1, tamper2, zone8;
+  BentelKyoAlarmPanel panel;
+  panel.set_parent(&rig.kyo);
+  panel.set_partition(1);
+  rig.kyo.register_alarm_panel(&panel);
+  rig.kyo.register_binary_sensor(&alarm1, BinarySensorType::PARTITION_ALARM, 0);
+  rig.kyo.register_binary_sensor(&tamper2, BinarySensorType::ZONE_TAMPER, 1);
+  rig.kyo.register_binary_sensor(&zone8, BinarySensorType::ZONE, 7);
+  rig.sim.arm(0x01);
+  rig.run_for(1200);
+  CHECK_EQ(panel.get_state(), alarm_control_panel::ACP_STATE_ARMED_AWAY);
+
+  bool triggered_mid_cycle = false, alarm_mid_cycle = false, tamper_mid_cycle = false, zone_mid_cycle = true;
+  panel.add_on_state_callback([&]() {
+    if (panel.get_state() == alarm_control_panel::ACP_STATE_TRIGGERED)
+      triggered_mid_cycle = !rig.kyo.siren_active();
+  });
+  alarm1.add_on_state_callback([&](bool state) { alarm_mid_cycle = state && !rig.kyo.siren_active(); });
+  tamper2.add_on_state_callback([&](bool state) { tamper_mid_cycle = state && !rig.kyo.siren_active(); });
+  zone8.add_on_state_callback([&](bool state) { zone_mid_cycle = !rig.kyo.siren_active(); });
+
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 1000));
+  rig.sim.trigger_alarm(8);
+  rig.sim.set_zone_tamper(2, true);
+  rig.run_for(1000);
+  CHECK_EQ(panel.get_state(), alarm_control_panel::ACP_STATE_TRIGGERED);
+  CHECK(alarm1.state && tamper2.state && zone8.state);
+  CHECK(rig.kyo.siren_active());
+  CHECK(triggered_mid_cycle);
+  CHECK(alarm_mid_cycle);
+  CHECK(tamper_mid_cycle);
+  // Zones wait for the end of the cycle
+  CHECK(!zone_mid_cycle);
+}
+
+// Debounce and minimum publish interval on chattering zones; alarm-type
+// sensors can't be filtered
+void test_publish_filter() {
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  binary_sensor::BinarySensor pir, vibration, door, tamper;
+  rig.kyo.register_binary_sensor(&pir, BinarySensorType::ZONE, 4);
+  rig.kyo.register_binary_sensor(&vibration, BinarySensorType::ZONE, 5);
+  rig.kyo.register_binary_sensor(&door, BinarySensorType::ZONE, 6);
+  rig.kyo.register_binary_sensor(&tamper, BinarySensorType::ZONE_TAMPER, 4);
+  rig.kyo.set_publish_filter(&pir, 1200, 0);
+  rig.kyo.set_publish_filter(&vibration, 0, 5000);
+  rig.kyo.set_publish_filter(&tamper, 1200, 0);
+  rig.kyo.setup();
+  CHECK(rig.run_until_config_done());
+  rig.run_for(6000);
+  uint32_t pir_calls = pir.publish_calls, vibration_calls = vibration.publish_calls;
+  uint32_t door_calls = door.publish_calls, tamper_calls = tamper.publish_calls;
+
+  // Zones 5-7 and zone 5's tamper flip on every poll for 4s
+  for (int i = 0; i < 8; i++) {
+    bool on = i % 2 == 0;
+    for (int zone = 5; zone <= 7; zone++)
+      rig.sim.set_zone(zone, on);
+    rig.sim.set_zone_tamper(5, on);
+    rig.run_for(500);
+  }
+  // Never held for 1.2s; once in the 5s window; unfiltered; exempt
+  CHECK_EQ(pir.publish_calls, pir_calls);
+  CHECK_EQ(vibration.publish_calls - vibration_calls, 1);
+  CHECK(door.publish_calls - door_calls >= 7);
+  CHECK(tamper.publish_calls - tamper_calls >= 7);
+  CHECK(rig.kyo.get_metrics().suppressed >= 6);
+
+  // A change that holds goes out once the filter allows it
+  rig.sim.set_zone(5, true);
+  rig.sim.set_zone(6, true);
+  rig.run_for(6000);
+  CHECK(pir.state && vibration.state);
+  CHECK_EQ(pir.publish_calls - pir_calls, 1);
+}
+
+void test_mask_sensors() {
+  SimRig rig(AlarmModel::KYO_32G);
+  text_sensor::TextSensor open, armed, warnings;
+  rig.kyo.register_mask_sensor(&open, MASK_ZONE_OPEN);
+  rig.kyo.register_mask_sensor(&armed, MASK_PARTITION_ARMED_TOTAL);
+  rig.kyo.register_mask_sensor(&warnings, MASK_WARNINGS);
+  rig.sim.set_zone(1, true);
+  rig.sim.set_zone(3, true);
+  rig.sim.set_zone(32, true);
+  rig.sim.arm(0x05);
+  rig.sim.set_warnings(0x09);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2000);
+  CHECK(open.state == "80000005");
+  CHECK(armed.state == "05");
+  CHECK(warnings.state == "09");
+  CHECK_EQ(rig.kyo.get_mask(MASK_ZONE_OPEN), 0x80000005u);
+
+  // Quiet panel: nothing more goes out
+  uint32_t open_calls = open.publish_calls, armed_calls = armed.publish_calls;
+  rig.run_for(10000);
+  CHECK_EQ(open.publish_calls, open_calls);
+  CHECK_EQ(armed.publish_calls, armed_calls);
+
+  // One publish per changed mask, the others stay put
+  rig.sim.set_zone(3, false);
+  rig.run_for(2000);
+  CHECK(open.state == "80000001");
+  CHECK_EQ(open.publish_calls, open_calls + 1);
+  CHECK_EQ(armed.publish_calls, armed_calls);
+}
+
+// Default 500ms update interval. Reports poll throughput and
+// zone-change-to-publish latency.
+void test_throughput_and_latency() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  binary_sensor::BinarySensor zone7;
+  rig.kyo.register_binary_sensor(&zone7, BinarySensorType::ZONE, 6);
+  uint32_t changed_ms = 0;
+  std::vector<uint32_t> latencies;
+  zone7.add_on_state_callback([&](bool state) {
+    if (changed_ms != 0)
+      latencies.push_back(rig.now_ms() - changed_ms);
+    changed_ms = 0;
+  });
+  rig.run_for(600);
+
+  const int toggles = 8;
+  uint32_t reads_before = rig.sim.get_stats().reads;
+  uint32_t start = rig.now_ms();
+  for (int i = 0; i < toggles; i++) {
+    rig.run_for(137 * (i % 4));  // land changes at different points of the cycle
+    changed_ms = rig.now_ms();
+    rig.sim.set_zone(7, i % 2 == 0);
+    rig.run_for(700);
+  }
+  uint32_t elapsed = rig.now_ms() - start;
+  uint32_t reads = rig.sim.get_stats().reads - reads_before;
+
+  CHECK_EQ(latencies.size(), toggles);
+  if (latencies.empty())
+    return;
+  std::sort(latencies.begin(), latencies.end());
+  uint32_t sum = 0;
+  for (uint32_t l : latencies)
+    sum += l;
+  printf("sim: %u reads in %u ms (%.1f/s), zone latency avg %u ms, max %u ms\n", (unsigned) reads,
+         (unsigned) elapsed, reads * 1000.0 / elapsed, (unsigned) (sum / latencies.size()),
+         (unsigned) latencies.back());
+  CHECK(latencies.back() <= 600);  // one update interval plus the exchange
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_all_models_detect_configure_and_poll);
+  RUN_TEST(test_write_commands);
+  RUN_TEST(test_register_read_rejects_bad_checksum);
+  RUN_TEST(test_event_log_sweep);
+  RUN_TEST(test_recovers_from_faults);
+  RUN_TEST(test_one_publish_pass_per_cycle);
+  RUN_TEST(test_alarm_fast_path);
+  RUN_TEST(test_publish_filter);
+  RUN_TEST(test_mask_sensors);
+  RUN_TEST(test_throughput_and_latency);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,112 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Blocking profiler: bucket boundaries, phase attribution during configuration
+// reads, event log sweeps and commands, and reset.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+uint32_t bucket_total(const ProfileHistogram &h) {
+  uint32_t total = 0;
+  for (uint32_t count : h.buckets)
+    total += count;
+  return total;
+}
+
+void test_buckets() {
+  CHECK_EQ(KyoProfiler::bucket_for(0), 0);
+  CHECK_EQ(KyoProfiler::bucket_for(99), 0);
+  CHECK_EQ(KyoProfiler::bucket_for(100), 1);
+  CHECK_EQ(KyoProfiler::bucket_for(49999), 5);
+  CHECK_EQ(KyoProfiler::bucket_for(50000), 6);
+  CHECK_EQ(KyoProfiler::bucket_for(1999999), 10);
+  CHECK_EQ(KyoProfiler::bucket_for(2000000), 11);
+  CHECK_EQ(KyoProfiler::bucket_for(0xFFFFFFFF), 11);
+
+  KyoProfiler profiler;
+  profiler.record(PROFILE_COMMAND, PROFILE_CMD_ARM, 40000);
+  profiler.record(PROFILE_COMMAND, PROFILE_CMD_RESET_ALARMS, 250000);
+  profiler.record(PROFILE_COMMAND, PROFILE_CMD_DISARM, 1000);
+  const ProfileHistogram &h = profiler.get(PROFILE_COMMAND);
+  CHECK_EQ(h.count, 3);
+  CHECK_EQ(bucket_total(h), 3);
+  CHECK_EQ(h.max_us, 250000);
+  CHECK_EQ(h.max_detail, PROFILE_CMD_RESET_ALARMS);
+  CHECK_EQ(h.total_us, 291000);
+  profiler.reset();
+  CHECK_EQ(profiler.get(PROFILE_COMMAND).count, 0);
+}
+
+void test_configuration_phases() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  const KyoProfiler &p = rig.kyo.get_profiler();
+
+  // Zone ESN: one EEPROM read per update, 32 slots plus the closing call
+  const ProfileHistogram &esn = p.get((ProfilePhase) (PROFILE_CONFIG_STEP + 3));
+  CHECK_EQ(esn.count, 33);
+  CHECK(esn.max_us >= 1000000);  // simulated EEPROM latency
+  CHECK(esn.max_detail < 32);
+  CHECK_EQ(p.get((ProfilePhase) (PROFILE_CONFIG_STEP + 8)).count, 17);
+  for (int step = 1; step < 13; step++) {
+    if (step != 3 && step != 8)
+      CHECK_EQ(p.get((ProfilePhase) (PROFILE_CONFIG_STEP + step)).count, 1);
+  }
+
+  // Every register read is a blocking exchange; the worst one is an ESN slot
+  const ProfileHistogram &sends = p.get(PROFILE_SEND_MESSAGE);
+  CHECK(sends.count >= 33 + 17);
+  CHECK(sends.max_detail >= 0xC045 && sends.max_detail < 0xC0B1 + 3 * 16);
+
+  // update() includes the config steps, loop() never blocks
+  CHECK(p.get(PROFILE_UPDATE).max_us >= esn.max_us);
+  CHECK(p.get(PROFILE_LOOP).count > 0);
+  CHECK(p.get(PROFILE_LOOP).max_us < 5000);
+}
+
+void test_event_log_and_commands() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.kyo.reset_profiler();
+
+  rig.kyo.read_event_log();
+  CHECK(rig.scheduler.run_until([&]() { return !rig.kyo.event_log_pending(); }, 60000));
+  rig.kyo.arm_partition(1, 1);
+  rig.kyo.activate_output(3);
+  rig.kyo.activate_output(4);
+
+  const KyoProfiler &p = rig.kyo.get_profiler();
+  const ProfileHistogram &chunks = p.get(PROFILE_EVENT_LOG);
+  CHECK_EQ(chunks.count, 29);  // 28 chunks plus the closing call
+  CHECK(chunks.max_detail < 28);
+  CHECK(chunks.max_us >= 50000);
+
+  const ProfileHistogram &commands = p.get(PROFILE_COMMAND);
+  CHECK_EQ(commands.count, 3);
+  CHECK(commands.max_detail == PROFILE_CMD_ARM || commands.max_detail == PROFILE_CMD_OUTPUT_ON);
+  CHECK_EQ(p.get((ProfilePhase) (PROFILE_CONFIG_STEP + 3)).count, 0);
+
+  host_log_level = HOST_LOG_INFO;
+  rig.kyo.dump_profiler();
+  host_log_level = HOST_LOG_WARN;
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_buckets);
+  RUN_TEST(test_configuration_phases);
+  RUN_TEST(test_event_log_and_commands);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,134 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Link recovery: the probe cadence for a silent and for a garbling panel,
+// polling resuming on the first good probe, and the recovery metrics.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+// Requests the engine put on the wire during ms of virtual time
+std::vector<uint32_t> requests_during(SimRig &rig, uint32_t ms) {
+  std::vector<uint32_t> request_ms;
+  uint32_t last_reads = rig.sim.get_stats().reads;
+  size_t listener = rig.clock.add_listener([&, last_reads]() mutable {
+    uint32_t reads = rig.sim.get_stats().reads;
+    if (reads != last_reads)
+      request_ms.push_back(rig.clock.millis());
+    last_reads = reads;
+  });
+  rig.run_for(ms);
+  rig.clock.remove_listener(listener);
+  return request_ms;
+}
+
+void test_garbled_answers_probe_fast() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2000);
+
+  // The panel is there but every answer is corrupt: no backoff past the
+  // fastest probe rate
+  rig.sim.faults().corrupt_rate = 1.0f;
+  rig.run_for(5000);
+  CHECK(rig.kyo.is_recovering());
+  CHECK(!rig.kyo.communication_ok());
+  std::vector<uint32_t> request_ms = requests_during(rig, 20000);
+  CHECK(request_ms.size() >= 50);
+  for (size_t i = 0; i + 1 < request_ms.size(); i++)
+    CHECK(request_ms[i + 1] - request_ms[i] <= RECOVERY_PROBE_MIN_MS * 5 / 4 + 100);
+
+  // A silent panel backs off to the slow rate instead
+  rig.sim.faults() = KyoSimFaults{};
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(15000);
+  request_ms = requests_during(rig, 30000);
+  CHECK(request_ms.size() >= 5 && request_ms.size() <= 10);
+}
+
+void test_polling_resumes_on_first_probe() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2000);
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(20000);
+  CHECK(rig.kyo.is_recovering());
+  KyoMetrics before = rig.kyo.get_metrics();
+
+  // Stop at the first probe the panel answers: the status poll goes out
+  // straight after it, without waiting for update()
+  rig.sim.faults().drop_rate = 0.0f;
+  CHECK(rig.scheduler.run_until([&]() { return !rig.kyo.is_recovering(); }, 10000));
+  uint32_t up_ms = rig.now_ms();
+  uint32_t updates = rig.scheduler.get_updates();
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.communication_ok(); }, 1000));
+  CHECK(rig.now_ms() - up_ms < 150);
+  CHECK_EQ(rig.scheduler.get_updates(), updates);
+
+  const KyoMetrics &m = rig.kyo.get_metrics();
+  CHECK(m.probes > before.probes);
+  CHECK_EQ(m.recoveries, before.recoveries + 1);
+  CHECK_EQ(m.timeouts[METRIC_OP_PROBE], m.probes - 1);
+  CHECK_EQ(rig.kyo.consecutive_failures(), 0);
+
+  // The outage runs from the first missed poll to the answered probe
+  CHECK(m.last_recovery_ms >= 20000 && m.last_recovery_ms <= 20000 + RECOVERY_PROBE_MAX_MS * 2);
+  rig.run_for(10000);
+  CHECK(rig.kyo.communication_ok());
+  CHECK_EQ(rig.kyo.get_metrics().recoveries, m.recoveries);
+}
+
+void test_mean_time_to_recovery() {
+  SimRig rig(AlarmModel::KYO_32G);
+  sensor::Sensor recoveries, mttr;
+  rig.kyo.register_metric_sensor(&recoveries, METRIC_RECOVERIES);
+  rig.kyo.register_metric_sensor(&mttr, METRIC_MEAN_TIME_TO_RECOVERY);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2000);
+
+  // Two outages of different length
+  uint32_t outage_ms[2] = {3000, 12000};
+  for (uint32_t ms : outage_ms) {
+    rig.sim.faults().drop_rate = 1.0f;
+    rig.run_for(ms);
+    rig.sim.faults().drop_rate = 0.0f;
+    CHECK(rig.scheduler.run_until([&]() { return rig.kyo.communication_ok(); }, 10000));
+    rig.run_for(5000);
+  }
+  const KyoMetrics &m = rig.kyo.get_metrics();
+  CHECK_EQ(m.recoveries, 2);
+  CHECK(m.recovery_ms_total >= 15000 - 1000);
+  rig.run_for(METRICS_PUBLISH_INTERVAL_MS);
+  CHECK_EQ(recoveries.state, 2.0f);
+  CHECK_EQ(mttr.state, (float) m.recovery_ms_total / 2);
+
+  // A single lost poll is not an outage
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(500);
+  rig.sim.faults().drop_rate = 0.0f;
+  rig.run_for(5000);
+  CHECK(!rig.kyo.is_recovering());
+  CHECK_EQ(rig.kyo.get_metrics().recoveries, 2);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_garbled_answers_probe_fast);
+  RUN_TEST(test_polling_resumes_on_first_probe);
+  RUN_TEST(test_mean_time_to_recovery);
+  return HOST_TEST_RESULT();
+}
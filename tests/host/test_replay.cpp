@@ -0,0 +1,130 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Capture replay: JSON Lines loading and the engine's view of a recorded
+// session. captures/synthetic_kyo32g.jsonl is hand-built from the frame
+// layouts in docs/PROTOCOL.md (not a real panel recording).
+
+#include "host_test.h"
+#include "kyo_replay.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+const std::string SYNTHETIC = std::string(KYO_CAPTURE_DIR) + "/synthetic_kyo32g.jsonl";
+
+bool has_transition(const ReplayReport &report, const std::string &what) {
+  for (auto &t : report.transitions) {
+    if (t.what == what)
+      return true;
+  }
+  return false;
+}
+
+void test_load_capture() {
+  std::vector<CaptureRecord> records;
+  std::string error;
+  CHECK(load_capture(SYNTHETIC, &records, &error));
+  CHECK_EQ(records.size(), 15);
+  CHECK(records[0].is_cmd);
+  CHECK_EQ(records[0].cmd.size(), 6);
+  CHECK_EQ(records[0].resp_data.size(), 13);
+  CHECK_EQ(records[0].chk_valid, 1);
+  CHECK_EQ(records[1].ts_ms - records[0].ts_ms, 120);
+  CHECK(!records.back().is_cmd);
+  CHECK_EQ(records.back().chk_valid, -1);
+}
+
+void test_malformed_capture() {
+  char path[] = "/tmp/kyo_replay_XXXXXX";
+  int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  FILE *f = fdopen(fd, "w");
+  fputs("{\"seq\": 1, \"type\": \"cmd\", \"cmd\": \"f0 04 f0 0a 00 ee\", \"resp_data\": [\"00\"]}\n", f);
+  fputs("{\"seq\": 2, \"type\": \"cmd\", \"cmd\": \"f0 zz\"}\n", f);
+  fclose(f);
+
+  std::vector<CaptureRecord> records;
+  std::string error;
+  CHECK(!load_capture(path, &records, &error));
+  CHECK(error.find(":2:") != std::string::npos);
+  CHECK(!load_capture("/nonexistent/capture.jsonl", &records, &error));
+  remove(path);
+}
+
+void test_replay_synthetic_session() {
+  std::vector<CaptureRecord> records;
+  std::string error;
+  CHECK(load_capture(SYNTHETIC, &records, &error));
+  ReplayReport report = replay_capture(SYNTHETIC, records, ReplayOptions());
+
+  CHECK(report.model.find("KYO32G") == 0);
+  CHECK_EQ(report.records, 15);
+  CHECK_EQ(report.skipped, 1);       // zone name read
+  CHECK_EQ(report.bad_checksum, 1);  // truncated sensor frame
+  CHECK_EQ(report.clean_failures, 0);
+  CHECK_EQ(report.kinds[REPLAY_VERSION].frames, 1);
+  CHECK_EQ(report.kinds[REPLAY_SENSOR].frames, 6);
+  CHECK_EQ(report.kinds[REPLAY_SENSOR].failures, 1);
+  CHECK_EQ(report.kinds[REPLAY_PARTITION].frames, 5);
+  CHECK_EQ(report.kinds[REPLAY_EVENT_LOG].frames, 1);
+  CHECK_EQ(report.events_decoded, 2);
+  CHECK(report.publish_calls > 0);
+
+  CHECK(has_transition(report, "zone 3 ON"));
+  CHECK(has_transition(report, "zone 3 OFF"));
+  CHECK(has_transition(report, "partition 1 ARMED_AWAY"));
+  CHECK(has_transition(report, "zone 5 ON"));
+  CHECK(has_transition(report, "partition alarm 1 ON"));
+  CHECK(has_transition(report, "siren ON"));
+  CHECK(has_transition(report, "zone alarm memory 5 ON"));
+  CHECK(has_transition(report, "partition 1 TRIGGERED"));
+  CHECK(!has_transition(report, "zone 4 ON"));
+
+  // Transitions carry capture-relative time. The zone opens in the 1000ms
+  // sensor frame and publishes with the partition frame that ends the cycle.
+  for (auto &t : report.transitions) {
+    if (t.what == "zone 3 ON")
+      CHECK(t.ts_ms >= 1100 && t.ts_ms < 1200);
+    if (t.what == "siren ON")
+      CHECK(t.ts_ms >= 20100 && t.ts_ms < 20200);
+  }
+}
+
+void test_firmware_option() {
+  // Drop the version record: the sensor length alone only tells KYO32 apart
+  std::vector<CaptureRecord> records;
+  std::string error;
+  CHECK(load_capture(SYNTHETIC, &records, &error));
+  records.erase(records.begin());
+
+  ReplayReport inferred = replay_capture(SYNTHETIC, records, ReplayOptions());
+  CHECK(inferred.model == "KYO32");
+  CHECK(inferred.kinds[REPLAY_PARTITION].frames == 5);
+
+  ReplayOptions options;
+  options.firmware = "KYO32G  2.13";
+  ReplayReport forced = replay_capture(SYNTHETIC, records, options);
+  CHECK(forced.model.find("KYO32G") == 0);
+  CHECK_EQ(forced.kinds[REPLAY_VERSION].frames, 1);
+  CHECK_EQ(forced.clean_failures, 0);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_load_capture);
+  RUN_TEST(test_malformed_capture);
+  RUN_TEST(test_replay_synthetic_session);
+  RUN_TEST(test_firmware_option);
+  return HOST_TEST_RESULT();
+}
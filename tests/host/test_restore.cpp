@@ -0,0 +1,205 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Saved state across reboots: what is written while polling, the state
+// published at setup() before the panel has said anything, reconciliation by
+// the first live poll, arming held back until the panel has answered, and a
+// panel swapped for another model.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include "alarm_control_panel.h"
+
+#include <cstring>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+// Polls a panel with partition 1 armed and zone 3 open, and returns what the
+// hub saved
+KyoSavedState run_first_boot(AlarmModel model) {
+  SimRig rig(model);
+  rig.sim.arm(0x01);
+  rig.sim.set_zone(3, true);
+  rig.run_for(3000);
+  CHECK(rig.kyo.communication_ok());
+  CHECK(rig.kyo.state_saves() >= 1);
+  return rig.kyo.saved_state();
+}
+
+// What the preferences hold when the next rig boots
+void store(const KyoSavedState &state) {
+  KyoSavedState copy = state;
+  global_preferences->make_preference<KyoSavedState>(fnv1_hash(SAVED_STATE_KEY), true).save(&copy);
+}
+
+struct Entities {
+  explicit Entities(TestKyo &kyo) {
+    this->panel.set_parent(&kyo);
+    this->panel.set_partition(1);
+    kyo.register_alarm_panel(&this->panel);
+    kyo.register_binary_sensor(&this->zone3, BinarySensorType::ZONE, 2);
+  }
+  BentelKyoAlarmPanel panel;
+  binary_sensor::BinarySensor zone3;
+};
+
+void test_saves_on_change_only() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  uint32_t saves = rig.kyo.state_saves();
+  CHECK(saves >= 1);
+  const KyoSavedState &saved = rig.kyo.saved_state();
+  CHECK_EQ(saved.version, SAVED_STATE_VERSION);
+  CHECK_EQ(saved.model, (uint8_t) AlarmModel::KYO_32G);
+  CHECK_EQ(saved.sensor_len, RESP_SENSOR_KYO32);
+  CHECK_EQ(saved.partition_len, RESP_PARTITION_KYO32);
+
+  // A quiet panel: minutes of polling, no writes
+  rig.run_for(120000);
+  CHECK_EQ(rig.kyo.state_saves(), saves);
+
+  rig.sim.arm(0x02);
+  rig.run_for(1000);
+  CHECK_EQ(rig.kyo.state_saves(), saves + 1);
+  CHECK_EQ(rig.kyo.saved_state().partition[6], 0x02);
+}
+
+void test_publishes_restored_state_at_setup() {
+  KyoSavedState saved = run_first_boot(AlarmModel::KYO_32G);
+
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  store(saved);
+  Entities entities(rig.kyo);
+  rig.sim.arm(0x01);
+  rig.sim.set_zone(3, true);
+  rig.kyo.setup();
+
+  // No time has passed and nothing was sent
+  CHECK_EQ(rig.sim.get_stats().reads, 0);
+  CHECK(rig.kyo.model_detected());
+  CHECK(rig.kyo.model_restored());
+  CHECK(rig.kyo.alarm_model() == AlarmModel::KYO_32G);
+  CHECK_EQ(strcmp(rig.kyo.firmware(), saved.firmware), 0);
+  CHECK_EQ(entities.panel.get_state(), alarm_control_panel::ACP_STATE_ARMED_AWAY);
+  CHECK(entities.zone3.state);
+  CHECK(!rig.kyo.communication_ok());
+
+  // The version query still goes out first and confirms the model
+  rig.run_for(1000);
+  CHECK(!rig.kyo.model_restored());
+  CHECK(rig.kyo.communication_ok());
+  CHECK_EQ(entities.panel.get_state(), alarm_control_panel::ACP_STATE_ARMED_AWAY);
+  CHECK(entities.zone3.state);
+}
+
+void test_first_poll_reconciles() {
+  KyoSavedState saved = run_first_boot(AlarmModel::KYO_32G);
+
+  // Disarmed and zone 3 closed while the hub was down
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  store(saved);
+  Entities entities(rig.kyo);
+  rig.kyo.setup();
+  CHECK_EQ(entities.panel.get_state(), alarm_control_panel::ACP_STATE_ARMED_AWAY);
+  CHECK(entities.zone3.state);
+
+  rig.run_for(1000);
+  CHECK_EQ(entities.panel.get_state(), alarm_control_panel::ACP_STATE_DISARMED);
+  CHECK(!entities.zone3.state);
+  CHECK_EQ(rig.kyo.saved_state().partition[6], 0x00);
+}
+
+void test_arming_waits_for_live_partition_status() {
+  KyoSavedState saved = run_first_boot(AlarmModel::KYO_32G);
+
+  // Partition 1 was disarmed while the hub was down; arming partition 2 from
+  // the restored masks would re-arm it
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  store(saved);
+  Entities entities(rig.kyo);
+  rig.kyo.setup();
+  CHECK(rig.kyo.partition_armed_total(1));
+
+  rig.kyo.arm_partition(2, 1);
+  rig.kyo.disarm_partition(3);
+  rig.kyo.arm_all_partitions(2);
+  CHECK_EQ(rig.sim.get_stats().writes, 0);
+  CHECK_EQ(rig.sim.get_armed_total(), 0x00);
+  CHECK_EQ(rig.sim.get_armed_partial(), 0x00);
+
+  rig.run_for(1000);
+  CHECK(!rig.kyo.partition_armed_total(1));
+  rig.kyo.arm_partition(2, 1);
+  CHECK_EQ(rig.sim.get_stats().writes, 1);
+  CHECK_EQ(rig.sim.get_armed_total(), 0x02);
+}
+
+void test_other_model_discards_saved_state() {
+  KyoSavedState saved = run_first_boot(AlarmModel::KYO_32G);
+
+  SimRig rig(AlarmModel::KYO_8, 1, false);
+  store(saved);
+  Entities entities(rig.kyo);
+  rig.sim.arm(0x01);
+  rig.kyo.setup();
+  CHECK(rig.kyo.alarm_model() == AlarmModel::KYO_32G);
+
+  rig.run_for(2000);
+  CHECK(rig.kyo.alarm_model() == AlarmModel::KYO_8);
+  CHECK(rig.kyo.communication_ok());
+  CHECK_EQ(entities.panel.get_state(), alarm_control_panel::ACP_STATE_ARMED_AWAY);
+  CHECK(!entities.zone3.state);
+  CHECK_EQ(rig.kyo.saved_state().model, (uint8_t) AlarmModel::KYO_8);
+  CHECK_EQ(rig.kyo.saved_state().partition_len, RESP_PARTITION_KYO8);
+}
+
+void test_ignores_bad_or_disabled_state() {
+  KyoSavedState saved = run_first_boot(AlarmModel::KYO_32G);
+
+  // Lengths that don't belong to the model
+  KyoSavedState bad = saved;
+  bad.sensor_len = RESP_SENSOR_KYO8;
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  store(bad);
+  rig.kyo.setup();
+  CHECK(!rig.kyo.model_detected());
+
+  // Another layout version
+  bad = saved;
+  bad.version = SAVED_STATE_VERSION + 1;
+  SimRig rig2(AlarmModel::KYO_32G, 1, false);
+  store(bad);
+  rig2.kyo.setup();
+  CHECK(!rig2.kyo.model_detected());
+
+  // Turned off: nothing restored, nothing written
+  SimRig rig3(AlarmModel::KYO_32G, 1, false);
+  store(saved);
+  rig3.kyo.set_restore_state(false);
+  rig3.kyo.setup();
+  CHECK(!rig3.kyo.model_detected());
+  rig3.run_for(3000);
+  CHECK(rig3.kyo.communication_ok());
+  CHECK_EQ(rig3.kyo.state_saves(), 0);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_saves_on_change_only);
+  RUN_TEST(test_publishes_restored_state_at_setup);
+  RUN_TEST(test_first_poll_reconciles);
+  RUN_TEST(test_arming_waits_for_live_partition_status);
+  RUN_TEST(test_other_model_discards_saved_state);
+  RUN_TEST(test_ignores_bad_or_disabled_state);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Adaptive response timeouts: the SRTT/RTTVAR estimator with its floors,
+// ceilings and backoff, then timeouts learned from a fast and a slow panel.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+void test_estimator() {
+  KyoRttEstimator rtt;
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_POLL, 18), 80);  // no samples yet
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_EEPROM, 10), 1500);
+
+  // 18-byte frame (21ms on the wire) after a 15ms turnaround
+  rtt.sample(RTT_CLASS_POLL, 36, 18);
+  const RttClassState &s = rtt.get(RTT_CLASS_POLL);
+  CHECK_EQ(s.srtt_x8 >> 3, 15);
+  CHECK_EQ(s.rttvar_x4 >> 2, 7);
+  for (int i = 0; i < 50; i++)
+    rtt.sample(RTT_CLASS_POLL, 36, 18);
+  CHECK_EQ(s.srtt_x8 >> 3, 15);
+  // wire + SRTT + max(4*RTTVAR, granularity), per expected length
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_POLL, 18), 21 + 15 + RTT_MIN_VARIANCE_MS);
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_POLL, 26), 30 + 15 + RTT_MIN_VARIANCE_MS);
+  CHECK_EQ(rtt.get(RTT_CLASS_REGISTER).samples, 0);  // classes are independent
+
+  // Consecutive timeouts double it up to the ceiling; a good sample resets that
+  rtt.timed_out(RTT_CLASS_POLL);
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_POLL, 18), 2 * (21 + 15 + RTT_MIN_VARIANCE_MS));
+  for (int i = 0; i < 10; i++)
+    rtt.timed_out(RTT_CLASS_POLL);
+  CHECK_EQ(s.backoff, RTT_MAX_BACKOFF);
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_POLL, 18), KyoRttEstimator::limits(RTT_CLASS_POLL).ceiling_ms);
+  rtt.sample(RTT_CLASS_POLL, 36, 18);
+  CHECK_EQ(s.backoff, 0);
+
+  // Floor: a panel that seems to answer instantly still gets a sane wait
+  rtt.sample(RTT_CLASS_COMMAND, 0, 6);
+  for (int i = 0; i < 50; i++)
+    rtt.sample(RTT_CLASS_COMMAND, 0, 6);
+  CHECK_EQ(rtt.timeout_ms(RTT_CLASS_COMMAND, 6), KyoRttEstimator::limits(RTT_CLASS_COMMAND).floor_ms);
+}
+
+void test_learns_fast_panel() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(10000);
+  const KyoRttEstimator &rtt = rig.kyo.get_rtt();
+
+  CHECK(rtt.get(RTT_CLASS_POLL).samples > 20);
+  CHECK(rtt.get(RTT_CLASS_REGISTER).samples > 10);
+  CHECK(rtt.get(RTT_CLASS_EEPROM).samples >= 32);
+  for (int cls = 0; cls < RTT_CLASS_COUNT; cls++)
+    CHECK_EQ(rtt.get((RttClass) cls).timeouts, 0);
+
+  // Well under the former fixed 80/300/1500ms waits
+  CHECK(rtt.timeout_ms(RTT_CLASS_POLL, RESP_PARTITION_KYO32) < 60);
+  CHECK(rtt.timeout_ms(RTT_CLASS_REGISTER, 6 + 0x3F + 2) < 150);
+  CHECK(rtt.timeout_ms(RTT_CLASS_EEPROM, 6 + 2 + 2) < 1100);
+}
+
+void test_slow_panel_keeps_communication() {
+  // 85ms turnaround: every answer would arrive after the old fixed 80ms poll timeout
+  SimRig rig(AlarmModel::KYO_32G);
+  rig.sim.faults().extra_delay_ms = 70;
+  CHECK(rig.run_until_config_done());
+  KyoMetrics before = rig.kyo.get_metrics();
+  rig.run_for(30000);
+
+  const KyoMetrics &m = rig.kyo.get_metrics();
+  CHECK(rig.kyo.communication_ok());
+  CHECK_EQ(m.timeouts[METRIC_OP_SENSOR] - before.timeouts[METRIC_OP_SENSOR], 0);
+  CHECK(m.polls - before.polls >= 50);
+  CHECK(rig.kyo.get_rtt().get(RTT_CLASS_POLL).timeouts <= 2);
+  CHECK(rig.kyo.get_rtt().timeout_ms(RTT_CLASS_POLL, RESP_SENSOR_KYO32) > 100);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_estimator);
+  RUN_TEST(test_learns_fast_panel);
+  RUN_TEST(test_slow_panel_keeps_communication);
+  return HOST_TEST_RESULT();
+}
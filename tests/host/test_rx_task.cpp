@@ -0,0 +1,207 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// The RX task: the SPSC ring across two threads, the pump's arrival stamps
+// and overflow accounting, and the engine measuring a poll from arrival time
+// while its main loop is held up elsewhere.
+
+#include "host_test.h"
+#include "kyo_panel_sim.h"
+#include "rx_task.h"
+#include "test_kyo.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+// Clock the test thread sets and the RX thread reads
+class ManualClock : public KyoClock {
+ public:
+  uint32_t millis() override { return (uint32_t) (this->us_.load() / 1000); }
+  uint32_t micros() override { return (uint32_t) this->us_.load(); }
+  void yield() override { std::this_thread::yield(); }
+  void advance_us(uint64_t us) { this->us_ += us; }
+
+ protected:
+  std::atomic<uint64_t> us_{1000000};
+};
+
+// A loopback endpoint shared between the RX thread and the test thread
+class LockedTransport : public KyoTransport {
+ public:
+  LockedTransport(LoopbackTransport *inner, std::mutex *lock) : inner_(inner), lock_(lock) {}
+  int available() override {
+    std::lock_guard<std::mutex> guard(*this->lock_);
+    return this->inner_->available();
+  }
+  uint8_t read() override {
+    std::lock_guard<std::mutex> guard(*this->lock_);
+    return this->inner_->read();
+  }
+  void write_array(const uint8_t *data, size_t len) override {
+    std::lock_guard<std::mutex> guard(*this->lock_);
+    this->inner_->write_array(data, len);
+  }
+
+ protected:
+  LoopbackTransport *inner_;
+  std::mutex *lock_;
+};
+
+// Waits (in real time) for the RX thread to get somewhere
+bool wait_for(const std::function<bool()> &done) {
+  for (int i = 0; i < 2000; i++) {
+    if (done())
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+void test_ring_two_threads() {
+  static const uint32_t ITEMS = 200000;
+  SpscRing<uint32_t, 64> ring;
+  CHECK_EQ(ring.capacity(), 63u);
+
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < ITEMS; i++) {
+      while (!ring.push(i))
+        std::this_thread::yield();
+    }
+  });
+  uint32_t expected = 0, out = 0;
+  bool in_order = true;
+  while (expected < ITEMS) {
+    if (ring.size() > ring.capacity())
+      in_order = false;
+    if (!ring.pop(&out)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (out != expected)
+      in_order = false;
+    expected++;
+  }
+  producer.join();
+  CHECK(in_order);
+  CHECK(!ring.pop(&out));
+  CHECK_EQ(ring.size(), 0u);
+}
+
+void test_pump_stamps_and_overflow() {
+  ManualClock clock;
+  std::mutex lock;
+  LoopbackTransport line, panel;
+  line.connect(&panel);
+  LockedTransport locked(&line, &lock);
+  KyoRxPump pump;
+  pump.set_inner(&locked);
+  pump.set_clock(&clock);
+  CHECK(pump.start());
+  CHECK(pump.is_running());
+  CHECK(!pump.start());
+
+  // Bytes taken off the line at t, read by the main loop much later
+  uint32_t arrival_ms = clock.millis();
+  const uint8_t frame[] = {0xF0, 0x04, 0xF0, 0x0A, 0x00, 0xEE};
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    line.inject(frame, sizeof(frame));
+  }
+  CHECK(wait_for([&]() { return pump.available() == (int) sizeof(frame); }));
+  clock.advance_us(300000);
+  for (uint8_t expected : frame)
+    CHECK_EQ(pump.read(), expected);
+  CHECK_EQ(pump.last_read_ms(), arrival_ms);
+  CHECK_EQ(pump.available(), 0);
+
+  // Writes pass straight through
+  pump.write_array(frame, sizeof(frame));
+  CHECK_EQ(panel.available(), (int) sizeof(frame));
+
+  // More than the ring holds while the main loop reads nothing
+  uint8_t burst[400] = {};
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    line.inject(burst, sizeof(burst));
+  }
+  CHECK(wait_for([&]() { return pump.get_overflows() == sizeof(burst) - RX_RING_SIZE + 1; }));
+  CHECK_EQ(pump.available(), (int) RX_RING_SIZE - 1);
+  CHECK_EQ(pump.get_high_water(), RX_RING_SIZE - 1);
+
+  pump.stop();
+  CHECK(!pump.is_running());
+}
+
+// One sensor poll whose answer arrives while loop() is held up for 300ms.
+// Returns the poll RTT estimate the engine took from it.
+int32_t poll_behind_stalled_loop(bool rx_task) {
+  ManualClock clock;
+  std::mutex lock;
+  KyoPanelSim sim(AlarmModel::KYO_32G);
+  sim.set_clock(&clock);
+  LoopbackTransport line;
+  line.connect(&sim.port());
+  LockedTransport locked(&line, &lock);
+
+  TestKyo kyo;
+  kyo.set_transport(&locked);
+  kyo.set_clock(&clock);
+  kyo.set_restore_state(false);
+  kyo.set_rx_task(rx_task);
+  kyo.setup();
+  CHECK_EQ(kyo.get_rx_pump().is_running(), rx_task);
+
+  const uint8_t cmd[] = {0xF0, 0x04, 0xF0, 0x0A, 0x00, 0xEE};
+  kyo.begin_exchange(cmd, sizeof(cmd), METRIC_OP_SENSOR, 1000);
+  for (int step = 0; step < 3000; step++) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      clock.advance_us(100);
+      sim.poll();
+    }
+    // Let the RX thread keep up with the wire before time moves on
+    if (rx_task)
+      CHECK(wait_for([&]() { return locked.available() == 0; }));
+  }
+
+  // The loop gets the CPU back; the sensor answer chains the partition poll
+  const RttClassState &rtt = kyo.get_rtt().get(RTT_CLASS_POLL);
+  for (int tick = 0; tick < 50 && rtt.samples == 0; tick++) {
+    kyo.loop();
+    clock.advance_us(1000);
+  }
+  CHECK_EQ(rtt.samples, 1u);
+  return rtt.srtt_x8 / 8;
+}
+
+void test_rtt_from_arrival_time() {
+  // Without the task the answer looks 300ms late; with it, the panel's own
+  // 15ms turnaround comes through
+  int32_t from_loop = poll_behind_stalled_loop(false);
+  int32_t from_task = poll_behind_stalled_loop(true);
+  printf("poll RTT: %dms from loop(), %dms from the RX task\n", (int) from_loop, (int) from_task);
+  CHECK(from_loop >= 250);
+  CHECK(from_task <= 40);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_ring_two_threads);
+  RUN_TEST(test_pump_stamps_and_overflow);
+  RUN_TEST(test_rtt_from_arrival_time);
+  return HOST_TEST_RESULT();
+}
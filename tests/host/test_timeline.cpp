@@ -0,0 +1,156 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Transition timeline: the ring, pulses inferred from the memory bits, and
+// the order of a zone trip and an alarm from a zone the polls never saw open.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+std::vector<KyoTransition> entries(const KyoTimeline &timeline) {
+  std::vector<KyoTransition> out;
+  size_t cursor = 0;
+  KyoTransition entry;
+  while (timeline.next(&cursor, &entry))
+    out.push_back(entry);
+  return out;
+}
+
+void test_ring_overwrites_oldest() {
+  KyoTimeline timeline;
+  for (uint32_t i = 0; i < TIMELINE_SIZE + 5; i++)
+    timeline.record(i, TRANSITION_OPEN, (uint8_t) (i % 32));
+  CHECK_EQ(timeline.size(), TIMELINE_SIZE);
+  CHECK_EQ(timeline.recorded(), TIMELINE_SIZE + 5);
+  CHECK_EQ(timeline.overwritten(), 5u);
+  auto all = entries(timeline);
+  CHECK_EQ(all.front().ms, 5u);
+  CHECK_EQ(all.back().ms, TIMELINE_SIZE + 4);
+  timeline.clear();
+  CHECK_EQ(timeline.size(), 0u);
+}
+
+void test_bit_diff_and_pulses() {
+  KyoTimeline timeline;
+  // Baseline frames record nothing
+  timeline.on_sensor_frame(0x01, 0x00, 0x00, 100);
+  timeline.on_partition_frame(0x00, 0x00, 150);
+  CHECK_EQ(timeline.size(), 0u);
+
+  // Zone 2 opens and is seen; its memory latches: no pulse
+  timeline.on_sensor_frame(0x03, 0x00, 0x01, 600);
+  timeline.on_partition_frame(0x02, 0x00, 650);
+  timeline.on_sensor_frame(0x01, 0x00, 0x01, 1100);
+  auto all = entries(timeline);
+  CHECK_EQ(all.size(), 4u);
+  CHECK(all[0].kind == TRANSITION_OPEN && all[0].index == 1);
+  CHECK(all[1].kind == TRANSITION_PARTITION_ALARM && all[1].index == 0);
+  CHECK(all[2].kind == TRANSITION_ALARM_MEMORY && all[2].index == 1);
+  CHECK(all[3].kind == TRANSITION_CLOSE && all[3].index == 1);
+
+  // Zone 3 latches alarm memory without ever being seen open: a pulse, dated
+  // at the partition frame and ahead of what the next sensor frame shows
+  timeline.on_partition_frame(0x06, 0x00, 1150);
+  timeline.on_sensor_frame(0x11, 0x00, 0x01, 1600);
+  all = entries(timeline);
+  CHECK_EQ(all.size(), 7u);
+  CHECK(all[4].kind == TRANSITION_ALARM_MEMORY && all[4].index == 2);
+  CHECK(all[5].kind == TRANSITION_PULSE && all[5].index == 2 && all[5].ms == 1150);
+  CHECK(all[6].kind == TRANSITION_OPEN && all[6].index == 4);
+
+  // Zone 6 opens between the two frames of a cycle: memory before the open
+  // is seen, but the next sensor frame shows it open, so no pulse
+  timeline.on_partition_frame(0x26, 0x00, 1650);
+  timeline.on_sensor_frame(0x31, 0x00, 0x01, 2100);
+  all = entries(timeline);
+  CHECK_EQ(all.size(), 9u);
+  CHECK(all[7].kind == TRANSITION_ALARM_MEMORY && all[7].index == 5);
+  CHECK(all[8].kind == TRANSITION_OPEN && all[8].index == 5);
+
+  // Same for tampers
+  timeline.on_partition_frame(0x26, 0x80, 2150);
+  timeline.on_sensor_frame(0x31, 0x00, 0x01, 2600);
+  all = entries(timeline);
+  CHECK(all.back().kind == TRANSITION_TAMPER_PULSE && all.back().index == 7);
+}
+
+void test_pulse_between_polls() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.sim.arm(0x01);
+  rig.run_for(2000);
+  size_t before = rig.kyo.get_timeline().size();
+
+  // Zone 5 opens and stays open; a second later zone 1 trips the alarm and
+  // closes again before the next poll
+  rig.sim.set_zone(5, true);
+  rig.run_for(1000);
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.serial_idle(); }, 1000));
+  rig.sim.trigger_alarm(1);
+  rig.sim.set_zone(1, false);
+  rig.run_for(2000);
+  CHECK(!rig.kyo.zone_state(1));
+  CHECK(rig.kyo.zone_alarm_memory(1));
+
+  auto all = entries(rig.kyo.get_timeline());
+  std::vector<KyoTransition> added(all.begin() + before, all.end());
+  CHECK_EQ(added.size(), 4u);
+  CHECK(added[0].kind == TRANSITION_OPEN && added[0].index == 4);
+  CHECK(added[1].kind == TRANSITION_PARTITION_ALARM && added[1].index == 0);
+  CHECK(added[2].kind == TRANSITION_ALARM_MEMORY && added[2].index == 0);
+  CHECK(added[3].kind == TRANSITION_PULSE && added[3].index == 0);
+  CHECK(added[0].ms + 900 <= added[1].ms);
+  CHECK(added[1].ms <= added[3].ms);
+
+  rig.kyo.dump_timeline(true);
+  CHECK_EQ(rig.kyo.get_timeline().size(), 0u);
+}
+
+void test_restored_frame_records_nothing() {
+  KyoSavedState saved{};
+  {
+    SimRig rig(AlarmModel::KYO_32G);
+    rig.sim.arm(0x01);
+    rig.sim.set_zone(3, true);
+    rig.run_for(3000);
+    saved = rig.kyo.saved_state();
+  }
+
+  // Disarmed, zone 3 closed and zone 5 opened while the hub was down
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  global_preferences->make_preference<KyoSavedState>(fnv1_hash(SAVED_STATE_KEY), true).save(&saved);
+  rig.sim.set_zone(5, true);
+  rig.kyo.setup();
+  CHECK(rig.kyo.model_restored());
+  CHECK(rig.run_until_config_done());
+  CHECK_EQ(rig.kyo.get_timeline().size(), 0u);
+
+  // The first live frames are the baseline
+  rig.sim.set_zone(5, false);
+  rig.run_for(2000);
+  auto all = entries(rig.kyo.get_timeline());
+  CHECK_EQ(all.size(), 1u);
+  CHECK(all[0].kind == TRANSITION_CLOSE && all[0].index == 4);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_ring_overwrites_oldest);
+  RUN_TEST(test_bit_diff_and_pulses);
+  RUN_TEST(test_pulse_between_polls);
+  RUN_TEST(test_restored_frame_records_nothing);
+  return HOST_TEST_RESULT();
+}
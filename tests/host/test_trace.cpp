@@ -0,0 +1,188 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Raw frame trace: ring eviction and timestamp wrap, the frames recorded for
+// polls and blocking reads, freezing on communication loss, and the dump.
+//
+// test_trace --dump FILE writes a dump of a steady-state session to FILE for
+// the extractor round trip in CMakeLists.txt.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include <cstring>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+const uint8_t SENSOR_CMD[6] = {0xF0, 0x04, 0xF0, 0x0A, 0x00, 0xEE};
+
+void test_ring_eviction() {
+  KyoTraceRing ring;
+  uint8_t frame[40];
+  for (int i = 0; i < 40; i++)
+    frame[i] = i;
+
+  // Far more than fits: the ring keeps the newest frames, oldest first
+  for (uint32_t i = 0; i < 1000; i++)
+    ring.record(0xFFF80000u + i * 1000, (i & 1) != 0, i % 3, frame, 10 + i % 30);
+  CHECK(ring.used_bytes() <= TRACE_BUFFER_SIZE);
+  CHECK(ring.evicted() > 0);
+  CHECK_EQ(ring.records() + ring.evicted(), 1000);
+
+  TraceRecord rec;
+  size_t cursor = 0;
+  uint32_t seen = 0;
+  uint64_t last = 0;
+  while (ring.next(&cursor, &rec)) {
+    CHECK(rec.time_us >= last);  // micros() wrapped halfway through
+    last = rec.time_us;
+    CHECK_EQ(rec.data[rec.len - 1], rec.len - 1);
+    seen++;
+  }
+  CHECK_EQ(seen, ring.records());
+  CHECK_EQ(last, ring.newest_us());
+  CHECK(ring.newest_us() > 0xFFFFFFFFull);
+
+  // Frozen: new frames are ignored until released
+  uint32_t held = ring.records();
+  ring.set_frozen(true);
+  ring.record(0x00100000u, false, 0, frame, 6);
+  CHECK_EQ(ring.records(), held);
+  CHECK_EQ(ring.newest_us(), last);
+  ring.clear();
+  CHECK_EQ(ring.records(), 0);
+  cursor = 0;
+  CHECK(!ring.next(&cursor, &rec));
+}
+
+void test_dump_lines() {
+  TraceRecord rec;
+  rec.time_us = 3723000042ull;
+  rec.rx = true;
+  rec.op = 1;
+  rec.len = 40;
+  for (int i = 0; i < 40; i++)
+    rec.data[i] = 0xA0 + i;
+  char line[160];
+  KyoTraceRing::format_line(line, sizeof(line), 7, rec, 0);
+  CHECK(strncmp(line, "KYOTRACE 7 3723.000042 RX 1 a0 a1 ", 34) == 0);
+  CHECK_EQ(strlen(line), strlen("KYOTRACE 7 3723.000042 RX 1") + 3 * TRACE_LINE_BYTES);
+  KyoTraceRing::format_line(line, sizeof(line), 7, rec, TRACE_LINE_BYTES);
+  CHECK_EQ(strcmp(line, "KYOTRACE 7 3723.000042 RX 1 c0 c1 c2 c3 c4 c5 c6 c7"), 0);
+
+  rec.len = 0;  // timeout: no bytes at all
+  rec.rx = false;
+  KyoTraceRing::format_line(line, sizeof(line), 1, rec, 0);
+  CHECK_EQ(strcmp(line, "KYOTRACE 1 3723.000042 TX 1"), 0);
+}
+
+void test_records_polls_and_blocking_reads() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.kyo.arm_partition(1, 1);
+  rig.run_for(2000);
+
+  const KyoTraceRing &trace = rig.kyo.get_trace();
+  CHECK(!trace.is_frozen());
+  TraceRecord rec;
+  size_t cursor = 0;
+  uint32_t sensor_tx = 0, sensor_rx = 0, partition_rx = 0, blocking = 0;
+  bool last_was_sensor_tx = false;
+  while (trace.next(&cursor, &rec)) {
+    if (!rec.rx && rec.op == METRIC_OP_SENSOR) {
+      CHECK_EQ(rec.len, 6);
+      CHECK_EQ(memcmp(rec.data, SENSOR_CMD, 6), 0);
+      sensor_tx++;
+    }
+    if (rec.rx && rec.op == METRIC_OP_SENSOR && last_was_sensor_tx) {
+      CHECK_EQ(rec.len, RESP_SENSOR_KYO32);
+      CHECK_EQ(memcmp(rec.data, SENSOR_CMD, 6), 0);  // echo
+      sensor_rx++;
+    }
+    if (rec.rx && rec.op == METRIC_OP_PARTITION && rec.len == RESP_PARTITION_KYO32)
+      partition_rx++;
+    if (rec.op == METRIC_OP_BLOCKING)
+      blocking++;
+    last_was_sensor_tx = !rec.rx && rec.op == METRIC_OP_SENSOR;
+  }
+  CHECK(sensor_tx >= 3);
+  CHECK(sensor_rx >= 3);
+  CHECK(partition_rx >= 3);
+  CHECK(blocking >= 2);  // the arm command and its answer
+}
+
+void test_freezes_on_communication_loss() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(5000);
+
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(5000);
+  const KyoTraceRing &trace = rig.kyo.get_trace();
+  CHECK(trace.is_frozen());
+
+  // The lead-up ends with the unanswered polls
+  TraceRecord rec;
+  size_t cursor = 0;
+  uint32_t empty_rx = 0;
+  while (trace.next(&cursor, &rec)) {
+    if (rec.rx && rec.len == 0)
+      empty_rx++;
+  }
+  CHECK(empty_rx >= (uint32_t) MAX_INVALID_COUNT);
+
+  uint64_t frozen_at = trace.newest_us();
+  rig.run_for(10000);
+  CHECK_EQ(trace.newest_us(), frozen_at);
+
+  // Dumping releases it; recording picks up where the panel is now
+  rig.sim.faults() = KyoSimFaults{};
+  host_log_level = HOST_LOG_NONE;
+  rig.kyo.dump_trace(true);
+  host_log_level = HOST_LOG_WARN;
+  CHECK(!trace.is_frozen());
+  CHECK_EQ(trace.records(), 0);
+  rig.run_for(40000);
+  CHECK(trace.records() > 0);
+  CHECK(trace.newest_us() > frozen_at);
+}
+
+int write_dump(const char *path) {
+  SimRig rig(AlarmModel::KYO_32G);
+  if (!rig.run_until_config_done())
+    return 1;
+  rig.run_for(8000);
+
+  FILE *file = fopen(path, "w");
+  if (file == nullptr) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return 1;
+  }
+  host_set_log_file(file);
+  host_log_level = HOST_LOG_INFO;
+  rig.kyo.dump_trace();
+  host_log_level = HOST_LOG_WARN;
+  host_set_log_file(nullptr);
+  fclose(file);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && strcmp(argv[1], "--dump") == 0)
+    return write_dump(argv[2]);
+  RUN_TEST(test_ring_eviction);
+  RUN_TEST(test_dump_lines);
+  RUN_TEST(test_records_polls_and_blocking_reads);
+  RUN_TEST(test_freezes_on_communication_loss);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,125 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Byte transports and the engine running over a loopback pair.
+
+#include "host_test.h"
+#include "test_kyo.h"
+#include "transport.h"
+
+#include <cstring>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+// Echo the 6-byte command, then append data + checksum
+size_t build_response(const uint8_t *cmd, const uint8_t *data, size_t data_len, uint8_t *out) {
+  memcpy(out, cmd, 6);
+  uint8_t sum = 0;
+  for (size_t i = 0; i < data_len; i++) {
+    out[6 + i] = data[i];
+    sum += data[i];
+  }
+  out[6 + data_len] = sum;
+  return 7 + data_len;
+}
+
+// Run loop() until the async response is dispatched (inter-byte silence)
+void run_loop_until_idle(TestKyo &kyo) {
+  uint32_t start = millis();
+  while (millis() - start < 200) {
+    kyo.loop();
+    delay(1);
+  }
+}
+
+void test_loopback_pair() {
+  LoopbackTransport a, b;
+  a.connect(&b);
+  const uint8_t msg[] = {0xF0, 0x04, 0xF0, 0x0A, 0x00, 0xEE};
+  a.write_array(msg, sizeof(msg));
+  CHECK_EQ(a.available(), 0);
+  CHECK_EQ(b.available(), 6);
+  for (uint8_t expected : msg)
+    CHECK_EQ(b.read(), expected);
+  CHECK_EQ(b.available(), 0);
+  CHECK_EQ(b.read(), 0);
+}
+
+void test_loopback_overflow() {
+  LoopbackTransport a;
+  uint8_t chunk[100] = {};
+  for (int i = 0; i < 6; i++)
+    a.inject(chunk, sizeof(chunk));
+  CHECK_EQ(a.available(), LoopbackTransport::BUFFER_SIZE - 1);
+  CHECK_EQ(a.get_dropped(), 600 - (LoopbackTransport::BUFFER_SIZE - 1));
+  a.clear();
+  CHECK_EQ(a.available(), 0);
+}
+
+void test_engine_detects_model_over_loopback() {
+  LoopbackTransport engine_side, panel_side;
+  engine_side.connect(&panel_side);
+
+  TestKyo kyo;
+  kyo.set_transport(&engine_side);
+  kyo.setup();
+  kyo.update();  // sends the version query
+
+  uint8_t cmd[6];
+  CHECK_EQ(panel_side.available(), 6);
+  for (uint8_t &b : cmd)
+    b = panel_side.read();
+  CHECK_EQ(cmd[0], 0xF0);
+  CHECK_EQ(cmd[1], 0x00);
+
+  const char firmware[] = "KYO32G  4.01";
+  uint8_t frame[32];
+  size_t len = build_response(cmd, (const uint8_t *) firmware, 12, frame);
+  CHECK_EQ(len, RESP_VERSION);
+  panel_side.write_array(frame, len);
+
+  run_loop_until_idle(kyo);
+  CHECK(kyo.model_detected());
+  CHECK(kyo.alarm_model() == AlarmModel::KYO_32G);
+  CHECK(strncmp(kyo.firmware(), "KYO32G", 6) == 0);
+}
+
+#ifdef USE_HOST
+void test_pty_round_trip() {
+  SerialFdTransport pty;
+  CHECK(pty.open_pty());
+  CHECK(pty.slave_name()[0] != '\0');
+
+  SerialFdTransport panel;
+  CHECK(panel.open_device(pty.slave_name()));
+  const uint8_t msg[] = {0xF0, 0x00, 0x00, 0x0B, 0x00, 0xFB};
+  pty.write_array(msg, sizeof(msg));
+
+  uint32_t start = millis();
+  while (panel.available() < (int) sizeof(msg) && millis() - start < 500)
+    delay(1);
+  CHECK_EQ(panel.available(), sizeof(msg));
+  for (uint8_t expected : msg)
+    CHECK_EQ(panel.read(), expected);
+}
+#endif
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_loopback_pair);
+  RUN_TEST(test_loopback_overflow);
+  RUN_TEST(test_engine_detects_model_over_loopback);
+#ifdef USE_HOST
+  RUN_TEST(test_pty_round_trip);
+#endif
+  return HOST_TEST_RESULT();
+}
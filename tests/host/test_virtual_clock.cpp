@@ -0,0 +1,151 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Engine timing in virtual time: long polling runs, the backoff schedule, the
+// EEPROM scan, and run-to-run reproducibility.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+double wall_ms_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void test_hours_of_polling() {
+  auto wall_start = std::chrono::steady_clock::now();
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+
+  const uint32_t hours = 4;
+  uint32_t reads_before = rig.sim.get_stats().reads;
+  rig.run_for(hours * 3600 * 1000);
+  uint32_t reads = rig.sim.get_stats().reads - reads_before;
+
+  // Sensor + partition query every 500ms, plus the periodic text sensor refresh
+  uint32_t cycles = hours * 3600 * 2;
+  CHECK(reads >= cycles * 2);
+  CHECK(reads <= cycles * 2 + cycles / 60);
+  CHECK(rig.kyo.communication_ok());
+  printf("virtual: %u h of polling (%u reads) in %.0f ms wall\n", (unsigned) hours, (unsigned) reads,
+         wall_ms_since(wall_start));
+}
+
+void test_backoff_schedule() {
+  SimRig rig(AlarmModel::KYO_32G);
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2000);
+
+  // Record when the engine puts a request on the wire while the panel is silent
+  std::vector<uint32_t> request_ms;
+  uint32_t last_reads = rig.sim.get_stats().reads;
+  rig.clock.add_listener([&]() {
+    uint32_t reads = rig.sim.get_stats().reads;
+    if (reads != last_reads)
+      request_ms.push_back(rig.clock.millis());
+    last_reads = reads;
+  });
+  rig.sim.faults().drop_rate = 1.0f;
+  rig.run_for(120000);
+
+  // Polls at the update interval until the third silent one, then probes
+  // 250ms, 500ms, 1s, 2s and 4s (capped) apart, +/-25%, each counted from the
+  // previous request's timeout
+  CHECK(request_ms.size() >= (size_t) MAX_INVALID_COUNT + 25);
+  if (request_ms.size() < (size_t) MAX_INVALID_COUNT + 8)
+    return;
+  CHECK(request_ms[1] - request_ms[0] >= 400 && request_ms[1] - request_ms[0] <= 600);
+  const uint32_t max_timeout_ms = KyoRttEstimator::limits(RTT_CLASS_POLL).ceiling_ms + INTER_BYTE_SILENCE_MS;
+  for (size_t i = 0; i < 8; i++) {
+    uint32_t interval = RECOVERY_PROBE_MIN_MS << i;
+    if (interval > RECOVERY_PROBE_MAX_MS)
+      interval = RECOVERY_PROBE_MAX_MS;
+    size_t probe = MAX_INVALID_COUNT - 1 + i + 1;
+    uint32_t gap = request_ms[probe] - request_ms[probe - 1];
+    CHECK(gap >= interval * 3 / 4);
+    CHECK(gap <= interval * 5 / 4 + max_timeout_ms + 1);
+  }
+  CHECK(!rig.kyo.communication_ok());
+
+  // Jitter: the capped probes don't land on a fixed period
+  uint32_t min_gap = UINT32_MAX, max_gap = 0;
+  for (size_t i = MAX_INVALID_COUNT + 8; i + 1 < request_ms.size(); i++) {
+    uint32_t gap = request_ms[i + 1] - request_ms[i];
+    min_gap = gap < min_gap ? gap : min_gap;
+    max_gap = gap > max_gap ? gap : max_gap;
+  }
+  CHECK(max_gap - min_gap > 500);
+
+  // Far sooner back than the former 32s backoff
+  rig.sim.faults().drop_rate = 0.0f;
+  uint32_t restored_ms = rig.now_ms();
+  CHECK(rig.scheduler.run_until([&]() { return rig.kyo.communication_ok(); }, 10000));
+  CHECK(rig.now_ms() - restored_ms <= RECOVERY_PROBE_MAX_MS * 5 / 4 + max_timeout_ms + 200);
+}
+
+void test_eeprom_scan_takes_panel_time() {
+  SimRig rig(AlarmModel::KYO_32);
+  CHECK(rig.run_until_config_done());
+
+  // 32 zone + 16 keyfob ESN reads at ~1s each, one per update cycle, with a
+  // live poll between reads and at most half the time spent blocking
+  CHECK_EQ(rig.sim.get_stats().eeprom_reads, 48);
+  CHECK(rig.now_ms() >= 48 * 1000 * 100 / LOOP_BUDGET_DUTY_PERCENT - LOOP_BUDGET_BURST_MS * 2);
+  CHECK(rig.now_ms() <= 48 * 1500 * 100 / LOOP_BUDGET_DUTY_PERCENT + 20000);
+  printf("virtual: configuration phase took %u ms of panel time\n", (unsigned) rig.now_ms());
+}
+
+// Same seed, same faults, same scenario: identical observable behavior
+std::vector<uint32_t> run_faulty_scenario() {
+  SimRig rig(AlarmModel::KYO_32G, 42);
+  binary_sensor::BinarySensor zone3;
+  rig.kyo.register_binary_sensor(&zone3, BinarySensorType::ZONE, 2);
+  std::vector<uint32_t> trace;
+  zone3.add_on_state_callback([&](bool state) { trace.push_back(rig.now_ms() * 2 + (state ? 1 : 0)); });
+
+  rig.sim.faults().drop_rate = 0.1f;
+  rig.sim.faults().corrupt_rate = 0.05f;
+  rig.sim.faults().truncate_rate = 0.05f;
+  rig.sim.faults().jitter_ms = 30;
+  rig.run_until_config_done();
+  for (int i = 0; i < 40; i++) {
+    rig.sim.set_zone(3, i % 2 == 0);
+    rig.run_for(1700);
+  }
+  const KyoSimStats &stats = rig.sim.get_stats();
+  trace.push_back(stats.reads);
+  trace.push_back(stats.dropped);
+  trace.push_back(stats.corrupted);
+  trace.push_back(stats.truncated);
+  trace.push_back(stats.bytes_sent);
+  return trace;
+}
+
+void test_reproducible_runs() {
+  std::vector<uint32_t> first = run_faulty_scenario();
+  std::vector<uint32_t> second = run_faulty_scenario();
+  CHECK(first.size() > 20);
+  CHECK(first == second);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_hours_of_polling);
+  RUN_TEST(test_backoff_schedule);
+  RUN_TEST(test_eeprom_scan_takes_panel_time);
+  RUN_TEST(test_reproducible_runs);
+  return HOST_TEST_RESULT();
+}
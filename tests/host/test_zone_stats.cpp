@@ -0,0 +1,175 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Per-zone activity counters: the mask diff on its own, then against the
+// simulated panel with the sensors and the saved counters across a reboot.
+
+#include "host_test.h"
+#include "sim_rig.h"
+
+using namespace esphome;
+using namespace esphome::bentel_kyo;
+
+namespace {
+
+void test_mask_diff() {
+  KyoZoneStats stats;
+  uint32_t since_ms = 0;
+
+  // The first frame is the baseline: zone 1 open at boot is not an activation
+  stats.update(0x01, 0x00, 1000);
+  CHECK_EQ(stats.get_activations(0), 0u);
+  CHECK(!stats.get_since_change_ms(0, 1000, &since_ms));
+  CHECK(!stats.take_dirty());
+
+  // Zone 2 opens for 1.5s twice: 3s, the half seconds carried over
+  stats.update(0x03, 0x00, 2000);
+  stats.update(0x01, 0x00, 3500);
+  stats.update(0x03, 0x00, 4000);
+  CHECK_EQ(stats.get_open_s(1, 5000), 2u);
+  stats.update(0x01, 0x00, 5500);
+  CHECK_EQ(stats.get_activations(1), 2u);
+  CHECK_EQ(stats.get_open_s(1, 9000), 3u);
+  CHECK(stats.get_since_change_ms(1, 6500, &since_ms));
+  CHECK_EQ(since_ms, 1000u);
+  CHECK(stats.take_dirty());
+
+  // Zone 1, open since boot, counts its time so far
+  CHECK_EQ(stats.get_open_s(0, 10000), 9u);
+
+  // Tamper counts rising edges only
+  stats.update(0x01, 0x04, 6000);
+  stats.update(0x01, 0x04, 6500);
+  stats.update(0x01, 0x00, 7000);
+  stats.update(0x01, 0x04, 7500);
+  CHECK_EQ(stats.get_tamper_events(2), 2u);
+  CHECK_EQ(stats.get_activations(2), 0u);
+
+  // flush() moves running stretches into the saved counters
+  stats.take_dirty();
+  stats.flush(11000);
+  CHECK(stats.take_dirty());
+  CHECK_EQ(stats.get_counters().open_s[0], 10u);
+  CHECK_EQ(stats.get_open_s(0, 12000), 11u);
+
+  stats.reset(12000);
+  CHECK_EQ(stats.get_activations(1), 0u);
+  CHECK_EQ(stats.get_open_s(0, 14000), 2u);
+}
+
+struct StatSensors {
+  explicit StatSensors(TestKyo &kyo, uint8_t zone) {
+    kyo.register_zone_stat_sensor(&this->activations, ZONE_STAT_ACTIVATIONS, zone);
+    kyo.register_zone_stat_sensor(&this->open_time, ZONE_STAT_OPEN_TIME, zone);
+    kyo.register_zone_stat_sensor(&this->last_change, ZONE_STAT_LAST_CHANGE, zone);
+    kyo.register_zone_stat_sensor(&this->tamper_events, ZONE_STAT_TAMPER_EVENTS, zone);
+  }
+  sensor::Sensor activations, open_time, last_change, tamper_events;
+};
+
+void test_live_panel() {
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  StatSensors zone3(rig.kyo, 2);
+  rig.kyo.setup();
+  CHECK(rig.run_until_config_done());
+  rig.run_for(2000);
+
+  // Zone 3 opens three times for 2s, and its tamper trips once
+  for (int i = 0; i < 3; i++) {
+    rig.sim.set_zone(3, true);
+    rig.run_for(2000);
+    rig.sim.set_zone(3, false);
+    rig.run_for(2000);
+  }
+  rig.sim.set_zone_tamper(3, true);
+  rig.run_for(2000);
+  rig.sim.set_zone_tamper(3, false);
+  CHECK_EQ(rig.kyo.get_zone_stats().get_activations(2), 3u);
+  CHECK_EQ(rig.kyo.get_zone_stats().get_tamper_events(2), 1u);
+
+  // Published with the metrics, once a minute
+  rig.run_for(METRICS_PUBLISH_INTERVAL_MS);
+  CHECK_EQ(zone3.activations.state, 3.0f);
+  CHECK(zone3.open_time.state >= 5.0f && zone3.open_time.state <= 7.0f);
+  CHECK(zone3.last_change.state >= 2.0f);
+  CHECK_EQ(zone3.tamper_events.state, 1.0f);
+}
+
+void test_saved_across_reboot() {
+  KyoZoneCounters saved{};
+  {
+    SimRig rig(AlarmModel::KYO_32G);
+    CHECK(rig.run_until_config_done());
+    rig.sim.set_zone(5, true);
+    rig.run_for(2000);
+    rig.sim.set_zone(5, false);
+    rig.run_for(2000);
+    rig.sim.set_zone(5, true);  // still open when the counters are saved
+
+    // Nothing written before the save interval is up, then once
+    auto pref = global_preferences->make_preference<KyoZoneCounters>(fnv1_hash(ZONE_STATS_KEY), true);
+    CHECK(!pref.load(&saved));
+    rig.run_for(ZONE_STATS_SAVE_INTERVAL_MS + METRICS_PUBLISH_INTERVAL_MS);
+    CHECK(pref.load(&saved));
+  }
+  CHECK_EQ(saved.version, ZONE_STATS_VERSION);
+  CHECK_EQ(saved.activations[4], 2u);
+  // Minutes, not the 2s of the closed stretch: the open one was folded in
+  CHECK(saved.open_s[4] >= 600);
+
+  // The next boot starts from the saved counters
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  global_preferences->make_preference<KyoZoneCounters>(fnv1_hash(ZONE_STATS_KEY), true).save(&saved);
+  rig.kyo.setup();
+  CHECK_EQ(rig.kyo.get_zone_stats().get_activations(4), 2u);
+  CHECK(rig.run_until_config_done());
+  rig.sim.set_zone(5, true);
+  rig.run_for(2000);
+  CHECK_EQ(rig.kyo.get_zone_stats().get_activations(4), 3u);
+}
+
+void test_restored_frame_is_not_a_baseline() {
+  KyoSavedState saved{};
+  {
+    SimRig rig(AlarmModel::KYO_32G);
+    rig.sim.set_zone(3, true);
+    rig.run_for(3000);
+    saved = rig.kyo.saved_state();
+  }
+
+  // Zone 3 closed and zone 5 opened while the hub was down
+  SimRig rig(AlarmModel::KYO_32G, 1, false);
+  global_preferences->make_preference<KyoSavedState>(fnv1_hash(SAVED_STATE_KEY), true).save(&saved);
+  rig.sim.set_zone(5, true);
+  rig.kyo.setup();
+  CHECK(rig.kyo.model_restored());
+  rig.run_for(60000);
+  CHECK(rig.run_until_config_done());
+
+  // The first live frame is the baseline: neither change is counted
+  const KyoZoneStats &stats = rig.kyo.get_zone_stats();
+  CHECK_EQ(stats.get_activations(4), 0u);
+  CHECK_EQ(stats.get_activations(2), 0u);
+  CHECK_EQ(stats.get_open_s(2, rig.now_ms()), 0u);
+
+  rig.sim.set_zone(5, false);
+  rig.run_for(2000);
+  rig.sim.set_zone(5, true);
+  rig.run_for(2000);
+  CHECK_EQ(stats.get_activations(4), 1u);
+}
+
+}  // namespace
+
+int main() {
+  RUN_TEST(test_mask_diff);
+  RUN_TEST(test_live_panel);
+  RUN_TEST(test_saved_across_reboot);
+  RUN_TEST(test_restored_frame_is_not_a_baseline);
+  return HOST_TEST_RESULT();
+}
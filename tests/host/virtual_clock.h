@@ -0,0 +1,66 @@
+/*
+ * espkyogate - ESPHome component for Bentel KYO alarms
+ * Copyright (C) 2025 Lorenzo De Luca (me@lorenzodeluca.dev)
+ * Copyright (C) 2026 Rui Marinho (ruipmarinho@gmail.com)
+ *
+ * GNU Affero General Public License v3.0
+ */
+
+// Deterministic time for host runs. Time only moves when the engine yields
+// (one step per call) or the scheduler skips ahead over idle periods. Every
+// time advance pumps the registered peripherals (e.g. the simulated panel), so
+// they keep serving bytes while the engine busy-waits.
+
+#pragma once
+
+#include "clock.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace bentel_kyo {
+
+class VirtualClock : public KyoClock {
+ public:
+  explicit VirtualClock(uint32_t step_us = 500) : step_us_(step_us) {}
+
+  uint32_t millis() override { return (uint32_t) (this->now_us_ / 1000); }
+  uint32_t micros() override { return (uint32_t) this->now_us_; }
+  void yield() override { this->advance_us(this->step_us_); }
+
+  void advance_us(uint64_t us) {
+    this->now_us_ += us;
+    this->yields_++;
+    for (size_t i = 0; i < this->listeners_.size(); i++) {
+      if (this->listeners_[i])
+        this->listeners_[i]();
+    }
+  }
+  void advance_to_ms(uint64_t ms) {
+    if (ms * 1000 > this->now_us_)
+      this->advance_us(ms * 1000 - this->now_us_);
+  }
+  // Returns a handle for remove_listener()
+  size_t add_listener(std::function<void()> &&listener) {
+    this->listeners_.push_back(std::move(listener));
+    return this->listeners_.size() - 1;
+  }
+  void remove_listener(size_t handle) { this->listeners_[handle] = nullptr; }
+
+  uint64_t now_us() const { return this->now_us_; }
+  uint64_t get_yields() const { return this->yields_; }
+  void set_step_us(uint32_t step_us) { this->step_us_ = step_us; }
+
+ protected:
+  uint64_t now_us_{0};
+  uint64_t yields_{0};
+  uint32_t step_us_;
+  std::vector<std::function<void()>> listeners_;
+};
+
+}  // namespace bentel_kyo
+}  // namespace esphome
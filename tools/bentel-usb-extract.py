@@ -6,6 +6,9 @@ Parses USB capture logs exported from HHD Device Monitoring Studio (UTF-16LE
 text exports), reassembles fragmented USB bulk transfers into complete KYO
 protocol messages, validates checksums, and decodes known commands.
 
+Also reads the raw frame trace dumped by the ESPHome component
+(bentel_kyo.dump_trace) from a saved device log.
+
 Supports all KYO panel variants: KYO4, KYO8, KYO8G, KYO32, KYO32G.
 
 Output modes:
@@ -20,6 +23,7 @@ import json
 import re
 import sys
 from collections import Counter, OrderedDict
+from datetime import datetime, timedelta
 
 # ---------------------------------------------------------------------------
 # Known KYO protocol commands
@@ -104,6 +108,15 @@ COMMAND_FIELDS = {
 
 _TS_RE = re.compile(r"\d{2}\.\d{2}\.\d{4}\s+\d{2}:\d{2}:\d{2}(?:\.\d+)?")
 
+# ---------------------------------------------------------------------------
+# Component frame trace — KYOTRACE <frame> <s>.<us> TX|RX <op> <hex bytes>
+# ---------------------------------------------------------------------------
+
+_TRACE_RE = re.compile(
+    r"KYOTRACE (\d+) (\d+)\.(\d{6}) (TX|RX) (\d+)((?: [0-9a-fA-F]{2})*)"
+)
+_TRACE_EPOCH = datetime(1970, 1, 1)
+
 
 # ---------------------------------------------------------------------------
 # Parsing
@@ -124,6 +137,8 @@ def parse_log(filepath):
         and *hex* (list of lowercase two-character hex strings).
     """
     lines = _read_lines(filepath)
+    if any("KYOTRACE " in line for line in lines):
+        return parse_trace(lines)
     entries = []
     seq = ""
     direction = ""
@@ -208,17 +223,62 @@ def parse_log(filepath):
     return entries
 
 
-def _read_lines(filepath):
-    """Read a text file trying UTF-16LE first, then UTF-8."""
-    for encoding in ("utf-16-le", "utf-8-sig", "utf-8"):
-        try:
-            with open(filepath, "r", encoding=encoding) as fh:
-                return fh.readlines()
-        except (UnicodeDecodeError, UnicodeError):
+def parse_trace(lines):
+    """Parse a frame trace dumped by the ESPHome component to its log.
+
+    TX frames become Down entries. RX frames become Up entries with the
+    ``01 00`` header the USB interface would have added, so both sources go
+    through the same reassembly. Frames longer than one log line repeat their
+    frame number and are joined back together. Timestamps are device uptime,
+    rendered as a date on 01.01.1970.
+
+    Returns:
+        list[dict]: Same entry format as :func:`parse_log`.
+    """
+    entries = []
+    last_frame = None
+    for line in lines:
+        if "KYOTRACE-BEGIN" in line:
+            last_frame = None  # frame numbers restart with every dump
             continue
-    raise ValueError(
-        f"Cannot decode {filepath} — expected UTF-16LE or UTF-8 text export"
-    )
+        match = _TRACE_RE.search(line)
+        if not match:
+            continue
+        frame = int(match.group(1))
+        direction = "Down" if match.group(4) == "TX" else "Up"
+        hex_bytes = [b.lower() for b in match.group(6).split()]
+        if frame == last_frame and entries:
+            entries[-1]["hex"].extend(hex_bytes)
+            continue
+        last_frame = frame
+
+        uptime = timedelta(seconds=int(match.group(2)), microseconds=int(match.group(3)))
+        entries.append({
+            "seq": len(entries) + 1,
+            "dir": direction,
+            "ts": (_TRACE_EPOCH + uptime).strftime("%d.%m.%Y %H:%M:%S.%f"),
+            "hex": (["01", "00"] + hex_bytes) if direction == "Up" else hex_bytes,
+        })
+    return entries
+
+
+def _read_lines(filepath):
+    """Read a text file as UTF-16LE (HHD exports) or UTF-8 (device logs)."""
+    with open(filepath, "rb") as fh:
+        raw = fh.read()
+    # ASCII text also decodes as UTF-16LE, so only use it when it looks like it
+    if raw.startswith(b"\xff\xfe"):
+        encoding = "utf-16"
+    elif b"\x00" in raw[:4096]:
+        encoding = "utf-16-le"
+    else:
+        encoding = "utf-8-sig"
+    try:
+        return raw.decode(encoding).splitlines(keepends=True)
+    except UnicodeError:
+        raise ValueError(
+            f"Cannot decode {filepath} — expected UTF-16LE or UTF-8 text export"
+        ) from None
 
 
 # ---------------------------------------------------------------------------
@@ -823,14 +883,15 @@ def build_parser():
         ),
         epilog=(
             "The input file must be a UTF-16LE text export produced by "
-            "HHD Device Monitoring Studio's Text Exporter. Works with all "
+            "HHD Device Monitoring Studio's Text Exporter, or a device log "
+            "holding a bentel_kyo.dump_trace frame trace. Works with all "
             "KYO panel variants (KYO4, KYO8, KYO8G, KYO32, KYO32G)."
         ),
         formatter_class=argparse.RawDescriptionHelpFormatter,
     )
     parser.add_argument(
         "logfile",
-        help="path to the HHD Device Monitoring Studio text export (.log)",
+        help="path to the HHD text export (.log) or a device log with a frame trace",
     )
     mode = parser.add_mutually_exclusive_group()
     mode.add_argument(